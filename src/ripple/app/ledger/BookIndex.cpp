@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/BookIndex.h>
+#include <algorithm>
+#include <cstring>
+
+namespace ripple {
+
+// The quality is held in the last 64 bits of a directory key
+static std::size_t const qualityBytes = 8;
+
+BookIndex::BookIndex (BookIndex const& parent)
+{
+    std::lock_guard<std::mutex> lock (parent.mutex_);
+    books_ = parent.books_;
+}
+
+uint256
+BookIndex::bookBase (uint256 const& key)
+{
+    uint256 base = key;
+    std::memset (base.end() - qualityBytes, 0, qualityBytes);
+    return base;
+}
+
+auto
+BookIndex::find (uint256 const& base) const ->
+    std::shared_ptr<Dirs const>
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const iter = books_.find (base);
+    if (iter == books_.end())
+        return nullptr;
+    return iter->second;
+}
+
+bool
+BookIndex::succ (SHAMap const& map, uint256 const& key, uint256 const& last,
+    boost::optional<uint256>& result) const
+{
+    // last must be the base of the book after the one holding key
+    if (last.isZero() || bookBase (last) != last)
+        return false;
+    auto base = last;
+    base = bookBase (--base);
+    if (bookBase (key) != base)
+        return false;
+
+    auto dirs = find (base);
+    if (! dirs)
+    {
+        // Collect the keys of the book outside the lock
+        auto d = std::make_shared<Dirs> ();
+        if (map.hasItem (base))
+            d->push_back (base);
+        for (auto iter = map.upper_bound (base);
+            iter != map.end() && iter->key() < last; ++iter)
+        {
+            d->push_back (iter->key());
+        }
+
+        std::lock_guard<std::mutex> lock (mutex_);
+        dirs = books_.emplace (base, std::move (d)).first->second;
+    }
+
+    auto const iter = std::upper_bound (dirs->begin(), dirs->end(), key);
+    if (iter == dirs->end())
+        result = boost::none;
+    else
+        result = *iter;
+    return true;
+}
+
+void
+BookIndex::insert (uint256 const& key)
+{
+    auto const base = bookBase (key);
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const iter = books_.find (base);
+    if (iter == books_.end())
+        return;
+
+    auto dirs = std::make_shared<Dirs> (*iter->second);
+    dirs->insert (std::lower_bound (
+        dirs->begin(), dirs->end(), key), key);
+    iter->second = std::move (dirs);
+}
+
+void
+BookIndex::erase (uint256 const& key)
+{
+    auto const base = bookBase (key);
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const iter = books_.find (base);
+    if (iter == books_.end())
+        return;
+
+    auto dirs = std::make_shared<Dirs> (*iter->second);
+    auto const pos = std::lower_bound (dirs->begin(), dirs->end(), key);
+    if (pos != dirs->end() && *pos == key)
+        dirs->erase (pos);
+    iter->second = std::move (dirs);
+}
+
+std::size_t
+BookIndex::size () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return books_.size();
+}
+
+} // ripple
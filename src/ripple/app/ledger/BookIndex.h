@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_BOOKINDEX_H_INCLUDED
+#define RIPPLE_APP_LEDGER_BOOKINDEX_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/shamap/SHAMap.h>
+#include <boost/optional.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** The sorted keys of the order book directories in a ledger, by book.
+
+    The quality directories of a book have keys from the book base up to,
+    but not including, the next book base, ordered by quality. Walking a
+    book, as the payment engine and book_offers do, asks the ledger for
+    the successor of a key within that range once per quality. A book
+    is added here the first time it is walked, and those queries are then
+    answered by a binary search rather than a search of the state map.
+
+    A ledger built on top of another starts with the books of its parent,
+    sharing their keys, and keeps them current as entries are inserted
+    and erased. Only the books which change are copied.
+
+    The books are added and looked up under a lock, so an immutable
+    ledger may be used from several threads.
+*/
+class BookIndex
+{
+public:
+    BookIndex () = default;
+
+    /** Start from the books of a parent ledger. */
+    BookIndex (BookIndex const& parent);
+
+    BookIndex& operator= (BookIndex const&) = delete;
+
+    /** Find the first key after key and before last.
+
+        Only queries confined to a single book are answered.
+
+        @param map The state map of the ledger, to add the book from.
+        @param result Set to the key found, if any.
+        @return `false` if the query spans more than one book.
+    */
+    bool
+    succ (SHAMap const& map, uint256 const& key, uint256 const& last,
+        boost::optional<uint256>& result) const;
+
+    /** Record that an entry was added to the ledger. */
+    void
+    insert (uint256 const& key);
+
+    /** Record that an entry was removed from the ledger. */
+    void
+    erase (uint256 const& key);
+
+    /** Return the number of books indexed. */
+    std::size_t
+    size () const;
+
+private:
+    using Dirs = std::vector<uint256>;
+
+    static
+    uint256
+    bookBase (uint256 const& key);
+
+    std::shared_ptr<Dirs const>
+    find (uint256 const& base) const;
+
+    std::mutex mutable mutex_;
+    hash_map<uint256, std::shared_ptr<Dirs const>> mutable books_;
+};
+
+} // ripple
+
+#endif
@@ -88,6 +88,12 @@ public:
 
     void runData ();
 
+    static
+    LedgerInfo
+    deserializeHeader (
+        Slice data,
+        bool hasPrefix);
+
 private:
     enum class TriggerReason
     {
@@ -121,11 +127,21 @@ private:
 
     std::weak_ptr <PeerSet> pmDowncast () override;
 
-    int processData (std::shared_ptr<Peer> peer, protocol::TMLedgerData& data);
+    // The nodes of a TMLedgerData, parsed and hashed, in the order
+    // received. Root nodes are not parsed, and are null.
+    using CheckedNodes = std::vector<std::shared_ptr<SHAMapAbstractNode>>;
+
+    static
+    CheckedNodes
+    checkNodes (protocol::TMLedgerData const& packet, beast::Journal j);
+
+    int processData (std::shared_ptr<Peer> peer, protocol::TMLedgerData& data,
+                     CheckedNodes const& checked);
 
     bool takeHeader (std::string const& data);
     bool takeTxNode (const std::vector<SHAMapNodeID>& IDs,
                      const std::vector<Blob>& data,
+                     CheckedNodes const& checked,
                      SHAMapAddNode&);
     bool takeTxRootNode (Slice const& data, SHAMapAddNode&);
 
@@ -135,6 +151,7 @@ private:
     //
     bool takeAsNode (const std::vector<SHAMapNodeID>& IDs,
                      const std::vector<Blob>& data,
+                     CheckedNodes const& checked,
                      SHAMapAddNode&);
     bool takeAsRootNode (Slice const& data, SHAMapAddNode&);
 
@@ -146,11 +163,6 @@ private:
     neededStateHashes (
         int max, SHAMapSyncFilter* filter) const;
 
-    LedgerInfo
-    deserializeHeader (
-        Slice data,
-        bool hasPrefix);
-
 private:
     std::shared_ptr<Ledger> mLedger;
     bool               mHaveHeader;
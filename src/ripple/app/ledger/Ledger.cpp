@@ -31,6 +31,7 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/impl/AccountTxPaging.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/StringUtilities.h>
@@ -275,6 +276,7 @@ Ledger::Ledger (Ledger const& prevLedger,
         prevLedger.stateMap_->family(),
         prevLedger.stateMap_->get_version()))
     , stateMap_ (prevLedger.stateMap_->snapShot (true))
+    , books_ (prevLedger.books_)
     , fees_(prevLedger.fees_)
     , rules_(prevLedger.rules_)
 {
@@ -371,7 +373,10 @@ Ledger::setAccepted(NetClock::time_point closeTime,
 bool Ledger::addSLE (SLE const& sle)
 {
     SHAMapItem item (sle.key(), sle.getSerializer());
-    return stateMap_->addItem(std::move(item), false, false);
+    if (! stateMap_->addItem(std::move(item), false, false))
+        return false;
+    books_.insert (sle.key());
+    return true;
 }
 
 //------------------------------------------------------------------------------
@@ -420,6 +425,10 @@ boost::optional<uint256>
 Ledger::succ (uint256 const& key,
     boost::optional<uint256> const& last) const
 {
+    boost::optional<uint256> result;
+    if (last && books_.succ (*stateMap_, key, *last, result))
+        return result;
+
     auto item = stateMap_->upper_bound(key);
     if (item == stateMap_->end())
         return boost::none;
@@ -539,12 +548,13 @@ Ledger::rawErase(std::shared_ptr<SLE> const& sle)
 {
     if (! stateMap_->delItem(sle->key()))
         LogicError("Ledger::rawErase: key not found");
+    books_.erase (sle->key());
 }
 
 void
 Ledger::rawInsert(std::shared_ptr<SLE> const& sle)
 {
-    Serializer ss;
+    Serializer ss (sle->serializedSize());
     sle->add(ss);
     auto item = std::make_shared<
         SHAMapItem const>(sle->key(),
@@ -553,12 +563,13 @@ Ledger::rawInsert(std::shared_ptr<SLE> const& sle)
     if (! stateMap_->addGiveItem(
             std::move(item), false, false))
         LogicError("Ledger::rawInsert: key already exists");
+    books_.insert (sle->key());
 }
 
 void
 Ledger::rawReplace(std::shared_ptr<SLE> const& sle)
 {
-    Serializer ss;
+    Serializer ss (sle->serializedSize());
     sle->add(ss);
     auto item = std::make_shared<
         SHAMapItem const>(sle->key(),
@@ -952,6 +963,9 @@ static bool saveValidatedLedger (
                     seq, vt.second->getEscMeta ()) + ";");
         }
 
+        if (app.config().ACCOUNT_TX_INDEX)
+            saveAccountTxIndex (*db, seq, *aLedger);
+
         tr.commit ();
     }
 
@@ -1111,7 +1125,7 @@ loadLedgerHelper(std::string const& sqlSuffix, Application& app)
     uint256 ledgerHash{};
     std::uint32_t ledgerSeq{0};
 
-    auto db = app.getLedgerDB ().checkoutDb ();
+    auto db = app.getLedgerDB ().checkoutRead ();
 
     boost::optional<std::string> sLedgerHash, sPrevHash, sAccountHash,
         sTransHash;
@@ -1254,7 +1268,7 @@ getHashByIndex (std::uint32_t ledgerIndex, Application& app)
 
     std::string hash;
     {
-        auto db = app.getLedgerDB ().checkoutDb ();
+        auto db = app.getLedgerDB ().checkoutRead ();
 
         boost::optional<std::string> lh;
         *db << sql,
@@ -1277,7 +1291,7 @@ getHashesByIndex(std::uint32_t ledgerIndex,
     uint256& ledgerHash, uint256& parentHash,
         Application& app)
 {
-    auto db = app.getLedgerDB ().checkoutDb ();
+    auto db = app.getLedgerDB ().checkoutRead ();
 
     boost::optional <std::string> lhO, phO;
 
@@ -1314,7 +1328,7 @@ getHashesByIndex (std::uint32_t minSeq, std::uint32_t maxSeq,
     sql.append (beast::lexicalCastThrow <std::string> (maxSeq));
     sql.append (";");
 
-    auto db = app.getLedgerDB ().checkoutDb ();
+    auto db = app.getLedgerDB ().checkoutRead ();
 
     std::uint64_t ls;
     std::string lh;
@@ -20,6 +20,7 @@
 #ifndef RIPPLE_APP_LEDGER_LEDGER_H_INCLUDED
 #define RIPPLE_APP_LEDGER_LEDGER_H_INCLUDED
 
+#include <ripple/app/ledger/BookIndex.h>
 #include <ripple/ledger/TxMeta.h>
 #include <ripple/ledger/View.h>
 #include <ripple/ledger/CachedView.h>
@@ -323,6 +324,9 @@ private:
     std::shared_ptr<SHAMap> txMap_;
     std::shared_ptr<SHAMap> stateMap_;
 
+    // Order book directories, for walking books without the state map
+    BookIndex books_;
+
     // Protects fee variables
     std::mutex mutable mutex_;
 
@@ -26,16 +26,19 @@
 #include <ripple/app/ledger/LedgerCleaner.h>
 #include <ripple/app/ledger/LedgerHistory.h>
 #include <ripple/app/ledger/LedgerHolder.h>
+#include <ripple/app/ledger/RecentLedgers.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/basics/RangeSet.h>
 #include <ripple/basics/ScopedLock.h>
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/protocol/RippleLedgerHash.h>
 #include <ripple/protocol/STValidation.h>
 #include <ripple/beast/insight/Collector.h>
 #include <ripple/core/Stoppable.h>
 #include <ripple/beast/utility/PropertyStream.h>
+#include <list>
 #include <mutex>
 
 #include "ripple.pb.h"
@@ -98,6 +101,8 @@ public:
     std::shared_ptr<Ledger const>
     getValidatedLedger ()
     {
+        if (auto ledger = mRecentLedgers.validated())
+            return ledger;
         return mValidLedger.get();
     }
 
@@ -222,9 +227,16 @@ public:
     std::unique_ptr<LedgerReplay> releaseReplay ();
 
     // Fetch Packs
+    /** Note fetch pack objects received from a peer.
+
+        @param seq The ledger of the last object received.
+        @param last The hash of the last object received, from which a
+                    request for the rest of that ledger resumes.
+    */
     void gotFetchPack (
         bool progress,
-        std::uint32_t seq);
+        std::uint32_t seq,
+        uint256 const& last);
 
     void addFetchPack (
         uint256 const& hash,
@@ -241,7 +253,30 @@ public:
 
     std::size_t getFetchPackCacheSize () const;
 
+    /** The fraction of fetch pack ledgers served from the delta cache */
+    float getFetchPackDeltaHitRate ();
+
 private:
+    // The nodes, keyed by hash, of a ledger missing from its child, in
+    // the order they are sent. The ledger's header comes last, so a peer
+    // which was sent part of a ledger asks again, from the last node it
+    // has, until it gets the header.
+    struct FetchPackDelta
+    {
+        std::vector<std::pair<uint256, Blob>> nodes;
+        std::size_t bytes = 0;
+    };
+
+    struct FetchPackDeltaEntry
+    {
+        uint256 key;
+        std::shared_ptr<FetchPackDelta const> delta;
+        Stopwatch::time_point used;
+    };
+
+    // Most recently used first
+    using FetchPackDeltas = std::list<FetchPackDeltaEntry>;
+
     void setValidLedger(
         std::shared_ptr<Ledger const> const& l);
     void setPubLedger(
@@ -252,6 +287,9 @@ private:
         std::shared_ptr<Ledger const> ledger);
 
     void getFetchPack(LedgerHash missingHash, LedgerIndex missingIndex);
+    std::shared_ptr<FetchPackDelta const>
+    getFetchPackDelta (Ledger const& have, Ledger const& want);
+    void sweepFetchPackDeltas ();
     boost::optional<LedgerHash> getLedgerHashForHistory(LedgerIndex index);
     std::size_t getNeededValidations();
     void advanceThread();
@@ -299,6 +337,9 @@ private:
 
     LedgerHistory mLedgerHistory;
 
+    // Recent validated ledgers, for lookups which take no lock
+    RecentLedgers mRecentLedgers;
+
     CanonicalTXSet mHeldTransactions;
 
     // A set of transactions to replay during the next close
@@ -341,8 +382,27 @@ private:
 
     TaggedCache<uint256, Blob> fetch_packs_;
 
+    // The nodes a ledger adds to its child, keyed by the child's hash, so
+    // peers behind by the same ledgers are served from one walk. Bounded
+    // by the bytes held, since one delta can hold thousands of nodes.
+    Stopwatch& stopwatch_;
+    std::mutex fetch_deltas_mutex_;
+    FetchPackDeltas fetch_deltas_;
+    hash_map<uint256, FetchPackDeltas::iterator> fetch_delta_index_;
+    std::size_t fetch_delta_bytes_ = 0;
+    std::uint64_t fetch_delta_hits_ = 0;
+    std::uint64_t fetch_delta_misses_ = 0;
+
     std::uint32_t fetch_seq_;
 
+    // The last fetch pack object received, and its ledger
+    std::mutex fetch_resume_mutex_;
+    std::uint32_t fetch_resume_seq_ = 0;
+    uint256 fetch_resume_hash_;
+
+    // Set while a job handling received fetch packs is queued
+    std::atomic<bool> fetch_pending_ {false};
+
 };
 
 } // ripple
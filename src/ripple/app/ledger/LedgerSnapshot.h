@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERSNAPSHOT_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERSNAPSHOT_H_INCLUDED
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/beast/utility/Journal.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ripple {
+
+/** A file holding a ledger and every node of its state and transaction
+    maps, from which a server can start without walking or fetching the
+    state tree.
+
+    The file is written and read in one sequential pass. It holds:
+
+        the magic "RLSNAP" and a two byte version,
+        the length and the prefixed serialization of the ledger header,
+        for each node: its type, hash, length and prefixed serialization,
+        a zero byte,
+        the number of nodes, and
+        the SHA-512Half of all the preceding bytes.
+
+    The nodes of each map are written parent first, so a reader can check
+    that the maps are complete while keeping only the hashes of the
+    children not yet seen.
+*/
+
+/** Write a snapshot of a ledger.
+
+    The file is written under another name, and renamed once complete.
+    One snapshot is written at a time, other callers wait.
+
+    @return The number of nodes written.
+    @throws std::exception if the file can not be written or the ledger
+            is missing nodes.
+*/
+std::uint64_t
+writeLedgerSnapshot (Ledger const& ledger, std::string const& path);
+
+/** Store the nodes of a snapshot in the node store, and return its ledger.
+
+    The nodes are checked against their hashes on persistent worker
+    threads and written to the node store in batches.
+
+    @return The ledger, or null if the file is damaged or incomplete.
+*/
+std::shared_ptr<Ledger>
+loadLedgerSnapshot (std::string const& path, Application& app,
+    beast::Journal j);
+
+} // ripple
+
+#endif
@@ -21,6 +21,7 @@
 #define RIPPLE_APP_LEDGER_OPENLEDGER_H_INCLUDED
 
 #include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/main/Application.h>
 #include <ripple/ledger/CachedSLEs.h>
 #include <ripple/ledger/OpenView.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
@@ -30,6 +31,7 @@
 #include <ripple/beast/utility/Journal.h>
 #include <cassert>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -198,6 +200,25 @@ private:
         std::shared_ptr< STTx const> const& tx,
             bool retry, ApplyFlags flags,
                 beast::Journal j);
+
+    /** Apply transactions in order, speculatively in parallel.
+
+        Each transaction is first applied on its own to a private
+        view over `view`, recording the state entries it reads.
+        The private views are then committed to `view` in order. A
+        transaction which read an entry written by an earlier one
+        is applied again in place of its private view, so the
+        result is the same as calling apply_one for each.
+
+        @return The result for each transaction, failure if
+                applying it threw.
+    */
+    static
+    std::vector<Result>
+    apply_batch (Application& app, OpenView& view,
+        std::vector<std::shared_ptr<STTx const>> const& txs,
+            bool retry, ApplyFlags flags, std::size_t threads,
+                beast::Journal j);
 };
 
 //------------------------------------------------------------------------------
@@ -209,6 +230,8 @@ OpenLedger::apply (Application& app, OpenView& view,
         OrderedTxs& retries, ApplyFlags flags,
             beast::Journal j)
 {
+    auto const threads = app.config().PARALLEL_APPLY;
+    std::vector<std::shared_ptr<STTx const>> batch;
     for (auto iter = txs.begin();
         iter != txs.end(); ++iter)
     {
@@ -219,6 +242,11 @@ OpenLedger::apply (Application& app, OpenView& view,
             auto const tx = *iter;
             if (check.txExists(tx->getTransactionID()))
                 continue;
+            if (threads > 1)
+            {
+                batch.push_back(tx);
+                continue;
+            }
             auto const result = apply_one(app, view,
                 tx, true, flags, j);
             if (result == Result::retry)
@@ -230,6 +258,14 @@ OpenLedger::apply (Application& app, OpenView& view,
                 "Caught exception";
         }
     }
+    if (! batch.empty())
+    {
+        auto const results = apply_batch(app, view,
+            batch, true, flags, threads, j);
+        for (std::size_t i = 0; i < batch.size(); ++i)
+            if (results[i] == Result::retry)
+                retries.insert(batch[i]);
+    }
     bool retry = true;
     for (int pass = 0;
         pass < LEDGER_TOTAL_PASSES;
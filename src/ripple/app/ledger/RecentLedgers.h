@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_LEDGER_RECENTLEDGERS_H_INCLUDED
+#define RIPPLE_APP_LEDGER_RECENTLEDGERS_H_INCLUDED
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/RippleLedgerHash.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+
+/** The most recent ledgers of the validated chain, readable without locks.
+
+    Writers copy the published snapshot, change the copy, and publish it.
+    Each reading thread keeps the last snapshot it loaded, and loads the
+    published one again only after a newer one is published, which is
+    once a ledger. Other reads take no lock and change no shared count
+    but that of the ledger returned.
+
+    The snapshot does not own the ledgers, which are held by the ledger
+    history and the ledger master. A ledger no longer held elsewhere is
+    not found, and the caller falls back to its usual lookup.
+*/
+class RecentLedgers
+{
+public:
+    /** The number of ledgers kept, by sequence. */
+    static std::size_t constexpr size = 256;
+
+    explicit
+    RecentLedgers (beast::Journal j);
+
+    RecentLedgers (RecentLedgers const&) = delete;
+    RecentLedgers& operator= (RecentLedgers const&) = delete;
+
+    /** Publish a newly validated ledger.
+
+        Kept ledgers which are not its ancestors are dropped.
+    */
+    void
+    setValidated (std::shared_ptr<Ledger const> const& ledger);
+
+    /** Publish a ledger of the validated chain.
+
+        The ledger is not kept unless it is one of the last ledgers
+        before the validated ledger, according to that ledger.
+    */
+    void
+    insert (std::shared_ptr<Ledger const> const& ledger);
+
+    /** Return the validated ledger, or null. */
+    std::shared_ptr<Ledger const>
+    validated () const;
+
+    /** Return the ledger of the validated chain with a sequence, or null. */
+    std::shared_ptr<Ledger const>
+    get (LedgerIndex seq) const;
+
+    /** Return the kept ledger with a hash, or null. */
+    std::shared_ptr<Ledger const>
+    get (LedgerHash const& hash) const;
+
+private:
+    struct Snapshot
+    {
+        std::uint64_t generation = 0;
+        std::weak_ptr<Ledger const> validated;
+
+        // The ledgers at their sequence modulo size
+        std::array<std::weak_ptr<Ledger const>, size> ledgers;
+        hash_map<LedgerHash, LedgerIndex> seqs;
+    };
+
+    Snapshot const&
+    current () const;
+
+    void
+    place (Snapshot& next, std::shared_ptr<Ledger const> const& ledger);
+
+    void
+    publish (std::shared_ptr<Snapshot> next);
+
+    beast::Journal j_;
+
+    // Serializes writers
+    std::mutex mutex_;
+
+    std::shared_ptr<Snapshot const> snapshot_;
+    std::atomic<std::uint64_t> generation_;
+};
+
+} // ripple
+
+#endif
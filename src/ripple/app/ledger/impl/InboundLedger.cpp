@@ -27,6 +27,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/StrandWorkers.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/resource/Fees.h>
@@ -56,6 +57,12 @@ enum
     // Number of nodes to find initially
     ,missingNodesFind = 256
 
+    // Number of threads to find missing state nodes with
+    ,missingNodesThreads = 4
+
+    // Number of threads to check the nodes received from peers with
+    ,checkNodesThreads = 4
+
     // Number of nodes to request for a reply
     ,reqNodesReply = 128
 
@@ -264,7 +271,7 @@ bool InboundLedger::tryLocal ()
         else
         {
             mLedger = std::make_shared<Ledger>(
-                deserializeHeader (makeSlice (node->getData()), true),
+                deserializeHeader (node->getData(), true),
                 app_.config(),
                 app_.family());
         }
@@ -616,7 +623,7 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
             // Release the lock while we process the large state map
             sl.unlock();
             auto nodes = mLedger->stateMap().getMissingNodes (
-                missingNodesFind, &filter);
+                missingNodesFind, &filter, missingNodesThreads);
             sl.lock();
 
             // Make sure nothing happened while we released the lock
@@ -837,7 +844,8 @@ bool InboundLedger::takeHeader (std::string const& data)
     Call with a lock
 */
 bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
-    const std::vector< Blob >& data, SHAMapAddNode& san)
+    const std::vector< Blob >& data, CheckedNodes const& checked,
+    SHAMapAddNode& san)
 {
     if (!mHaveHeader)
     {
@@ -855,6 +863,7 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
 
     auto nodeIDit = nodeIDs.cbegin ();
     auto nodeDatait = data.begin ();
+    auto checkedit = checked.begin ();
     TransactionStateSF filter(mLedger->txMap().family(),
         app_.getLedgerMaster());
 
@@ -871,13 +880,14 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
         else
         {
             san +=  mLedger->txMap().addKnownNode (
-                *nodeIDit, makeSlice(*nodeDatait), &filter);
+                *nodeIDit, *checkedit, &filter);
             if (!san.isGood())
                 return false;
         }
 
         ++nodeIDit;
         ++nodeDatait;
+        ++checkedit;
     }
 
     if (!mLedger->txMap().isSynching ())
@@ -898,7 +908,8 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
     Call with a lock
 */
 bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
-    const std::vector< Blob >& data, SHAMapAddNode& san)
+    const std::vector< Blob >& data, CheckedNodes const& checked,
+    SHAMapAddNode& san)
 {
     JLOG (m_journal.trace()) <<
         "got ASdata (" << nodeIDs.size () <<
@@ -927,6 +938,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
 
     auto nodeIDit = nodeIDs.cbegin ();
     auto nodeDatait = data.begin ();
+    auto checkedit = checked.begin ();
     AccountStateSF filter(mLedger->stateMap().family(),
         app_.getLedgerMaster());
 
@@ -947,7 +959,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
         else
         {
             san += mLedger->stateMap().addKnownNode (
-                *nodeIDit, makeSlice(*nodeDatait), &filter);
+                *nodeIDit, *checkedit, &filter);
             if (!san.isGood ())
             {
                 JLOG (m_journal.warn()) <<
@@ -958,6 +970,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
 
         ++nodeIDit;
         ++nodeDatait;
+        ++checkedit;
     }
 
     if (!mLedger->stateMap().isSynching ())
@@ -1080,6 +1093,37 @@ bool InboundLedger::gotData (std::weak_ptr<Peer> peer,
     return true;
 }
 
+/** Parse the nodes of a TMLedgerData and compute their hashes
+    Call without a lock
+*/
+auto
+InboundLedger::checkNodes (protocol::TMLedgerData const& packet,
+    beast::Journal j) -> CheckedNodes
+{
+    CheckedNodes checked;
+
+    if ((packet.type () != protocol::liTX_NODE) &&
+        (packet.type () != protocol::liAS_NODE))
+        return checked;
+
+    checked.reserve (packet.nodes ().size ());
+    for (auto const& node : packet.nodes ())
+    {
+        if (!node.has_nodeid () || !node.has_nodedata ())
+            break;
+
+        SHAMapNodeID const nodeID (node.nodeid ().data (),
+            node.nodeid ().size ());
+        if (nodeID.isRoot ())
+            checked.emplace_back ();
+        else
+            checked.push_back (SHAMap::makeKnownNode (
+                nodeID, makeSlice (node.nodedata ()), j));
+    }
+
+    return checked;
+}
+
 /** Process one TMLedgerData
     Returns the number of useful nodes
 */
@@ -1089,7 +1133,7 @@ bool InboundLedger::gotData (std::weak_ptr<Peer> peer,
 //        TODO Change peer to Consumer
 //
 int InboundLedger::processData (std::shared_ptr<Peer> peer,
-    protocol::TMLedgerData& packet)
+    protocol::TMLedgerData& packet, CheckedNodes const& checked)
 {
     ScopedLockType sl (mLock);
 
@@ -1170,21 +1214,26 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
 
             nodeIDs.push_back (SHAMapNodeID (node.nodeid ().data (),
                 node.nodeid ().size ()));
-            nodeData.push_back (Blob (node.nodedata ().begin (),
-                node.nodedata ().end ()));
+
+            // Only root nodes are parsed here, the others were checked
+            if (nodeIDs.back ().isRoot ())
+                nodeData.push_back (Blob (node.nodedata ().begin (),
+                    node.nodedata ().end ()));
+            else
+                nodeData.emplace_back ();
         }
 
         SHAMapAddNode san;
 
         if (packet.type () == protocol::liTX_NODE)
         {
-            takeTxNode (nodeIDs, nodeData, san);
+            takeTxNode (nodeIDs, nodeData, checked, san);
             JLOG (m_journal.debug()) <<
                 "Ledger TX node stats: " << san.get();
         }
         else
         {
-            takeAsNode (nodeIDs, nodeData, san);
+            takeAsNode (nodeIDs, nodeData, checked, san);
             JLOG (m_journal.debug()) <<
                 "Ledger AS node stats: " << san.get();
         }
@@ -1224,13 +1273,22 @@ void InboundLedger::runData ()
             data.swap(mReceivedData);
         }
 
+        // Parse and hash the nodes from different peers at the same
+        // time, before the ledger is locked to add them.
+        std::vector<CheckedNodes> checked (data.size ());
+        StrandWorkers::instance (checkNodesThreads).run (data.size (),
+            [&](std::size_t i)
+            {
+                checked[i] = checkNodes (*data[i].second, m_journal);
+            });
+
         // Select the peer that gives us the most nodes that are useful,
         // breaking ties in favor of the peer that responded first.
-        for (auto& entry : data)
+        for (std::size_t i = 0; i < data.size (); ++i)
         {
-            if (auto peer = entry.first.lock())
+            if (auto peer = data[i].first.lock())
             {
-                int count = processData (peer, *(entry.second));
+                int count = processData (peer, *data[i].second, checked[i]);
                 if (count > chosenPeerCount)
                 {
                     chosenPeerCount = count;
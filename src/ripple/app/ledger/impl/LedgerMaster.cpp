@@ -47,6 +47,8 @@
 #include <ripple/resource/Fees.h>
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -60,6 +62,15 @@ using namespace std::chrono_literals;
 // Don't acquire history if ledger is too old
 auto constexpr MAX_LEDGER_AGE_ACQUIRE = 1min;
 
+// Don't send more messages than this for one fetch pack request, so the
+// peer's send queue stays short
+auto constexpr fetchPackMessages = 8;
+
+// Bytes of cached fetch pack deltas to keep, and how long to keep one
+// which is not used
+std::size_t constexpr fetchPackDeltaBytes = 64 * 1024 * 1024;
+auto constexpr fetchPackDeltaAge = 60s;
+
 LedgerMaster::LedgerMaster (Application& app, Stopwatch& stopwatch,
     Stoppable& parent,
     beast::insight::Collector::ptr const& collector, beast::Journal journal)
@@ -68,6 +79,7 @@ LedgerMaster::LedgerMaster (Application& app, Stopwatch& stopwatch,
     , m_journal (journal)
     , mLastValidLedger (std::make_pair (uint256(), 0))
     , mLedgerHistory (collector, app)
+    , mRecentLedgers (app_.journal("RecentLedgers"))
     , mHeldTransactions (uint256 ())
     , mLedgerCleaner (detail::make_LedgerCleaner (
         app, *this, app_.journal("LedgerCleaner")))
@@ -89,6 +101,7 @@ LedgerMaster::LedgerMaster (Application& app, Stopwatch& stopwatch,
     , ledger_fetch_size_ (app_.config().getSize (siLedgerFetch))
     , fetch_packs_ ("FetchPack", 65536, 45, stopwatch,
         app_.journal("TaggedCache"))
+    , stopwatch_ (stopwatch)
     , fetch_seq_ (0)
 {
 }
@@ -220,6 +233,7 @@ LedgerMaster::setValidLedger(
     }
 
     mValidLedger.set (l);
+    mRecentLedgers.setValidated (l);
     mValidLedgerSign = signTime.time_since_epoch().count();
     mValidLedgerSeq = l->info().seq;
 
@@ -525,6 +539,17 @@ LedgerMaster::getFetchPack (LedgerHash missingHash, LedgerIndex missingIndex)
     }
     assert(haveHash->isNonZero());
 
+    // A pack streamed earlier may already hold this ledger. Its header is
+    // only sent after all of its nodes, so the stream resumes with a
+    // request for the first ledger the pack lacks in part, starting after
+    // the last of its nodes received.
+    if (fetch_packs_.refreshIfPresent (missingHash))
+    {
+        JLOG (m_journal.trace()) << "Already have fetch pack for "
+                                            << missingIndex;
+        return;
+    }
+
     // Select target Peer based on highest score.  The score is randomized
     // but biased in favor of Peers with low latency.
     std::shared_ptr<Peer> target;
@@ -551,6 +576,15 @@ LedgerMaster::getFetchPack (LedgerHash missingHash, LedgerIndex missingIndex)
         tmBH.set_query (true);
         tmBH.set_type (protocol::TMGetObjectByHash::otFETCH_PACK);
         tmBH.set_ledgerhash (haveHash->begin(), 32);
+        {
+            std::lock_guard<std::mutex> lock (fetch_resume_mutex_);
+            if (fetch_resume_seq_ == missingIndex)
+            {
+                auto& cursor = *tmBH.add_objects ();
+                cursor.set_hash (fetch_resume_hash_.begin(), 32);
+                cursor.set_ledgerseq (fetch_resume_seq_);
+            }
+        }
         auto packet = std::make_shared<Message> (
             tmBH, protocol::mtGET_OBJECTS);
 
@@ -633,6 +667,7 @@ LedgerMaster::setFullLedger (
 
     if (isCurrent)
         mLedgerHistory.insert(ledger, true);
+    mRecentLedgers.insert (ledger);
 
     {
         // Check the SQL database's entry for the sequence before this
@@ -1391,6 +1426,9 @@ LedgerMaster::walkHashBySeq (
 std::shared_ptr<Ledger const>
 LedgerMaster::getLedgerBySeq (std::uint32_t index)
 {
+    if (auto ret = mRecentLedgers.get (index))
+        return ret;
+
     if (index <= mValidLedgerSeq)
     {
         // Always prefer a validated ledger
@@ -1427,6 +1465,9 @@ LedgerMaster::getLedgerBySeq (std::uint32_t index)
 std::shared_ptr<Ledger const>
 LedgerMaster::getLedgerByHash (uint256 const& hash)
 {
+    if (auto ret = mRecentLedgers.get (hash))
+        return ret;
+
     if (auto ret = mLedgerHistory.getLedgerByHash (hash))
         return ret;
 
@@ -1461,6 +1502,7 @@ LedgerMaster::sweep ()
 {
     mLedgerHistory.sweep ();
     fetch_packs_.sweep ();
+    sweepFetchPackDeltas ();
 }
 
 float
@@ -1747,15 +1789,28 @@ LedgerMaster::getFetchPack (
 void
 LedgerMaster::gotFetchPack (
     bool progress,
-    std::uint32_t seq)
+    std::uint32_t seq,
+    uint256 const& last)
 {
-    // FIXME: Calling this function more than once will result in
-    // InboundLedgers::gotFetchPack being called more than once
-    // which is expensive. A flag should track whether we've already dispatched
+    if (seq != 0)
+    {
+        std::lock_guard<std::mutex> lock (fetch_resume_mutex_);
+        fetch_resume_seq_ = seq;
+        fetch_resume_hash_ = last;
+    }
+
+    // Fetch packs arrive in several messages. InboundLedgers::gotFetchPack
+    // is expensive, so one job handles all which arrive before it runs.
+    if (fetch_pending_.exchange (true))
+        return;
 
     app_.getJobQueue().addJob (
         jtLEDGER_DATA, "gotFetchPack",
-        [&] (Job&) { app_.getInboundLedgers().gotFetchPack(); });
+        [&] (Job&)
+        {
+            fetch_pending_ = false;
+            app_.getInboundLedgers().gotFetchPack();
+        });
 }
 
 void
@@ -1823,18 +1878,6 @@ LedgerMaster::makeFetchPack (
     }
 
 
-    auto fpAppender = [](
-        protocol::TMGetObjectByHash* reply,
-        std::uint32_t ledgerSeq,
-        SHAMapHash const& hash,
-        const Blob& blob)
-    {
-        protocol::TMIndexedObject& newObj = * (reply->add_objects ());
-        newObj.set_ledgerseq (ledgerSeq);
-        newObj.set_hash (hash.as_uint256().begin (), 256 / 8);
-        newObj.set_data (&blob[0], blob.size ());
-    };
-
     try
     {
         protocol::TMGetObjectByHash reply;
@@ -1847,39 +1890,87 @@ LedgerMaster::makeFetchPack (
         reply.set_type (protocol::TMGetObjectByHash::otFETCH_PACK);
 
         // Building a fetch pack:
-        //  1. Add the header for the requested ledger.
-        //  2. Add the nodes for the AccountStateMap of that ledger.
-        //  3. If there are transactions, add the nodes for the
-        //     transactions of the ledger.
-        //  4. If the FetchPack now contains greater than or equal to
-        //     256 entries then stop.
-        //  5. If not very much time has elapsed, then loop back and repeat
-        //     the same process adding the previous ledger to the FetchPack.
+        //  1. Add the nodes of the AccountStateMap of the parent of the
+        //     requested ledger which the requested ledger lacks, and the
+        //     nodes of its transaction map. If the request names a node
+        //     of the parent, start after it.
+        //  2. Add the header of the parent.
+        //  3. Send the objects added so far whenever there are 512
+        //     of them, so the peer can start using them. Stop once
+        //     enough messages have been sent.
+        //  4. If the whole ledger was sent and not very much time has
+        //     elapsed, then loop back and repeat the same process for
+        //     the previous ledger.
+        //
+        // The peer resumes by asking for a fetch pack from the oldest
+        // ledger whose header it has not received, naming the last node
+        // of that ledger it has.
+        std::size_t sent = 0;
+        std::size_t messages = 0;
+        auto const flush = [&]
+        {
+            sent += reply.objects_size ();
+            ++messages;
+            peer->send (std::make_shared<Message> (
+                reply, protocol::mtGET_OBJECTS));
+            reply.clear_objects ();
+        };
+
+        bool full = false;
+
+        // The node to resume after, if any
+        boost::optional<uint256> cursor;
+        if (request->objects_size () == 1)
+        {
+            auto const& obj = request->objects (0);
+            if (obj.has_ledgerseq () &&
+                obj.ledgerseq () == wantLedger->info().seq &&
+                obj.hash ().size () == 256 / 8)
+            {
+                cursor = uint256 ();
+                memcpy (cursor->begin (), obj.hash ().data (), 256 / 8);
+            }
+        }
+
         do
         {
             std::uint32_t lSeq = wantLedger->info().seq;
+            auto const delta = getFetchPackDelta (*haveLedger, *wantLedger);
+
+            auto begin = delta->nodes.begin ();
+            if (cursor)
+            {
+                auto const it = std::find_if (begin, delta->nodes.end (),
+                    [&](std::pair<uint256, Blob> const& node)
+                    {
+                        return node.first == *cursor;
+                    });
+                if (it != delta->nodes.end ())
+                    begin = std::next (it);
+                cursor.reset ();
+            }
+
+            for (auto iter = begin; iter != delta->nodes.end (); ++iter)
+            {
+                auto const& node = *iter;
+                protocol::TMIndexedObject& newObj = *reply.add_objects ();
+                newObj.set_hash (node.first.data(), 256 / 8);
+                newObj.set_data (node.second.data(), node.second.size());
+                newObj.set_ledgerseq (lSeq);
+
+                if (reply.objects_size () >= 512)
+                {
+                    flush ();
 
-            protocol::TMIndexedObject& newObj = *reply.add_objects ();
-            newObj.set_hash (
-                wantLedger->info().hash.data(), 256 / 8);
-            Serializer s (256);
-            s.add32 (HashPrefix::ledgerMaster);
-            addRaw(wantLedger->info(), s);
-            newObj.set_data (s.getDataPtr (), s.getLength ());
-            newObj.set_ledgerseq (lSeq);
-
-            wantLedger->stateMap().getFetchPack
-                (&haveLedger->stateMap(), true, 16384,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
-
-            if (wantLedger->info().txHash.isNonZero ())
-                wantLedger->txMap().getFetchPack (
-                    nullptr, true, 512,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
-
-            if (reply.objects ().size () >= 512)
+                    if (messages >= fetchPackMessages)
+                    {
+                        full = true;
+                        break;
+                    }
+                }
+            }
+
+            if (full)
                 break;
 
             // move may save a ref/unref
@@ -1889,10 +1980,12 @@ LedgerMaster::makeFetchPack (
         while (wantLedger &&
                UptimeTimer::getInstance ().getElapsedSeconds () <= uUptime + 1);
 
+        if (reply.objects_size () != 0)
+            flush ();
+
         JLOG(m_journal.info())
-            << "Built fetch pack with " << reply.objects ().size () << " nodes";
-        auto msg = std::make_shared<Message> (reply, protocol::mtGET_OBJECTS);
-        peer->send (msg);
+            << "Sent fetch pack with " << sent << " nodes in "
+            << messages << " messages";
     }
     catch (std::exception const&)
     {
@@ -1900,6 +1993,93 @@ LedgerMaster::makeFetchPack (
     }
 }
 
+auto
+LedgerMaster::getFetchPackDelta (Ledger const& have, Ledger const& want) ->
+    std::shared_ptr<FetchPackDelta const>
+{
+    auto const& key = have.info().hash;
+
+    {
+        std::lock_guard<std::mutex> lock (fetch_deltas_mutex_);
+        auto const it = fetch_delta_index_.find (key);
+        if (it != fetch_delta_index_.end ())
+        {
+            ++fetch_delta_hits_;
+            it->second->used = stopwatch_.now ();
+            fetch_deltas_.splice (
+                fetch_deltas_.begin (), fetch_deltas_, it->second);
+            return it->second->delta;
+        }
+        ++fetch_delta_misses_;
+    }
+
+    auto delta = std::make_shared<FetchPackDelta> ();
+    auto const add = [&delta](SHAMapHash const& hash, Blob const& blob)
+    {
+        delta->bytes += hash.as_uint256().size() + blob.size();
+        delta->nodes.emplace_back (hash.as_uint256(), blob);
+    };
+
+    // The whole ledger is walked, a request resumes within it
+    want.stateMap().getFetchPack (&have.stateMap(), true,
+        std::numeric_limits<int>::max (), add);
+
+    if (want.info().txHash.isNonZero ())
+        want.txMap().getFetchPack (nullptr, true,
+            std::numeric_limits<int>::max (), add);
+
+    Serializer s (256);
+    s.add32 (HashPrefix::ledgerMaster);
+    addRaw (want.info(), s);
+    add (SHAMapHash{want.info().hash}, s.peekData());
+
+    std::lock_guard<std::mutex> lock (fetch_deltas_mutex_);
+
+    // Another request may have built the same delta meanwhile
+    auto const it = fetch_delta_index_.find (key);
+    if (it != fetch_delta_index_.end ())
+        return it->second->delta;
+
+    fetch_deltas_.push_front ({key, delta, stopwatch_.now ()});
+    fetch_delta_index_.emplace (key, fetch_deltas_.begin ());
+    fetch_delta_bytes_ += delta->bytes;
+
+    while (fetch_delta_bytes_ > fetchPackDeltaBytes &&
+        fetch_deltas_.size () > 1)
+    {
+        auto const& last = fetch_deltas_.back ();
+        fetch_delta_bytes_ -= last.delta->bytes;
+        fetch_delta_index_.erase (last.key);
+        fetch_deltas_.pop_back ();
+    }
+
+    return delta;
+}
+
+void
+LedgerMaster::sweepFetchPackDeltas ()
+{
+    auto const expire = stopwatch_.now () - fetchPackDeltaAge;
+
+    std::lock_guard<std::mutex> lock (fetch_deltas_mutex_);
+    while (! fetch_deltas_.empty () && fetch_deltas_.back ().used < expire)
+    {
+        auto const& last = fetch_deltas_.back ();
+        fetch_delta_bytes_ -= last.delta->bytes;
+        fetch_delta_index_.erase (last.key);
+        fetch_deltas_.pop_back ();
+    }
+}
+
+float
+LedgerMaster::getFetchPackDeltaHitRate ()
+{
+    std::lock_guard<std::mutex> lock (fetch_deltas_mutex_);
+    auto const total = static_cast<float> (
+        fetch_delta_hits_ + fetch_delta_misses_);
+    return fetch_delta_hits_ * (100.0f / std::max (1.0f, total));
+}
+
 std::size_t
 LedgerMaster::getFetchPackCacheSize () const
 {
@@ -0,0 +1,355 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerSnapshot.h>
+#include <ripple/app/ledger/InboundLedger.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/basics/contract.h>
+#include <ripple/basics/Log.h>
+#include <ripple/basics/StrandWorkers.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/nodestore/Database.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/shamap/SHAMapTreeNode.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+std::array<char, 6> const magic {{'R', 'L', 'S', 'N', 'A', 'P'}};
+std::uint16_t const version = 1;
+
+// Bytes buffered before a write, and nodes read before they are checked
+// and stored together
+std::size_t const bufferBytes = 1 << 20;
+std::size_t const batchNodes = 16384;
+
+// Largest serialized node or header accepted when reading
+std::uint32_t const maxNodeBytes = 1 << 20;
+
+// Writes a file through a buffer, hashing everything written
+class SnapshotWriter
+{
+    std::ofstream out_;
+    sha512_half_hasher hasher_;
+    Serializer buffer_;
+
+public:
+    explicit
+    SnapshotWriter (std::string const& path)
+        : out_ (path, std::ios::binary | std::ios::trunc)
+        , buffer_ (bufferBytes)
+    {
+        if (! out_)
+            Throw<std::runtime_error> ("Can't open " + path);
+    }
+
+    Serializer&
+    buffer ()
+    {
+        return buffer_;
+    }
+
+    void
+    flush ()
+    {
+        hasher_ (buffer_.data(), buffer_.size());
+        out_.write (static_cast<char const*> (buffer_.data()),
+            buffer_.size());
+        buffer_.erase ();
+        if (! out_)
+            Throw<std::runtime_error> ("Error writing snapshot");
+    }
+
+    void
+    close ()
+    {
+        flush ();
+        auto const checksum = static_cast<uint256> (hasher_);
+        out_.write (reinterpret_cast<char const*> (checksum.data()),
+            checksum.size());
+        out_.close ();
+        if (! out_)
+            Throw<std::runtime_error> ("Error writing snapshot");
+    }
+};
+
+// Reads a file, hashing everything read
+class SnapshotReader
+{
+    std::ifstream in_;
+    sha512_half_hasher hasher_;
+
+public:
+    explicit
+    SnapshotReader (std::string const& path)
+        : in_ (path, std::ios::binary)
+    {
+    }
+
+    explicit
+    operator bool () const
+    {
+        return static_cast<bool> (in_);
+    }
+
+    bool
+    read (void* data, std::size_t size)
+    {
+        if (! in_.read (static_cast<char*> (data), size))
+            return false;
+        hasher_ (data, size);
+        return true;
+    }
+
+    template <class Integer>
+    bool
+    read (Integer& value)
+    {
+        std::array<std::uint8_t, sizeof (Integer)> bytes;
+        if (! read (bytes.data(), bytes.size()))
+            return false;
+        value = 0;
+        for (auto const b : bytes)
+            value = (value << 8) | b;
+        return true;
+    }
+
+    // The hash of everything read so far, and the checksum which follows
+    bool
+    checksum ()
+    {
+        auto const expected = static_cast<uint256> (hasher_);
+        uint256 checksum;
+        if (! in_.read (reinterpret_cast<char*> (checksum.data()),
+                checksum.size()))
+            return false;
+        return checksum == expected;
+    }
+};
+
+// Check the nodes against their hashes, on the workers' threads
+bool
+verify (NodeStore::Batch const& batch, StrandWorkers& workers)
+{
+    std::atomic<bool> valid {true};
+    workers.run (batch.size(), [&batch, &valid](std::size_t i)
+    {
+        if (valid && sha512Half (batch[i]->getData()) !=
+                batch[i]->getHash())
+            valid = false;
+    });
+    return valid;
+}
+
+} // namespace
+
+std::uint64_t
+writeLedgerSnapshot (Ledger const& ledger, std::string const& path)
+{
+    // Writers share the temporary file, so one writes at a time
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock (mutex);
+
+    auto const temp = path + ".tmp";
+    SnapshotWriter out (temp);
+    auto& buffer = out.buffer();
+
+    buffer.addRaw (magic.data(), magic.size());
+    buffer.add16 (version);
+
+    Serializer header (128);
+    header.add32 (HashPrefix::ledgerMaster);
+    addRaw (ledger.info(), header);
+    buffer.add32 (header.size());
+    buffer.addRaw (header);
+
+    std::uint64_t count = 0;
+    Serializer node;
+    auto const write = [&](NodeObjectType type, SHAMapAbstractNode& n)
+    {
+        node.erase ();
+        n.addRaw (node, snfPREFIX);
+        buffer.add8 (type);
+        buffer.add256 (n.getNodeHash().as_uint256());
+        buffer.add32 (node.size());
+        buffer.addRaw (node);
+        if (buffer.size() >= bufferBytes)
+            out.flush ();
+        ++count;
+        return false;
+    };
+
+    if (ledger.info().accountHash.isNonZero())
+        ledger.stateMap().visitNodes ([&](SHAMapAbstractNode& n)
+            { return write (hotACCOUNT_NODE, n); });
+    if (ledger.info().txHash.isNonZero())
+        ledger.txMap().visitNodes ([&](SHAMapAbstractNode& n)
+            { return write (hotTRANSACTION_NODE, n); });
+
+    buffer.add8 (0);
+    buffer.add64 (count);
+    out.close ();
+
+    boost::filesystem::rename (temp, path);
+    return count;
+}
+
+std::shared_ptr<Ledger>
+loadLedgerSnapshot (std::string const& path, Application& app,
+    beast::Journal j)
+{
+    SnapshotReader in (path);
+    if (! in)
+    {
+        JLOG (j.error()) << "Can't open snapshot " << path;
+        return nullptr;
+    }
+
+    auto const damaged = [&j, &path](char const* reason)
+        -> std::shared_ptr<Ledger>
+    {
+        JLOG (j.error()) << "Snapshot " << path << " is damaged: " << reason;
+        return nullptr;
+    };
+
+    std::array<char, 6> m;
+    std::uint16_t v;
+    if (! in.read (m.data(), m.size()) || m != magic ||
+            ! in.read (v) || v != version)
+        return damaged ("not a snapshot");
+
+    std::uint32_t size;
+    if (! in.read (size) || size > maxNodeBytes)
+        return damaged ("bad header");
+    Blob header (size);
+    if (! in.read (header.data(), header.size()))
+        return damaged ("bad header");
+    auto const hash = sha512Half (makeSlice (header));
+    auto const info = InboundLedger::deserializeHeader (
+        makeSlice (header), true);
+
+    // The nodes named by a parent which have not been read yet. Nodes are
+    // written parent first, so this holds few more than a path of the tree.
+    hash_map<uint256, NodeObjectType> expected;
+    if (info.accountHash.isNonZero())
+        expected.emplace (info.accountHash, hotACCOUNT_NODE);
+    if (info.txHash.isNonZero())
+        expected.emplace (info.txHash, hotTRANSACTION_NODE);
+
+    auto& db = app.getNodeStore();
+    auto& workers = StrandWorkers::instance (std::max (1u,
+        std::min (std::thread::hardware_concurrency(), 8u)));
+    NodeStore::Batch batch;
+    batch.reserve (batchNodes);
+    std::uint64_t count = 0;
+
+    for (;;)
+    {
+        std::uint8_t type;
+        if (! in.read (type))
+            return damaged ("truncated");
+        if (type == 0)
+            break;
+
+        uint256 nodeHash;
+        Blob data;
+        if (! in.read (nodeHash.data(), nodeHash.size()) ||
+                ! in.read (size) || size > maxNodeBytes || size < 4)
+            return damaged ("bad node");
+        data.resize (size);
+        if (! in.read (data.data(), data.size()))
+            return damaged ("truncated");
+
+        auto const iter = expected.find (nodeHash);
+        if (iter == expected.end() || iter->second != type)
+            return damaged ("unexpected node");
+        expected.erase (iter);
+
+        // Inner nodes name the nodes which must follow
+        auto const prefix = (std::uint32_t (data[0]) << 24) |
+            (std::uint32_t (data[1]) << 16) |
+            (std::uint32_t (data[2]) << 8) | data[3];
+        if (prefix == HashPrefix::innerNode ||
+            prefix == HashPrefix::innerNodeV2)
+        {
+            auto const node = SHAMapAbstractNode::make (makeSlice (data),
+                0, snfPREFIX, SHAMapHash{nodeHash}, true, j);
+            if (! node || ! node->isInner())
+                return damaged ("bad inner node");
+            auto const& inner = static_cast<SHAMapInnerNode&> (*node);
+            for (int i = 0; i < 16; ++i)
+            {
+                if (! inner.isEmptyBranch (i))
+                    expected.emplace (inner.getChildHash (i).as_uint256(),
+                        static_cast<NodeObjectType> (type));
+            }
+        }
+
+        batch.push_back (NodeObject::createObject (
+            static_cast<NodeObjectType> (type), std::move (data), nodeHash));
+        ++count;
+
+        if (batch.size() >= batchNodes)
+        {
+            if (! verify (batch, workers))
+                return damaged ("node does not match its hash");
+            db.storeBatch (batch);
+            batch.clear ();
+        }
+    }
+
+    std::uint64_t written;
+    if (! in.read (written) || written != count || ! in.checksum ())
+        return damaged ("bad checksum");
+    if (! expected.empty ())
+        return damaged ("missing nodes");
+    if (! verify (batch, workers))
+        return damaged ("node does not match its hash");
+    db.storeBatch (batch);
+    db.store (hotLEDGER, std::move (header), hash);
+
+    JLOG (j.info()) << "Loaded " << count << " nodes of ledger " <<
+        info.seq << " from snapshot";
+
+    bool loaded;
+    auto ledger = std::make_shared<Ledger> (
+        info, loaded, app.config(), app.family(), j);
+    if (! loaded)
+        return nullptr;
+    ledger->setImmutable (app.config());
+    ledger->setFull ();
+    if (ledger->info().hash != hash)
+        return damaged ("bad ledger hash");
+    return ledger;
+}
+
+} // ripple
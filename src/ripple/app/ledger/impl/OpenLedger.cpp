@@ -22,9 +22,12 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/tx/apply.h>
+#include <ripple/basics/StrandWorkers.h>
 #include <ripple/ledger/CachedView.h>
 #include <ripple/protocol/Feature.h>
 #include <boost/range/adaptor/transformed.hpp>
+#include <algorithm>
+#include <set>
 
 namespace ripple {
 
@@ -154,6 +157,317 @@ OpenLedger::apply_one (Application& app, OpenView& view,
     return Result::retry;
 }
 
+namespace detail {
+
+// Forwards to a view, recording the state entries read through it
+class ReadSet : public ReadView
+{
+public:
+    explicit ReadSet (ReadView const& base)
+        : base_ (base)
+    {
+    }
+
+    /** Returns `true` if a read could see one of the written keys. */
+    bool
+    conflicts (std::set<uint256> const& written) const
+    {
+        if (all_)
+            return true;
+        if (written.empty())
+            return false;
+        for (auto const& key : keys_)
+            if (written.count(key))
+                return true;
+        for (auto const& range : ranges_)
+        {
+            auto const iter = written.upper_bound(range.first);
+            if (iter != written.end() &&
+                    (! range.second || *iter < *range.second))
+                return true;
+        }
+        return false;
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    bool
+    exists (Keylet const& k) const override
+    {
+        keys_.push_back(k.key);
+        return base_.exists(k);
+    }
+
+    boost::optional<key_type>
+    succ (key_type const& key, boost::optional<
+        key_type> const& last = boost::none) const override
+    {
+        ranges_.emplace_back(key, last);
+        return base_.succ(key, last);
+    }
+
+    std::shared_ptr<SLE const>
+    read (Keylet const& k) const override
+    {
+        keys_.push_back(k.key);
+        return base_.read(k);
+    }
+
+    // Iterating the state or transactions is never
+    // speculated, the transaction is applied again.
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        all_ = true;
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        all_ = true;
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound(key_type const& key) const override
+    {
+        all_ = true;
+        return base_.slesUpperBound(key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        all_ = true;
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        all_ = true;
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists (key_type const& key) const override
+    {
+        all_ = true;
+        return base_.txExists(key);
+    }
+
+    tx_type
+    txRead (key_type const& key) const override
+    {
+        all_ = true;
+        return base_.txRead(key);
+    }
+
+private:
+    ReadView const& base_;
+    std::vector<uint256> mutable keys_;
+    std::vector<std::pair<uint256,
+        boost::optional<uint256>>> mutable ranges_;
+    bool mutable all_ = false;
+};
+
+// Forwards changes to a view if there is one, recording the keys written
+class WriteSet : public TxsRawView
+{
+public:
+    WriteSet (OpenView* to, std::set<uint256>& written)
+        : to_ (to)
+        , written_ (written)
+    {
+    }
+
+    void
+    rawErase (std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert(sle->key());
+        if (to_)
+            to_->rawErase(sle);
+    }
+
+    void
+    rawInsert (std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert(sle->key());
+        if (to_)
+            to_->rawInsert(sle);
+    }
+
+    void
+    rawReplace (std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert(sle->key());
+        if (to_)
+            to_->rawReplace(sle);
+    }
+
+    void
+    rawDestroyXRP (XRPAmount const& fee) override
+    {
+        if (to_)
+            to_->rawDestroyXRP(fee);
+    }
+
+    void
+    rawTxInsert (ReadView::key_type const& key,
+        std::shared_ptr<Serializer const> const& txn,
+            std::shared_ptr<Serializer const> const& metaData) override
+    {
+        if (! to_)
+            return;
+        if (! metaData || metaData->size() == 0)
+        {
+            to_->rawTxInsert(key, txn, metaData);
+            return;
+        }
+        // The metadata was built in a view of its own, which
+        // numbered the transaction from zero. Give it the
+        // position it takes in the view it is committed to.
+        SerialIter sit (metaData->slice());
+        STObject meta (sit, sfMetadata);
+        meta.setFieldU32 (sfTransactionIndex,
+            static_cast<std::uint32_t>(to_->txCount()));
+        auto s = std::make_shared<Serializer>();
+        meta.add (*s);
+        to_->rawTxInsert(key, txn, s);
+    }
+
+private:
+    OpenView* to_;
+    std::set<uint256>& written_;
+};
+
+// Returns `true` if the view writes one of the written keys
+bool
+overlaps (OpenView const& view, std::set<uint256> const& written)
+{
+    if (written.empty())
+        return false;
+    std::set<uint256> keys;
+    WriteSet collect (nullptr, keys);
+    view.apply(collect);
+    for (auto const& key : keys)
+        if (written.count(key))
+            return true;
+    return false;
+}
+
+} // detail
+
+auto
+OpenLedger::apply_batch (Application& app, OpenView& view,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+        bool retry, ApplyFlags flags, std::size_t threads,
+            beast::Journal j) -> std::vector<Result>
+{
+    // Transactions speculated against the same state at once
+    std::size_t const batchSize = 64 * threads;
+
+    struct Speculation
+    {
+        std::unique_ptr<detail::ReadSet> reads;
+        boost::optional<OpenView> view;
+        Result result = Result::failure;
+        bool applied = false;
+    };
+
+    std::vector<Result> results;
+    results.reserve(txs.size());
+    std::set<uint256> written;
+    std::size_t reapplied = 0;
+    auto& workers = StrandWorkers::instance(threads);
+
+    for (std::size_t first = 0; first < txs.size(); first += batchSize)
+    {
+        auto const last = std::min(first + batchSize, txs.size());
+        std::vector<Speculation> specs(last - first);
+
+        // Apply each transaction on its own. Nothing
+        // modifies the view until they are all done.
+        workers.run(last - first, [&](std::size_t i)
+        {
+            auto& spec = specs[i];
+            try
+            {
+                spec.reads = std::make_unique<
+                    detail::ReadSet>(view);
+                spec.view.emplace(&*spec.reads);
+                spec.result = apply_one(app, *spec.view,
+                    txs[first + i], retry, flags, j);
+                spec.applied = true;
+            }
+            catch (std::exception const&)
+            {
+                // Left to be applied again
+            }
+        });
+
+        // Commit in order, applying again any transaction
+        // which read state changed by an earlier one.
+        written.clear();
+        for (auto i = first; i < last; ++i)
+        {
+            auto& spec = specs[i - first];
+            detail::WriteSet to(&view, written);
+            if (spec.applied && ! spec.reads->conflicts(written) &&
+                ! detail::overlaps(*spec.view, written))
+            {
+                spec.view->apply(to);
+                results.push_back(spec.result);
+                continue;
+            }
+
+            ++reapplied;
+            try
+            {
+                OpenView serial(&view);
+                results.push_back(apply_one(app, serial,
+                    txs[i], retry, flags, j));
+                serial.apply(to);
+            }
+            catch (std::exception const&)
+            {
+                JLOG(j.error()) <<
+                    "Caught exception";
+                results.push_back(Result::failure);
+            }
+        }
+    }
+
+    JLOG(j.debug()) <<
+        "Applied " << txs.size() << " transactions with " <<
+        threads << " threads, " << reapplied << " applied again";
+    return results;
+}
+
 //------------------------------------------------------------------------------
 
 std::string
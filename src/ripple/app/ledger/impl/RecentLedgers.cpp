@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/RecentLedgers.h>
+#include <ripple/basics/Log.h>
+#include <ripple/protocol/Indexes.h>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+// Unique across instances, so a thread's cached snapshot
+// is never mistaken for that of another instance
+std::atomic<std::uint64_t> lastGeneration {0};
+
+// The hashes of the ledgers before a ledger, from its skip list. The
+// hash of the ledger diff sequences before it is at [size() - diff].
+std::vector<uint256>
+ancestors (Ledger const& ledger, beast::Journal j)
+{
+    try
+    {
+        if (auto const sle = ledger.read (keylet::skip()))
+            return sle->getFieldV256 (sfHashes).value();
+    }
+    catch (std::exception const& e)
+    {
+        JLOG (j.warn()) << "Can't read skip list of ledger " <<
+            ledger.info().seq << ": " << e.what();
+    }
+    return {};
+}
+
+bool
+isAncestor (Ledger const& validated, std::vector<uint256> const& hashes,
+    Ledger const& ledger)
+{
+    auto const& info = ledger.info();
+    if (info.seq == validated.info().seq)
+        return info.hash == validated.info().hash;
+    if (info.seq > validated.info().seq)
+        return false;
+
+    std::size_t const diff = validated.info().seq - info.seq;
+    if (diff == 1)
+        return info.hash == validated.info().parentHash;
+    return diff <= hashes.size() &&
+        hashes[hashes.size() - diff] == info.hash;
+}
+
+} // namespace
+
+std::size_t constexpr RecentLedgers::size;
+
+RecentLedgers::RecentLedgers (beast::Journal j)
+    : j_ (j)
+{
+    publish (std::make_shared<Snapshot> ());
+}
+
+void
+RecentLedgers::setValidated (std::shared_ptr<Ledger const> const& ledger)
+{
+    auto const hashes = ancestors (*ledger, j_);
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto next = std::make_shared<Snapshot> (*snapshot_);
+    next->validated = ledger;
+    for (auto& slot : next->ledgers)
+    {
+        auto const kept = slot.lock ();
+        if (! kept || ! isAncestor (*ledger, hashes, *kept))
+            slot.reset ();
+    }
+    place (*next, ledger);
+    publish (std::move (next));
+}
+
+void
+RecentLedgers::insert (std::shared_ptr<Ledger const> const& ledger)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const validated = snapshot_->validated.lock ();
+    if (! validated || ! isAncestor (
+            *validated, ancestors (*validated, j_), *ledger))
+        return;
+
+    auto const seq = ledger->info().seq;
+    if (snapshot_->ledgers[seq % size].lock () == ledger)
+        return;
+
+    auto next = std::make_shared<Snapshot> (*snapshot_);
+    place (*next, ledger);
+    publish (std::move (next));
+}
+
+std::shared_ptr<Ledger const>
+RecentLedgers::validated () const
+{
+    return current ().validated.lock ();
+}
+
+std::shared_ptr<Ledger const>
+RecentLedgers::get (LedgerIndex seq) const
+{
+    auto ledger = current ().ledgers[seq % size].lock ();
+    if (ledger && ledger->info().seq == seq)
+        return ledger;
+    return nullptr;
+}
+
+std::shared_ptr<Ledger const>
+RecentLedgers::get (LedgerHash const& hash) const
+{
+    auto const& snapshot = current ();
+    auto const iter = snapshot.seqs.find (hash);
+    if (iter == snapshot.seqs.end ())
+        return nullptr;
+
+    auto ledger = snapshot.ledgers[iter->second % size].lock ();
+    if (ledger && ledger->info().hash == hash)
+        return ledger;
+    return nullptr;
+}
+
+auto
+RecentLedgers::current () const -> Snapshot const&
+{
+    // The snapshot this thread read last. It stays valid until the
+    // thread reads a newer one.
+    struct Cache
+    {
+        std::uint64_t generation = 0;
+        std::shared_ptr<Snapshot const> snapshot;
+    };
+    thread_local Cache cache;
+
+    if (cache.generation != generation_.load (std::memory_order_acquire))
+    {
+        cache.snapshot = std::atomic_load (&snapshot_);
+        cache.generation = cache.snapshot->generation;
+    }
+    return *cache.snapshot;
+}
+
+void
+RecentLedgers::place (Snapshot& next,
+    std::shared_ptr<Ledger const> const& ledger)
+{
+    next.ledgers[ledger->info().seq % size] = ledger;
+
+    next.seqs.clear ();
+    for (auto const& slot : next.ledgers)
+    {
+        if (auto const kept = slot.lock ())
+            next.seqs.emplace (kept->info().hash, kept->info().seq);
+    }
+}
+
+void
+RecentLedgers::publish (std::shared_ptr<Snapshot> next)
+{
+    auto const generation = ++lastGeneration;
+    next->generation = generation;
+    std::atomic_store (&snapshot_,
+        std::shared_ptr<Snapshot const> (std::move (next)));
+    generation_.store (generation, std::memory_order_release);
+}
+
+} // ripple
@@ -25,6 +25,7 @@
 #include <ripple/app/main/Tuning.h>
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerSnapshot.h>
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/ledger/OpenLedger.h>
 #include <ripple/app/ledger/OrderBookDB.h>
@@ -774,6 +775,13 @@ public:
         mWalletDB = std::make_unique <DatabaseCon> (setup, "wallet.db",
                 WalletDBInit, WalletDBCount);
 
+        if (config_->ACCOUNT_TX_INDEX)
+        {
+            auto db = mTxnDB->checkoutDb ();
+            for (int i = 0; i < AccountTxIndexDBCount; ++i)
+                *db << AccountTxIndexDBInit[i];
+        }
+
         return
             mTxnDB.get () != nullptr &&
             mLedgerDB.get () != nullptr &&
@@ -1013,6 +1021,9 @@ bool ApplicationImp::setup()
     mTxnDB->setupCheckpointing (m_jobQueue.get(), logs());
     mLedgerDB->setupCheckpointing (m_jobQueue.get(), logs());
 
+    mTxnDB->setupReaders (config_->DATABASE_READERS, logs());
+    mLedgerDB->setupReaders (config_->DATABASE_READERS, logs());
+
     if (!updateTables ())
         return false;
 
@@ -1044,6 +1055,7 @@ bool ApplicationImp::setup()
     }
     else if (startUp == Config::LOAD ||
                 startUp == Config::LOAD_FILE ||
+                startUp == Config::LOAD_SNAPSHOT ||
                 startUp == Config::REPLAY)
     {
         JLOG(m_journal.info()) <<
@@ -1545,7 +1557,15 @@ bool ApplicationImp::loadOldLedger (
     {
         std::shared_ptr<Ledger const> loadLedger, replayLedger;
 
-        if (isFileName)
+        // Every node of a snapshot is checked as it is loaded
+        bool const snapshot = config_->START_UP == Config::LOAD_SNAPSHOT;
+
+        if (snapshot)
+        {
+            loadLedger = loadLedgerSnapshot (ledgerID, *this,
+                journal ("Ledger"));
+        }
+        else if (isFileName)
         {
             if (!ledgerID.empty())
                 loadLedger = loadLedgerFromFile (ledgerID);
@@ -1627,7 +1647,7 @@ bool ApplicationImp::loadOldLedger (
             return false;
         }
 
-        if (!loadLedger->walkLedger (journal ("Ledger")))
+        if (!snapshot && !loadLedger->walkLedger (journal ("Ledger")))
         {
             JLOG(m_journal.fatal()) << "Ledger is missing nodes.";
             assert(false);
@@ -68,6 +68,37 @@ const char* TxnDBInit[] =
 
 int TxnDBCount = std::extent<decltype(TxnDBInit)>::value;
 
+// Added to the transaction database when [account_tx_index] is set
+const char* AccountTxIndexDBInit[] =
+{
+    "BEGIN TRANSACTION;",
+
+    // Used instead of AccountTransactions
+    "CREATE TABLE IF NOT EXISTS AccountTxIndex (              \
+        Account     BLOB NOT NULL,              \
+        LedgerSeq   INTEGER NOT NULL,           \
+        TxnSeq      INTEGER NOT NULL,           \
+        Status      CHARACTER(1),               \
+        RawTxn      BLOB,                       \
+        TxnMeta     BLOB,                       \
+        PRIMARY KEY (Account, LedgerSeq, TxnSeq) \
+    ) WITHOUT ROWID;",
+    "CREATE INDEX IF NOT EXISTS AcctTxIndexLgr ON             \
+        AccountTxIndex(LedgerSeq);",
+
+    // The ledgers, Low to High, of which AccountTxIndex holds
+    // every transaction
+    "CREATE TABLE IF NOT EXISTS AccountTxIndexRanges (        \
+        Low         INTEGER PRIMARY KEY,        \
+        High        INTEGER NOT NULL            \
+    );",
+
+    "END TRANSACTION;"
+};
+
+int AccountTxIndexDBCount =
+    std::extent<decltype(AccountTxIndexDBInit)>::value;
+
 // Ledger database holds ledgers and ledger confirmations
 const char* LedgerDBInit[] =
 {
@@ -24,11 +24,13 @@ namespace ripple {
 
 // VFALCO TODO Tidy these up into a class with functions and return types.
 extern const char* TxnDBInit[];
+extern const char* AccountTxIndexDBInit[];
 extern const char* LedgerDBInit[];
 extern const char* WalletDBInit[];
 
 // VFALCO TODO Figure out what these counts are for
 extern int TxnDBCount;
+extern int AccountTxIndexDBCount;
 extern int LedgerDBCount;
 extern int WalletDBCount;
 
@@ -236,6 +236,7 @@ int run (int argc, char** argv)
     ("replay","Replay a ledger close.")
     ("ledger", po::value<std::string> (), "Load the specified ledger and start from .")
     ("ledgerfile", po::value<std::string> (), "Load the specified ledger file.")
+    ("snapshot", po::value<std::string> (), "Load the specified ledger snapshot file.")
     ("start", "Start from a fresh Ledger.")
     ("net", "Get the initial ledger from the network.")
     ("debug", "Enable normally suppressed debug logging")
@@ -328,6 +329,11 @@ int run (int argc, char** argv)
         config->START_LEDGER = vm["ledgerfile"].as<std::string> ();
         config->START_UP = Config::LOAD_FILE;
     }
+    else if (vm.count ("snapshot"))
+    {
+        config->START_LEDGER = vm["snapshot"].as<std::string> ();
+        config->START_UP = Config::LOAD_SNAPSHOT;
+    }
     else if (vm.count ("load"))
     {
         config->START_UP = Config::LOAD;
@@ -22,49 +22,61 @@
 
 namespace ripple {
 
+HashRouter::HashRouter (Stopwatch& clock,
+        std::chrono::seconds entryHoldTimeInSeconds)
+    : holdTime_ (entryHoldTimeInSeconds)
+{
+    for (auto& s : shards_)
+        s = std::make_unique<Shard> (clock);
+}
+
 auto
-HashRouter::emplace (uint256 const& key)
+HashRouter::Shard::emplace (uint256 const& key,
+        std::chrono::seconds holdTime)
     -> std::pair<Entry&, bool>
 {
-    auto iter = suppressionMap_.find (key);
+    auto iter = suppressionMap.find (key);
 
-    if (iter != suppressionMap_.end ())
+    if (iter != suppressionMap.end ())
     {
-        suppressionMap_.touch(iter);
+        suppressionMap.touch(iter);
         return std::make_pair(
             std::ref(iter->second), false);
     }
 
     // See if any supressions need to be expired
-    expire(suppressionMap_, holdTime_);
+    expire(suppressionMap, holdTime);
 
     return std::make_pair(std::ref(
-        suppressionMap_.emplace (
+        suppressionMap.emplace (
             key, Entry ()).first->second),
                 true);
 }
 
 void HashRouter::addSuppression (uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = shardFor (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    emplace (key);
+    shard.emplace (key, holdTime_);
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = shardFor (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto result = emplace(key);
+    auto result = shard.emplace(key, holdTime_);
     result.first.addPeer(peer);
     return result.second;
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer, int& flags)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = shardFor (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto result = emplace(key);
+    auto result = shard.emplace(key, holdTime_);
     auto& s = result.first;
     s.addPeer (peer);
     flags = s.getFlags ();
@@ -73,18 +85,20 @@ bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer, int&
 
 int HashRouter::getFlags (uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = shardFor (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    return emplace(key).first.getFlags ();
+    return shard.emplace(key, holdTime_).first.getFlags ();
 }
 
 bool HashRouter::setFlags (uint256 const& key, int flags)
 {
     assert (flags != 0);
 
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = shardFor (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = shard.emplace(key, holdTime_).first;
 
     if ((s.getFlags () & flags) == flags)
         return false;
@@ -97,11 +111,12 @@ auto
 HashRouter::shouldRelay (uint256 const& key)
     -> boost::optional<std::set<PeerShortID>>
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = shardFor (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = shard.emplace(key, holdTime_).first;
 
-    if (!s.shouldRelay(suppressionMap_.clock().now(), holdTime_))
+    if (!s.shouldRelay(shard.suppressionMap.clock().now(), holdTime_))
         return boost::none;
 
     return s.releasePeerSet();
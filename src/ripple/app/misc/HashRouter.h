@@ -26,6 +26,9 @@
 #include <ripple/basics/UnorderedContainers.h>
 #include <ripple/beast/container/aged_unordered_map.h>
 #include <boost/optional.hpp>
+#include <array>
+#include <memory>
+#include <mutex>
 
 namespace ripple {
 
@@ -123,11 +126,7 @@ public:
         return 300s;
     }
 
-    HashRouter (Stopwatch& clock, std::chrono::seconds entryHoldTimeInSeconds)
-        : suppressionMap_(clock)
-        , holdTime_ (entryHoldTimeInSeconds)
-    {
-    }
+    HashRouter (Stopwatch& clock, std::chrono::seconds entryHoldTimeInSeconds);
 
     HashRouter& operator= (HashRouter const&) = delete;
 
@@ -164,15 +163,41 @@ public:
     */
     boost::optional<std::set<PeerShortID>> shouldRelay(uint256 const& key);
 
+    /** The number of independently locked partitions of the table. */
+    static constexpr std::size_t shardCount = 16;
+
 private:
-    // pair.second indicates whether the entry was created
-    std::pair<Entry&, bool> emplace (uint256 const&);
+    /** A partition of the routing table.
+
+        Every message from every peer passes through the router, so
+        the table is split by hash and each part has its own lock.
+        Entries expire when an entry is inserted into the same shard.
+    */
+    struct Shard
+    {
+        explicit Shard (Stopwatch& clock)
+            : suppressionMap (clock)
+        {
+        }
+
+        // pair.second indicates whether the entry was created
+        std::pair<Entry&, bool> emplace (uint256 const&,
+            std::chrono::seconds holdTime);
 
-    std::mutex mutable mutex_;
+        std::mutex mutex;
+
+        // Stores suppressed hashes and their expiration time
+        beast::aged_unordered_map<uint256, Entry, Stopwatch::clock_type,
+            hardened_hash<strong_hash>> suppressionMap;
+    };
+
+    // The keys are hashes, so any byte selects a shard uniformly
+    Shard& shardFor (uint256 const& key)
+    {
+        return *shards_[*key.begin () % shardCount];
+    }
 
-    // Stores all suppressed hashes and their expiration time
-    beast::aged_unordered_map<uint256, Entry, Stopwatch::clock_type,
-        hardened_hash<strong_hash>> suppressionMap_;
+    std::array<std::unique_ptr<Shard>, shardCount> shards_;
 
     std::chrono::seconds const holdTime_;
 };
@@ -481,6 +481,17 @@ public:
     //
     // Stoppable.
 
+    void onStart () override
+    {
+        if (app_.config().ACCOUNT_TX_INDEX)
+        {
+            accountTxIndex_ = std::make_unique<AccountTxIndexImport> (
+                app_.getTxnDB (), m_journal);
+            if (accountTxIndex_->start ())
+                importAccountTxIndex ();
+        }
+    }
+
     void onStop () override
     {
         mAcquiringLedger.reset();
@@ -495,6 +506,7 @@ public:
 
 private:
     void setHeartbeatTimer ();
+    void importAccountTxIndex ();
     void setClusterTimer ();
     void onDeadlineTimer (DeadlineTimer& timer) override;
     void processHeartbeatTimer ();
@@ -543,6 +555,9 @@ private:
     DeadlineTimer m_clusterTimer;
     JobCounter jobCounter_;
 
+    // Copies history into the account transaction index, if enabled
+    std::unique_ptr<AccountTxIndexImport> accountTxIndex_;
+
     std::shared_ptr<RCLConsensus> mConsensus;
 
     LedgerMaster& m_ledgerMaster;
@@ -663,6 +678,18 @@ void NetworkOPsImp::onDeadlineTimer (DeadlineTimer& timer)
     }
 }
 
+void NetworkOPsImp::importAccountTxIndex ()
+{
+    // One batch per job, so the import gives way to other work
+    m_job_queue.addCountedJob (
+        jtHISTORY, "AccountTxIndex", jobCounter_,
+        [this] (Job&)
+        {
+            if (accountTxIndex_->step ())
+                importAccountTxIndex ();
+        });
+}
+
 void NetworkOPsImp::processHeartbeatTimer ()
 {
     {
@@ -1937,7 +1964,7 @@ NetworkOPs::AccountTxs NetworkOPsImp::getAccountTxs (
         bUnlimited);
 
     {
-        auto db = app_.getTxnDB ().checkoutDb ();
+        auto db = app_.getTxnDB ().checkoutRead ();
 
         boost::optional<std::uint64_t> ledgerSeq;
         boost::optional<std::string> status;
@@ -2005,7 +2032,7 @@ std::vector<NetworkOPsImp::txnMetaLedgerType> NetworkOPsImp::getAccountTxsB (
         bUnlimited);
 
     {
-        auto db = app_.getTxnDB ().checkoutDb ();
+        auto db = app_.getTxnDB ().checkoutRead ();
 
         boost::optional<std::uint64_t> ledgerSeq;
         boost::optional<std::string> status;
@@ -2061,11 +2088,18 @@ NetworkOPsImp::getTxsAccount (
             ret, ledger_index, status, rawTxn, rawMeta, app);
     };
 
-    accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
-        std::bind(saveLedgerAsync, std::ref(app_),
-            std::placeholders::_1), bound, account, minLedger,
-                maxLedger, forward, token, limit, bUnlimited,
-                    page_length);
+    if (accountTxIndex_ && accountTxIndex_->complete ())
+        accountTxIndexPage(app_.getTxnDB (),
+            std::bind(saveLedgerAsync, std::ref(app_),
+                std::placeholders::_1), bound, account, minLedger,
+                    maxLedger, forward, token, limit, bUnlimited,
+                        page_length);
+    else
+        accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
+            std::bind(saveLedgerAsync, std::ref(app_),
+                std::placeholders::_1), bound, account, minLedger,
+                    maxLedger, forward, token, limit, bUnlimited,
+                        page_length);
 
     return ret;
 }
@@ -2089,11 +2123,18 @@ NetworkOPsImp::getTxsAccountB (
         ret.emplace_back (strHex(rawTxn), strHex (rawMeta), ledgerIndex);
     };
 
-    accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
-        std::bind(saveLedgerAsync, std::ref(app_),
-            std::placeholders::_1), bound, account, minLedger,
-                maxLedger, forward, token, limit, bUnlimited,
-                    page_length);
+    if (accountTxIndex_ && accountTxIndex_->complete ())
+        accountTxIndexPage(app_.getTxnDB (),
+            std::bind(saveLedgerAsync, std::ref(app_),
+                std::placeholders::_1), bound, account, minLedger,
+                    maxLedger, forward, token, limit, bUnlimited,
+                        page_length);
+    else
+        accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
+            std::bind(saveLedgerAsync, std::ref(app_),
+                std::placeholders::_1), bound, account, minLedger,
+                    maxLedger, forward, token, limit, bUnlimited,
+                        page_length);
     return ret;
 }
 
@@ -2161,6 +2202,9 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     if (fp != 0)
         info[jss::fetch_pack] = Json::UInt (fp);
 
+    if (admin && accountTxIndex_)
+        info[jss::account_tx_index] = accountTxIndex_->getJson ();
+
     info[jss::peers] = Json::UInt (app_.overlay ().size ());
 
     Json::Value lastClose = Json::objectValue;
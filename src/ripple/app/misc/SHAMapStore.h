@@ -48,6 +48,7 @@ public:
         std::uint32_t deleteBatch = 100;
         std::uint32_t backOff = 100;
         std::int32_t ageThreshold = 60;
+        std::string snapshotPath;
     };
 
     SHAMapStore (Stoppable& parent) : Stoppable ("SHAMapStore", parent) {}
@@ -75,6 +76,19 @@ public:
     /** Highest ledger that may be deleted. */
     virtual LedgerIndex getCanDelete() = 0;
 
+    /** The file ledger snapshots are written to, or empty if none. */
+    virtual std::string const& snapshotPath() const = 0;
+
+    /** Write a snapshot of a ledger to snapshotPath() in the background.
+
+        @return `false` if a snapshot requested this way is still queued
+                or being written.
+    */
+    virtual bool writeSnapshot (std::shared_ptr<Ledger const> const& ledger) = 0;
+
+    /** The state of the latest snapshot. */
+    virtual Json::Value getSnapshotJson() = 0;
+
     /** The number of files that are needed. */
     virtual int fdlimit() const = 0;
 };
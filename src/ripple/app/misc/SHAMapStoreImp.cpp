@@ -20,9 +20,12 @@
 #include <BeastConfig.h>
 
 #include <ripple/app/misc/SHAMapStoreImp.h>
+#include <ripple/app/ledger/LedgerSnapshot.h>
 #include <ripple/app/ledger/TransactionMaster.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/core/ConfigSections.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/protocol/JsonFields.h>
 #include <ripple/beast/core/CurrentThreadName.h>
 
 namespace ripple {
@@ -432,10 +435,86 @@ SHAMapStoreImp::run()
             JLOG(journal_.debug()) << "finished rotation " << validatedSeq;
 
             oldBackend->setDeletePath();
+
+            if (! setup_.snapshotPath.empty())
+                snapshot (*validatedLedger);
         }
     }
 }
 
+void
+SHAMapStoreImp::snapshot (Ledger const& ledger)
+{
+    {
+        std::lock_guard<std::mutex> lock (snapshotMutex_);
+        snapshotStatus_ = Json::objectValue;
+        snapshotStatus_[jss::ledger_index] = ledger.info().seq;
+        snapshotStatus_[jss::ledger_hash] = to_string (ledger.info().hash);
+        snapshotStatus_[jss::state] = "writing";
+    }
+
+    try
+    {
+        auto const nodes = writeLedgerSnapshot (ledger, setup_.snapshotPath);
+        JLOG(journal_.info()) << "wrote snapshot of ledger "
+                << ledger.info().seq << " nodecount " << nodes;
+
+        std::lock_guard<std::mutex> lock (snapshotMutex_);
+        snapshotStatus_[jss::state] = "written";
+        snapshotStatus_[jss::nodes] = static_cast<Json::UInt> (nodes);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(journal_.warn()) << "can't write snapshot of ledger "
+                << ledger.info().seq << ": " << e.what();
+
+        std::lock_guard<std::mutex> lock (snapshotMutex_);
+        snapshotStatus_[jss::state] = "failed";
+        snapshotStatus_[jss::error_message] = e.what();
+    }
+}
+
+bool
+SHAMapStoreImp::writeSnapshot (std::shared_ptr<Ledger const> const& ledger)
+{
+    {
+        std::lock_guard<std::mutex> lock (snapshotMutex_);
+        if (snapshotQueued_)
+            return false;
+        snapshotQueued_ = true;
+        snapshotStatus_ = Json::objectValue;
+        snapshotStatus_[jss::ledger_index] = ledger->info().seq;
+        snapshotStatus_[jss::ledger_hash] = to_string (ledger->info().hash);
+        snapshotStatus_[jss::state] = "queued";
+    }
+
+    auto const queued = app_.getJobQueue().addCountedJob (
+        jtHISTORY, "LedgerSnapshot", jobCounter_,
+        [this, ledger] (Job&)
+        {
+            snapshot (*ledger);
+            std::lock_guard<std::mutex> lock (snapshotMutex_);
+            snapshotQueued_ = false;
+        });
+
+    if (! queued)
+    {
+        std::lock_guard<std::mutex> lock (snapshotMutex_);
+        snapshotQueued_ = false;
+        snapshotStatus_ = Json::Value();
+    }
+    return queued;
+}
+
+Json::Value
+SHAMapStoreImp::getSnapshotJson()
+{
+    std::lock_guard<std::mutex> lock (snapshotMutex_);
+    if (snapshotStatus_.isNull())
+        return Json::objectValue;
+    return snapshotStatus_;
+}
+
 void
 SHAMapStoreImp::dbPaths()
 {
@@ -730,6 +809,15 @@ SHAMapStoreImp::clearPrior (LedgerIndex lastRotated)
         "DELETE FROM AccountTransactions WHERE LedgerSeq < %u;");
     if (health())
         return;
+
+    if (app_.config().ACCOUNT_TX_INDEX)
+    {
+        clearSql (*transactionDb_, lastRotated,
+            "SELECT MIN(LedgerSeq) FROM AccountTxIndex;",
+            "DELETE FROM AccountTxIndex WHERE LedgerSeq < %u;");
+        if (health())
+            return;
+    }
 }
 
 SHAMapStoreImp::Health
@@ -763,6 +851,9 @@ SHAMapStoreImp::health()
 void
 SHAMapStoreImp::onStop()
 {
+    // Wait for a snapshot being written
+    jobCounter_.join();
+
     if (setup_.deleteInterval)
     {
         {
@@ -824,6 +915,7 @@ setup_SHAMapStore (Config const& c)
     get_if_exists (setup.nodeDatabase, "delete_batch", setup.deleteBatch);
     get_if_exists (setup.nodeDatabase, "backOff", setup.backOff);
     get_if_exists (setup.nodeDatabase, "age_threshold", setup.ageThreshold);
+    get_if_exists (setup.nodeDatabase, "snapshot_path", setup.snapshotPath);
 
     return setup;
 }
@@ -23,6 +23,7 @@
 #include <ripple/app/misc/SHAMapStore.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/core/DatabaseCon.h>
+#include <ripple/core/JobCounter.h>
 #include <ripple/nodestore/DatabaseRotating.h>
 #include <condition_variable>
 #include <thread>
@@ -109,6 +110,12 @@ private:
     DatabaseCon* ledgerDb_ = nullptr;
     int fdlimit_ = 0;
 
+    // Snapshots requested by RPC are written by a job
+    JobCounter jobCounter_;
+    std::mutex snapshotMutex_;
+    bool snapshotQueued_ = false;
+    Json::Value snapshotStatus_;
+
 public:
     SHAMapStoreImp (Application& app,
             Setup const& setup,
@@ -166,6 +173,16 @@ public:
         return canDelete_;
     }
 
+    std::string const&
+    snapshotPath() const override
+    {
+        return setup_.snapshotPath;
+    }
+
+    bool writeSnapshot (std::shared_ptr<Ledger const> const& ledger) override;
+
+    Json::Value getSnapshotJson() override;
+
     void onLedgerClosed (std::shared_ptr<Ledger const> const& ledger) override;
 
     void rendezvous() const override;
@@ -222,6 +239,7 @@ private:
     void clearCaches (LedgerIndex validatedSeq);
     void freshenCaches();
     void clearPrior (LedgerIndex lastRotated);
+    void snapshot (Ledger const& ledger);
 
     // If rippled is not healthy, defer rotate-delete.
     // If already unhealthy, do not change state on further check.
@@ -21,11 +21,14 @@
 #define RIPPLE_TXQ_H_INCLUDED
 
 #include <ripple/app/tx/applySteps.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/ledger/OpenView.h>
 #include <ripple/ledger/ApplyView.h>
 #include <ripple/protocol/TER.h>
 #include <ripple/protocol/STTx.h>
 #include <boost/intrusive/set.hpp>
+#include <memory>
+#include <mutex>
 
 namespace ripple {
 
@@ -189,18 +192,25 @@ private:
         std::size_t const targetTxnCount_;
         // Maximum value of txnsExpected
         boost::optional<std::size_t> const maximumTxnCount_;
-        // Number of transactions expected per ledger.
-        // One more than this value will be accepted
-        // before escalation kicks in.
-        std::size_t txnsExpected_;
         // Minimum value of escalationMultiplier.
         std::uint64_t const minimumMultiplier_;
-        // Based on the median fee of the LCL. Used
-        // when fee escalation kicks in.
-        std::uint64_t escalationMultiplier_;
         beast::Journal j_;
 
-        std::mutex mutable lock_;
+    public:
+        /** The values used to escalate fees. A new snapshot is
+            published after each ledger, so readers never wait
+            on a lock.
+        */
+        struct Snapshot
+        {
+            // Number of transactions expected per ledger.
+            std::size_t txnsExpected;
+            // Based on the median fee of the LCL.
+            std::uint64_t escalationMultiplier;
+        };
+
+    private:
+        std::shared_ptr<Snapshot const> snapshot_;
 
     public:
         FeeMetrics(Setup const& setup, beast::Journal j)
@@ -213,10 +223,10 @@ private:
                 *setup.maximumTxnInLedger < targetTxnCount_ ?
                     targetTxnCount_ : *setup.maximumTxnInLedger :
                         boost::optional<std::size_t>(boost::none))
-            , txnsExpected_(minimumTxnCount_)
             , minimumMultiplier_(setup.minimumEscalationMultiplier)
-            , escalationMultiplier_(minimumMultiplier_)
             , j_(j)
+            , snapshot_(std::make_shared<Snapshot const>(
+                Snapshot{ minimumTxnCount_, minimumMultiplier_ }))
         {
         }
 
@@ -233,24 +243,34 @@ private:
             ReadView const& view, bool timeLeap,
             TxQ::Setup const& setup);
 
+        Snapshot
+        getSnapshot() const
+        {
+            return *std::atomic_load(&snapshot_);
+        }
+
         std::size_t
         getTxnsExpected() const
         {
-            std::lock_guard <std::mutex> sl(lock_);
-
-            return txnsExpected_;
+            return getSnapshot().txnsExpected;
         }
 
         std::uint64_t
         getEscalationMultiplier() const
         {
-            std::lock_guard <std::mutex> sl(lock_);
+            return getSnapshot().escalationMultiplier;
+        }
 
-            return escalationMultiplier_;
+        std::uint64_t
+        scaleFeeLevel(OpenView const& view, std::uint32_t txCountPadding = 0) const
+        {
+            return scaleFeeLevel(getSnapshot(), view, txCountPadding);
         }
 
+        static
         std::uint64_t
-        scaleFeeLevel(OpenView const& view, std::uint32_t txCountPadding = 0) const;
+        scaleFeeLevel(Snapshot const& snapshot, OpenView const& view,
+            std::uint32_t txCountPadding = 0);
 
         /**
             Returns the total fee level for all transactions in a series.
@@ -380,7 +400,22 @@ private:
         < MaybeTx, FeeHook,
         boost::intrusive::compare <GreaterFee> >;
 
-    using AccountMap = std::map <AccountID, TxQAccount>;
+    using AccountMap = hardened_hash_map <AccountID, TxQAccount>;
+
+    /* The queue statistics reported by getMetrics, published
+        whenever the queue changes so the RPC "fee" command can
+        read them without waiting for mutex_.
+    */
+    struct QueueSnapshot
+    {
+        std::size_t txCount;
+        boost::optional<std::size_t> maxSize;
+        std::uint64_t minFeeLevel;
+    };
+
+    // Number of queued transactions accept() attempts
+    // before releasing mutex_ to let readers in.
+    static constexpr std::size_t acceptBatchSize = 64;
 
     Setup const setup_;
     beast::Journal j_;
@@ -389,12 +424,20 @@ private:
     FeeMultiSet byFee_;
     AccountMap byAccount_;
     boost::optional<size_t> maxSize_;
+    std::shared_ptr<QueueSnapshot const> queueSnapshot_;
 
     // Most queue operations are done under the master lock,
-    // but use this mutex for the RPC "fee" command, which isn't.
+    // but use this mutex for the RPC queries, which aren't.
     std::mutex mutable mutex_;
+    // Held, before mutex_, by everything that changes the queue,
+    // so accept() can release mutex_ between batches.
+    std::mutex writeMutex_;
 
 private:
+    // Must be called with mutex_ held after changing the queue
+    void
+    publish();
+
     template<size_t fillPercentage = 100>
     bool
     isFull() const;
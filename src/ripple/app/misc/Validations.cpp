@@ -466,11 +466,6 @@ private:
     {
         auto event = app_.getJobQueue ().getLoadEventAP (jtDISK, "ValidationWrite");
 
-        std::string insVal ("INSERT INTO Validations "
-            "(InitialSeq, LedgerSeq, LedgerHash,NodePubKey,SignTime,RawData) "
-            "VALUES (:initialSeq, :ledgerSeq, :ledgerHash,:nodePubKey,:signTime,:rawData);");
-        std::string findSeq("SELECT LedgerSeq FROM Ledgers WHERE Ledgerhash=:ledgerHash;");
-
         ScopedLockType sl (mLock);
         assert (mWriting);
 
@@ -482,47 +477,18 @@ private:
 
             {
                 ScopedUnlockType sul (mLock);
-                {
-                    auto db = app_.getLedgerDB ().checkoutDb ();
-
-                    Serializer s (1024);
-                    soci::transaction tr(*db);
-                    for (auto it: vector)
-                    {
-                        s.erase ();
-                        it->add (s);
-
-                        auto const ledgerHash = to_string(it->getLedgerHash());
-
-                        boost::optional<std::uint64_t> ledgerSeq;
-                        *db << findSeq, soci::use(ledgerHash),
-                            soci::into(ledgerSeq);
-
-                        auto const initialSeq = ledgerSeq.value_or(
-                            app_.getLedgerMaster().getCurrentLedgerIndex());
-                        auto const nodePubKey = toBase58(
-                            TokenType::TOKEN_NODE_PUBLIC,
-                            it->getSignerPublic());
-                        auto const signTime =
-                            it->getSignTime().time_since_epoch().count();
-
-                        soci::blob rawData(*db);
-                        rawData.append(reinterpret_cast<const char*>(
-                            s.peekData().data()), s.peekData().size());
-                        assert(rawData.get_len() == s.peekData().size());
-
-                        *db <<
-                            insVal,
-                            soci::use(initialSeq),
-                            soci::use(ledgerSeq),
-                            soci::use(ledgerHash),
-                            soci::use(nodePubKey),
-                            soci::use(signTime),
-                            soci::use(rawData);
-                    }
 
-                    tr.commit ();
-                }
+                auto const start = std::chrono::steady_clock::now ();
+                auto const rows = saveValidations (app_.getLedgerDB (),
+                    vector, app_.getLedgerMaster ().getCurrentLedgerIndex (),
+                    app_.config ().SAVE_UNTRUSTED_VALIDATIONS);
+                auto const elapsed = std::chrono::duration<double> (
+                    std::chrono::steady_clock::now () - start).count ();
+
+                JLOG (j_.debug()) <<
+                    "Wrote " << rows << " of " << vector.size () <<
+                    " validations in " << elapsed * 1000 << "ms, " <<
+                    (elapsed > 0 ? rows / elapsed : 0) << " rows/s";
             }
         }
 
@@ -536,6 +502,79 @@ private:
     }
 };
 
+std::size_t
+saveValidations (DatabaseCon& ledgerDB,
+    std::vector<STValidation::pointer> const& validations,
+    LedgerIndex currentSeq, bool saveUntrusted)
+{
+    std::uint64_t initialSeq = 0;
+    boost::optional<std::uint64_t> ledgerSeq;
+    std::string ledgerHash;
+    std::string nodePubKey;
+    std::uint64_t signTime = 0;
+
+    // Many validations are for the same ledger, so each
+    // ledger's sequence is only looked up once
+    hash_map<uint256, boost::optional<std::uint64_t>> seqs;
+
+    auto db = ledgerDB.checkoutDb ();
+    soci::blob rawData (*db);
+
+    soci::statement findSeq = (db->prepare <<
+        "SELECT LedgerSeq FROM Ledgers WHERE LedgerHash = :ledgerHash;",
+        soci::use (ledgerHash), soci::into (ledgerSeq));
+
+    soci::statement insert = (db->prepare <<
+        "INSERT INTO Validations "
+        "(InitialSeq, LedgerSeq, LedgerHash, NodePubKey, SignTime, RawData) "
+        "VALUES (:initialSeq, :ledgerSeq, :ledgerHash, :nodePubKey, "
+        ":signTime, :rawData);",
+        soci::use (initialSeq), soci::use (ledgerSeq),
+        soci::use (ledgerHash), soci::use (nodePubKey),
+        soci::use (signTime), soci::use (rawData));
+
+    std::size_t rows = 0;
+    Serializer s (1024);
+    soci::transaction tr (*db);
+    for (auto const& val : validations)
+    {
+        if (! saveUntrusted && ! val->isTrusted ())
+            continue;
+
+        s.erase ();
+        val->add (s);
+
+        ledgerHash = to_string (val->getLedgerHash ());
+        auto const iter = seqs.find (val->getLedgerHash ());
+        if (iter == seqs.end ())
+        {
+            ledgerSeq = boost::none;
+            findSeq.execute (true);
+            seqs.emplace (val->getLedgerHash (), ledgerSeq);
+        }
+        else
+        {
+            ledgerSeq = iter->second;
+        }
+
+        initialSeq = ledgerSeq.value_or (currentSeq);
+        nodePubKey = toBase58 (
+            TokenType::TOKEN_NODE_PUBLIC, val->getSignerPublic ());
+        signTime = val->getSignTime ().time_since_epoch ().count ();
+
+        rawData.trim (0);
+        rawData.append (reinterpret_cast<char const*>(
+            s.peekData ().data ()), s.peekData ().size ());
+        assert (rawData.get_len () == s.peekData ().size ());
+
+        insert.execute (true);
+        ++rows;
+    }
+    tr.commit ();
+
+    return rows;
+}
+
 std::unique_ptr <Validations> make_Validations (Application& app)
 {
     return std::make_unique <ValidationsImp> (app);
@@ -80,6 +80,22 @@ extern
 std::unique_ptr<Validations>
 make_Validations(Application& app);
 
+/** Write validations to the Validations table of the ledger database.
+
+    The rows are written in a single transaction using prepared
+    statements.
+
+    @param currentSeq The initial sequence recorded for validations of
+                      ledgers which are not in the database.
+    @param saveUntrusted Whether to write validations from validators
+                         which are not trusted.
+    @return The number of rows written.
+*/
+std::size_t
+saveValidations (DatabaseCon& ledgerDB,
+    std::vector<STValidation::pointer> const& validations,
+    LedgerIndex currentSeq, bool saveUntrusted);
+
 } // ripple
 
 #endif
@@ -18,14 +18,20 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/Transaction.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
+#include <ripple/basics/Log.h>
+#include <ripple/protocol/JsonFields.h>
 #include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/STTx.h>
 #include <ripple/protocol/types.h>
 #include <boost/format.hpp>
+#include <algorithm>
+#include <limits>
 #include <memory>
 
 namespace ripple {
@@ -61,59 +67,140 @@ saveLedgerAsync (Application& app, std::uint32_t seq)
         pendSaveValidated(app, l, false, false);
 }
 
-void
-accountTxPage (
-    DatabaseCon& connection,
-    AccountIDCache const& idCache,
-    std::function<void (std::uint32_t)> const& onUnsavedLedger,
-    std::function<void (std::uint32_t,
-                        std::string const&,
-                        Blob const&,
-                        Blob const&)> const& onTransaction,
-    AccountID const& account,
-    std::int32_t minLedger,
-    std::int32_t maxLedger,
-    bool forward,
+namespace {
+
+// Paging state shared by both account transaction tables
+struct AccountTxPageState
+{
+    bool lookingForMarker = false;
+    std::uint32_t numberOfResults = 0;
+    std::uint32_t queryLimit = 0;
+    std::uint32_t findLedger = 0;
+    std::uint32_t findSeq = 0;
+};
+
+// Returns false if the marker in the token is malformed
+bool
+startAccountTxPage (
+    AccountTxPageState& state,
     Json::Value& token,
     int limit,
     bool bAdmin,
     std::uint32_t page_length)
 {
-    bool lookingForMarker =  !token.isNull() && token.isObject();
-
-    std::uint32_t numberOfResults;
+    state.lookingForMarker = !token.isNull() && token.isObject();
 
     if (limit <= 0 || (limit > page_length && !bAdmin))
-        numberOfResults = page_length;
+        state.numberOfResults = page_length;
     else
-        numberOfResults = limit;
+        state.numberOfResults = limit;
 
     // As an account can have many thousands of transactions, there is a limit
     // placed on the amount of transactions returned. If the limit is reached
     // before the result set has been exhausted (we always query for one more
     // than the limit), then we return an opaque marker that can be supplied in
     // a subsequent query.
-    std::uint32_t queryLimit = numberOfResults + 1;
-    std::uint32_t findLedger = 0, findSeq = 0;
+    state.queryLimit = state.numberOfResults + 1;
 
-    if (lookingForMarker)
+    if (state.lookingForMarker)
     {
         try
         {
             if (!token.isMember(jss::ledger) || !token.isMember(jss::seq))
-                return;
-            findLedger = token[jss::ledger].asInt();
-            findSeq = token[jss::seq].asInt();
+                return false;
+            state.findLedger = token[jss::ledger].asInt();
+            state.findSeq = token[jss::seq].asInt();
         }
         catch (std::exception const&)
         {
-            return;
+            return false;
         }
     }
 
     // We're using the token reference both for passing inputs and outputs, so
     // we need to clear it in between.
     token = Json::nullValue;
+    return true;
+}
+
+// Returns false once the page is full
+bool
+addAccountTxRow (
+    AccountTxPageState& state,
+    Json::Value& token,
+    std::function<void (std::uint32_t)> const& onUnsavedLedger,
+    std::function<void (std::uint32_t,
+                        std::string const&,
+                        Blob const&,
+                        Blob const&)> const& onTransaction,
+    std::uint64_t ledgerSeq,
+    std::uint32_t txnSeq,
+    std::string const& status,
+    Blob const& rawData,
+    Blob const& rawMeta)
+{
+    if (state.lookingForMarker)
+    {
+        if (state.findLedger == ledgerSeq && state.findSeq == txnSeq)
+            state.lookingForMarker = false;
+    }
+    else if (state.numberOfResults == 0)
+    {
+        token = Json::objectValue;
+        token[jss::ledger] = rangeCheckedCast<std::uint32_t>(ledgerSeq);
+        token[jss::seq] = txnSeq;
+        return false;
+    }
+
+    if (!state.lookingForMarker)
+    {
+        // Work around a bug that could leave the metadata missing
+        if (rawMeta.size() == 0)
+            onUnsavedLedger(ledgerSeq);
+
+        onTransaction(rangeCheckedCast<std::uint32_t>(ledgerSeq),
+            status, rawData, rawMeta);
+        --state.numberOfResults;
+    }
+    return true;
+}
+
+// soci reuses the buffer of a bound blob, replace its contents
+void
+assign (soci::blob& to, void const* data, std::size_t size)
+{
+    to.trim (0);
+    if (size != 0)
+        to.append (static_cast<char const*>(data), size);
+}
+
+}
+
+void
+accountTxPage (
+    DatabaseCon& connection,
+    AccountIDCache const& idCache,
+    std::function<void (std::uint32_t)> const& onUnsavedLedger,
+    std::function<void (std::uint32_t,
+                        std::string const&,
+                        Blob const&,
+                        Blob const&)> const& onTransaction,
+    AccountID const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool forward,
+    Json::Value& token,
+    int limit,
+    bool bAdmin,
+    std::uint32_t page_length)
+{
+    AccountTxPageState state;
+    if (! startAccountTxPage (state, token, limit, bAdmin, page_length))
+        return;
+
+    auto const queryLimit = state.queryLimit;
+    auto const findLedger = state.findLedger;
+    auto const findSeq = state.findSeq;
 
     static std::string const prefix (
         R"(SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,
@@ -197,7 +284,7 @@ accountTxPage (
     }
 
     {
-        auto db (connection.checkoutDb());
+        auto db (connection.checkoutRead());
 
         Blob rawData;
         Blob rawMeta;
@@ -220,46 +307,434 @@ accountTxPage (
 
         while (st.fetch ())
         {
-            if (lookingForMarker)
-            {
-                if (findLedger == ledgerSeq.value_or (0) &&
-                    findSeq == txnSeq.value_or (0))
-                {
-                    lookingForMarker = false;
-                }
-            }
-            else if (numberOfResults == 0)
-            {
-                token = Json::objectValue;
-                token[jss::ledger] = rangeCheckedCast<std::uint32_t>(ledgerSeq.value_or (0));
-                token[jss::seq] = txnSeq.value_or (0);
+            if (dataPresent == soci::i_ok)
+                convert (txnData, rawData);
+            else
+                rawData.clear ();
+
+            if (metaPresent == soci::i_ok)
+                convert (txnMeta, rawMeta);
+            else
+                rawMeta.clear ();
+
+            if (! addAccountTxRow (state, token, onUnsavedLedger,
+                    onTransaction, ledgerSeq.value_or (0),
+                        txnSeq.value_or (0), *status, rawData, rawMeta))
                 break;
-            }
+        }
+    }
+
+    return;
+}
+
+void
+accountTxIndexPage (
+    DatabaseCon& connection,
+    std::function<void (std::uint32_t)> const& onUnsavedLedger,
+    std::function<void (std::uint32_t,
+                        std::string const&,
+                        Blob const&,
+                        Blob const&)> const& onTransaction,
+    AccountID const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool forward,
+    Json::Value& token,
+    int limit,
+    bool bAdmin,
+    std::uint32_t page_length)
+{
+    AccountTxPageState state;
+    if (! startAccountTxPage (state, token, limit, bAdmin, page_length))
+        return;
+
+    // The rows are ordered by the primary key, so a page is a single
+    // range scan starting at the marker, or at the end of the range.
+    static std::string const forwardSql (
+        R"(SELECT LedgerSeq,TxnSeq,Status,RawTxn,TxnMeta
+           FROM AccountTxIndex
+           WHERE Account = :account AND
+             LedgerSeq BETWEEN :minLedger AND :maxLedger AND
+             (LedgerSeq > :findLedger OR TxnSeq >= :findSeq)
+           ORDER BY LedgerSeq ASC, TxnSeq ASC
+           LIMIT :limit;)");
+
+    static std::string const backwardSql (
+        R"(SELECT LedgerSeq,TxnSeq,Status,RawTxn,TxnMeta
+           FROM AccountTxIndex
+           WHERE Account = :account AND
+             LedgerSeq BETWEEN :minLedger AND :maxLedger AND
+             (LedgerSeq < :findLedger OR TxnSeq <= :findSeq)
+           ORDER BY LedgerSeq DESC, TxnSeq DESC
+           LIMIT :limit;)");
+
+    std::int64_t lower = minLedger;
+    std::int64_t upper = maxLedger;
+    std::int64_t findLedger = state.findLedger;
+    std::int64_t findSeq = state.findSeq;
+    std::int64_t const queryLimit = state.queryLimit;
+
+    if (state.lookingForMarker)
+    {
+        if (forward)
+            lower = findLedger;
+        else
+            upper = findLedger;
+    }
+    else if (forward)
+    {
+        findLedger = 0;
+        findSeq = 0;
+    }
+    else
+    {
+        findLedger = upper;
+        findSeq = std::numeric_limits<std::uint32_t>::max();
+    }
+
+    {
+        auto db (connection.checkoutRead());
+
+        soci::blob accountBlob (*db);
+        assign (accountBlob, account.data(), account.size());
+
+        Blob rawData;
+        Blob rawMeta;
+
+        boost::optional<std::uint64_t> ledgerSeq;
+        boost::optional<std::uint32_t> txnSeq;
+        boost::optional<std::string> status;
+        soci::blob txnData (*db);
+        soci::blob txnMeta (*db);
+        soci::indicator dataPresent, metaPresent;
+
+        soci::statement st = (db->prepare <<
+            (forward ? forwardSql : backwardSql),
+            soci::use (accountBlob),
+            soci::use (lower),
+            soci::use (upper),
+            soci::use (findLedger),
+            soci::use (findSeq),
+            soci::use (queryLimit),
+            soci::into (ledgerSeq),
+            soci::into (txnSeq),
+            soci::into (status),
+            soci::into (txnData, dataPresent),
+            soci::into (txnMeta, metaPresent));
+
+        st.execute ();
+
+        while (st.fetch ())
+        {
+            if (dataPresent == soci::i_ok)
+                convert (txnData, rawData);
+            else
+                rawData.clear ();
+
+            if (metaPresent == soci::i_ok)
+                convert (txnMeta, rawMeta);
+            else
+                rawMeta.clear ();
+
+            if (! addAccountTxRow (state, token, onUnsavedLedger,
+                    onTransaction, ledgerSeq.value_or (0),
+                        txnSeq.value_or (0), *status, rawData, rawMeta))
+                break;
+        }
+    }
+}
+
+void
+saveAccountTxIndex (
+    soci::session& session,
+    std::uint32_t seq,
+    AcceptedLedger const& ledger)
+{
+    std::int64_t const ledgerSeq = seq;
+    session << "DELETE FROM AccountTxIndex WHERE LedgerSeq = :seq;",
+        soci::use (ledgerSeq);
+
+    std::int64_t txnSeq = 0;
+    std::string const status (1, TXN_SQL_VALIDATED);
+    soci::blob account (session);
+    soci::blob rawTxn (session);
+    soci::blob rawMeta (session);
+
+    soci::statement st = (session.prepare <<
+        R"(INSERT OR REPLACE INTO AccountTxIndex
+           (Account, LedgerSeq, TxnSeq, Status, RawTxn, TxnMeta)
+           VALUES (:account, :ledgerSeq, :txnSeq, :status, :rawTxn, :rawMeta);)",
+        soci::use (account),
+        soci::use (ledgerSeq),
+        soci::use (txnSeq),
+        soci::use (status),
+        soci::use (rawTxn),
+        soci::use (rawMeta));
+
+    Serializer s;
+    for (auto const& vt : ledger.getMap ())
+    {
+        auto const& accts = vt.second->getAffected ();
+        if (accts.empty ())
+            continue;
+
+        s.erase ();
+        vt.second->getTxn ()->add (s);
+        assign (rawTxn, s.data (), s.size ());
+        auto const& meta = vt.second->getRawMeta ();
+        assign (rawMeta, meta.data (), meta.size ());
+        txnSeq = vt.second->getTxnSeq ();
+
+        for (auto const& acct : accts)
+        {
+            assign (account, acct.data (), acct.size ());
+            st.execute (true);
+        }
+    }
 
-            if (!lookingForMarker)
+    addAccountTxIndexRange (session, seq, seq);
+}
+
+void
+addAccountTxIndexRange (
+    soci::session& session,
+    std::uint32_t low,
+    std::uint32_t high)
+{
+    std::int64_t lower = low;
+    std::int64_t upper = high;
+    boost::optional<std::int64_t> mergedLow;
+    boost::optional<std::int64_t> mergedHigh;
+
+    // Merge with the ranges which overlap or adjoin this one
+    session <<
+        R"(SELECT MIN(Low), MAX(High) FROM AccountTxIndexRanges
+           WHERE Low <= :upper + 1 AND High + 1 >= :lower;)",
+        soci::into (mergedLow), soci::into (mergedHigh),
+        soci::use (upper), soci::use (lower);
+    if (mergedLow)
+        lower = std::min (lower, *mergedLow);
+    if (mergedHigh)
+        upper = std::max (upper, *mergedHigh);
+
+    session <<
+        R"(DELETE FROM AccountTxIndexRanges
+           WHERE Low BETWEEN :lower AND :upper;)",
+        soci::use (lower), soci::use (upper);
+    session <<
+        R"(INSERT INTO AccountTxIndexRanges (Low, High)
+           VALUES (:lower, :upper);)",
+        soci::use (lower), soci::use (upper);
+}
+
+//------------------------------------------------------------------------------
+
+AccountTxIndexImport::AccountTxIndexImport (
+        DatabaseCon& database, beast::Journal j, std::uint32_t batchSize)
+    : database_ (database)
+    , j_ (j)
+    , batchSize_ (std::max<std::uint32_t> (batchSize, 1))
+{
+}
+
+bool
+AccountTxIndexImport::start ()
+{
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> gaps;
+    {
+        auto db = database_.checkoutDb ();
+
+        boost::optional<std::uint64_t> txMin;
+        boost::optional<std::uint64_t> txMax;
+        *db << "SELECT MIN(LedgerSeq), MAX(LedgerSeq) "
+            "FROM AccountTransactions;", soci::into (txMin), soci::into (txMax);
+
+        if (txMin && txMax)
+        {
+            std::int64_t const first = *txMin;
+            std::int64_t const last = *txMax;
+            std::int64_t low = 0;
+            std::int64_t high = 0;
+            soci::statement st = (db->prepare <<
+                R"(SELECT Low, High FROM AccountTxIndexRanges
+                   WHERE High >= :first AND Low <= :last ORDER BY Low;)",
+                soci::into (low), soci::into (high),
+                soci::use (first), soci::use (last));
+            st.execute ();
+
+            std::int64_t next = first;
+            while (st.fetch ())
             {
-                if (dataPresent == soci::i_ok)
-                    convert (txnData, rawData);
-                else
-                    rawData.clear ();
-
-                if (metaPresent == soci::i_ok)
-                    convert (txnMeta, rawMeta);
-                else
-                    rawMeta.clear ();
-
-                // Work around a bug that could leave the metadata missing
-                if (rawMeta.size() == 0)
-                    onUnsavedLedger(ledgerSeq.value_or (0));
-
-                onTransaction(rangeCheckedCast<std::uint32_t>(ledgerSeq.value_or (0)),
-                    *status, rawData, rawMeta);
-                --numberOfResults;
+                if (low > next)
+                    gaps.emplace_back (next, low - 1);
+                next = std::max (next, high + 1);
             }
+            if (next <= last)
+                gaps.emplace_back (next, last);
         }
     }
 
-    return;
+    std::uint64_t ledgers = 0;
+    for (auto const& gap : gaps)
+        ledgers += gap.second - gap.first + 1;
+
+    if (ledgers != 0)
+    {
+        JLOG (j_.warn()) << "Building the account transaction index for " <<
+            ledgers << " ledgers in " << gaps.size () << " ranges";
+    }
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    gaps_ = std::move (gaps);
+    remaining_ = ledgers;
+    complete_ = gaps_.empty ();
+    return ! complete_;
+}
+
+std::uint64_t
+AccountTxIndexImport::copyLedger (std::uint32_t seq)
+{
+    std::uint64_t rows = 0;
+    auto db = database_.checkoutDb ();
+    auto& session = *db;
+
+    boost::optional<std::string> accountID;
+    boost::optional<std::uint64_t> ledgerSeq;
+    boost::optional<std::uint32_t> txnSeq;
+    boost::optional<std::string> status;
+    soci::blob txnData (session);
+    soci::blob txnMeta (session);
+    soci::indicator dataPresent, metaPresent;
+    std::int64_t const selectSeq = seq;
+
+    soci::statement select = (session.prepare <<
+        R"(SELECT AccountTransactions.Account,AccountTransactions.LedgerSeq,
+             AccountTransactions.TxnSeq,Status,RawTxn,TxnMeta
+           FROM AccountTransactions INNER JOIN Transactions
+           ON Transactions.TransID = AccountTransactions.TransID
+           WHERE AccountTransactions.LedgerSeq = :seq;)",
+        soci::use (selectSeq),
+        soci::into (accountID),
+        soci::into (ledgerSeq),
+        soci::into (txnSeq),
+        soci::into (status),
+        soci::into (txnData, dataPresent),
+        soci::into (txnMeta, metaPresent));
+
+    soci::blob account (session);
+    soci::blob rawTxn (session);
+    soci::blob rawMeta (session);
+    std::int64_t insertLedgerSeq = 0;
+    std::int64_t insertTxnSeq = 0;
+    std::string insertStatus;
+
+    soci::statement insert = (session.prepare <<
+        R"(INSERT OR REPLACE INTO AccountTxIndex
+           (Account, LedgerSeq, TxnSeq, Status, RawTxn, TxnMeta)
+           VALUES (:account, :ledgerSeq, :txnSeq, :status, :rawTxn, :rawMeta);)",
+        soci::use (account),
+        soci::use (insertLedgerSeq),
+        soci::use (insertTxnSeq),
+        soci::use (insertStatus),
+        soci::use (rawTxn),
+        soci::use (rawMeta));
+
+    Blob data;
+    soci::transaction tr (session);
+    select.execute ();
+    while (select.fetch ())
+    {
+        auto const id = parseBase58<AccountID> (accountID.value_or (""));
+        if (! id)
+            continue;
+        assign (account, id->data (), id->size ());
+        insertLedgerSeq = ledgerSeq.value_or (0);
+        insertTxnSeq = txnSeq.value_or (0);
+        insertStatus = status.value_or ("");
+        if (dataPresent == soci::i_ok)
+            convert (txnData, data);
+        else
+            data.clear ();
+        assign (rawTxn, data.data (), data.size ());
+        if (metaPresent == soci::i_ok)
+            convert (txnMeta, data);
+        else
+            data.clear ();
+        assign (rawMeta, data.data (), data.size ());
+        insert.execute (true);
+        ++rows;
+    }
+    addAccountTxIndexRange (session, seq, seq);
+    tr.commit ();
+    return rows;
+}
+
+bool
+AccountTxIndexImport::step ()
+{
+    std::uint32_t lower;
+    std::uint32_t upper;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (gaps_.empty ())
+            return false;
+        // The newest gap is last, it is copied from the top down
+        auto const& gap = gaps_.back ();
+        upper = gap.second;
+        lower = upper - gap.first < batchSize_ ?
+            gap.first : upper - batchSize_ + 1;
+    }
+
+    // Each ledger is committed on its own, so the session is
+    // free for other writers between them
+    for (auto seq = upper; ; --seq)
+    {
+        auto const rows = copyLedger (seq);
+
+        std::lock_guard<std::mutex> lock (mutex_);
+        rows_ += rows;
+        --remaining_;
+        if (seq == gaps_.back ().first)
+            gaps_.pop_back ();
+        else
+            gaps_.back ().second = seq - 1;
+
+        if (seq == lower)
+            break;
+    }
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    if (! gaps_.empty ())
+    {
+        JLOG (j_.info()) << "Account transaction index: " << rows_ <<
+            " rows, down to ledger " << lower << ", " << remaining_ <<
+            " ledgers left";
+        return true;
+    }
+
+    complete_ = true;
+    JLOG (j_.warn()) << "Account transaction index built, " <<
+        rows_ << " rows";
+    return false;
+}
+
+bool
+AccountTxIndexImport::complete () const
+{
+    return complete_;
+}
+
+Json::Value
+AccountTxIndexImport::getJson () const
+{
+    Json::Value ret (Json::objectValue);
+    std::lock_guard<std::mutex> lock (mutex_);
+    ret[jss::complete] = complete_.load ();
+    ret[jss::rows_copied] = static_cast<Json::UInt> (rows_);
+    ret[jss::ledgers_left] = static_cast<Json::UInt> (remaining_);
+    if (! gaps_.empty ())
+        ret[jss::ledger] = gaps_.back ().second;
+    return ret;
 }
 
 }
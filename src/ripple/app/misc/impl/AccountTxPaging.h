@@ -22,15 +22,22 @@
 
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/json/json_value.h>
+#include <atomic>
 #include <cstdint>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 
 //------------------------------------------------------------------------------
 
 namespace ripple {
 
+class AcceptedLedger;
+
 void
 convertBlobsToTxResult (
     NetworkOPs::AccountTxs& to,
@@ -61,6 +68,107 @@ accountTxPage (
     bool bAdmin,
     std::uint32_t pageLength);
 
+/** Page through an account's transactions using the AccountTxIndex table.
+
+    Behaves exactly like accountTxPage, including the format of the
+    marker, but each page is a single range scan of the table's primary
+    key instead of a join against the Transactions table.
+*/
+void
+accountTxIndexPage (
+    DatabaseCon& database,
+    std::function<void (std::uint32_t)> const& onUnsavedLedger,
+    std::function<void (std::uint32_t,
+                        std::string const&,
+                        Blob const&,
+                        Blob const&)> const&,
+    AccountID const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool forward,
+    Json::Value& token,
+    int limit,
+    bool bAdmin,
+    std::uint32_t pageLength);
+
+/** Write a validated ledger's transactions to the AccountTxIndex table.
+
+    Any rows previously saved for the ledger are replaced, and the
+    ledger is recorded as held by the index. The caller is expected
+    to hold a transaction on the session.
+*/
+void
+saveAccountTxIndex (
+    soci::session& session,
+    std::uint32_t seq,
+    AcceptedLedger const& ledger);
+
+/** Record that AccountTxIndex holds every transaction of these ledgers.
+
+    The range is merged with the ranges already recorded.
+*/
+void
+addAccountTxIndexRange (
+    soci::session& session,
+    std::uint32_t low,
+    std::uint32_t high);
+
+/** Copies history from AccountTransactions into the AccountTxIndex table.
+
+    Every ledger in AccountTransactions which is not recorded as held
+    by the index is copied, newest first, a batch of ledgers at a time.
+    Each ledger is committed with its range, so an interrupted import
+    resumes with the ledgers still missing, wherever they are, and other
+    writers only wait for one ledger at a time.
+*/
+class AccountTxIndexImport
+{
+public:
+    /** Create an import which copies batchSize ledgers per step. */
+    AccountTxIndexImport (DatabaseCon& database, beast::Journal j,
+        std::uint32_t batchSize = 256);
+
+    /** Find the ledgers to copy.
+
+        @return `true` if there are ledgers to copy.
+    */
+    bool
+    start ();
+
+    /** Copy one batch of ledgers.
+
+        Calls must not overlap.
+
+        @return `true` if there are ledgers left to copy.
+    */
+    bool
+    step ();
+
+    /** Returns `true` once the index holds all of the history. */
+    bool
+    complete () const;
+
+    /** Report the progress of the import. */
+    Json::Value
+    getJson () const;
+
+private:
+    // Copy a ledger in its own transaction, returning the rows copied
+    std::uint64_t
+    copyLedger (std::uint32_t seq);
+
+    DatabaseCon& database_;
+    beast::Journal j_;
+    std::uint32_t const batchSize_;
+    std::atomic<bool> complete_ {false};
+
+    std::mutex mutable mutex_;
+    // Ledgers left to copy, oldest first
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> gaps_;
+    std::uint64_t remaining_ = 0;
+    std::uint64_t rows_ = 0;
+};
+
 }
 
 #endif
@@ -81,15 +81,10 @@ TxQ::FeeMetrics::update(Application& app,
     ReadView const& view, bool timeLeap,
     TxQ::Setup const& setup)
 {
-    std::size_t txnsExpected;
-    std::size_t mimimumTx;
-    std::uint64_t escalationMultiplier;
-    {
-        std::lock_guard <std::mutex> sl(lock_);
-        txnsExpected = txnsExpected_;
-        mimimumTx = minimumTxnCount_;
-        escalationMultiplier = escalationMultiplier_;
-    }
+    auto const snapshot = getSnapshot();
+    auto txnsExpected = snapshot.txnsExpected;
+    auto const mimimumTx = minimumTxnCount_;
+    auto escalationMultiplier = snapshot.escalationMultiplier;
     std::vector<uint64_t> feeLevels;
     feeLevels.reserve(txnsExpected);
     for (auto const& tx : view.txs)
@@ -147,28 +142,21 @@ TxQ::FeeMetrics::update(Application& app,
         txnsExpected << " and multiplier updated to " <<
         escalationMultiplier;
 
-    std::lock_guard <std::mutex> sl(lock_);
-    txnsExpected_ = txnsExpected;
-    escalationMultiplier_ = escalationMultiplier;
+    std::atomic_store(&snapshot_, std::make_shared<Snapshot const>(
+        Snapshot{ txnsExpected, escalationMultiplier }));
 
     return size;
 }
 
 std::uint64_t
-TxQ::FeeMetrics::scaleFeeLevel(OpenView const& view,
-    std::uint32_t txCountPadding) const
+TxQ::FeeMetrics::scaleFeeLevel(Snapshot const& snapshot,
+    OpenView const& view, std::uint32_t txCountPadding)
 {
     // Transactions in the open ledger so far
     auto const current = view.txCount() + txCountPadding;
 
-    auto const params = [&]
-    {
-        std::lock_guard <std::mutex> sl(lock_);
-        return std::make_pair(txnsExpected_,
-            escalationMultiplier_);
-    }();
-    auto const target = params.first;
-    auto const multiplier = params.second;
+    auto const target = snapshot.txnsExpected;
+    auto const multiplier = snapshot.escalationMultiplier;
 
     // Once the open ledger bypasses the target,
     // escalate the fee quickly.
@@ -218,13 +206,9 @@ TxQ::FeeMetrics::escalatedSeriesFeeLevel(OpenView const& view,
     */
     auto const last = current + seriesSize - 1;
 
-    auto const params = [&] {
-        std::lock_guard <std::mutex> sl(lock_);
-        return std::make_pair(txnsExpected_,
-            escalationMultiplier_);
-    }();
-    auto const target = params.first;
-    auto const multiplier = params.second;
+    auto const snapshot = getSnapshot();
+    auto const target = snapshot.txnsExpected;
+    auto const multiplier = snapshot.escalationMultiplier;
 
     assert(current > target);
 
@@ -326,6 +310,8 @@ TxQ::TxQ(Setup const& setup,
     , j_(j)
     , feeMetrics_(setup, j)
     , maxSize_(boost::none)
+    , queueSnapshot_(std::make_shared<QueueSnapshot const>(
+        QueueSnapshot{ 0, boost::none, baseLevel }))
 {
 }
 
@@ -345,6 +331,14 @@ TxQ::isFull() const
         (*maxSize_ * fillPercentage / 100);
 }
 
+void
+TxQ::publish()
+{
+    std::atomic_store(&queueSnapshot_, std::make_shared<QueueSnapshot const>(
+        QueueSnapshot{ byFee_.size(), maxSize_,
+            isFull() ? byFee_.rbegin()->feeLevel + 1 : baseLevel }));
+}
+
 bool
 TxQ::canBeHeld(STTx const& tx, OpenView const& view,
     AccountMap::iterator accountIter,
@@ -624,6 +618,7 @@ TxQ::apply(Application& app, OpenView& view,
     boost::optional<TxConsequences const> consequences;
     boost::optional<FeeMultiSet::iterator> replacedItemDeleteIter;
 
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
     std::lock_guard<std::mutex> lock(mutex_);
 
     // We may need the base fee for multiple transactions
@@ -947,6 +942,7 @@ TxQ::apply(Application& app, OpenView& view,
         auto result = tryClearAccountQueue(app, sandbox, *tx, accountIter,
             multiTxn->nextTxIter, feeLevelPaid, pfresult, view.txCount(),
                 flags, j);
+        publish();
         if (result.second)
         {
             sandbox.apply(view);
@@ -977,7 +973,10 @@ TxQ::apply(Application& app, OpenView& view,
                         transToken(txnResult);
 
         if (didApply && replacedItemDeleteIter)
+        {
             erase(*replacedItemDeleteIter);
+            publish();
+        }
         return { txnResult, didApply };
     }
 
@@ -1083,6 +1082,7 @@ TxQ::apply(Application& app, OpenView& view,
         candidate.consequences.emplace(*consequences);
     // Then index it into the byFee lookup.
     byFee_.insert(candidate);
+    publish();
     JLOG(j_.debug()) << "Added transaction " << candidate.txID <<
         " from " << (accountExists ? "existing" : "new") <<
             " account " << candidate.account << " to queue.";
@@ -1120,6 +1120,7 @@ TxQ::processClosedLedger(Application& app,
 
     auto ledgerSeq = view.info().seq;
 
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
     std::lock_guard<std::mutex> lock(mutex_);
 
     if (!timeLeap)
@@ -1150,6 +1151,8 @@ TxQ::processClosedLedger(Application& app,
         else
             ++txQAccountIter;
     }
+
+    publish();
 }
 
 /*
@@ -1202,11 +1205,24 @@ TxQ::accept(Application& app,
     */
 
     auto ledgerChanged = false;
+    std::size_t attempts = 0;
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
 
     for (auto candidateIter = byFee_.begin(); candidateIter != byFee_.end();)
     {
+        if (++attempts % acceptBatchSize == 0)
+        {
+            /* Let queries of the queue in between batches.
+                Nothing else can change the queue while we hold
+                writeMutex_, so candidateIter stays valid.
+            */
+            publish();
+            lock.unlock();
+            lock.lock();
+        }
+
         auto& account = byAccount_.at(candidateIter->account);
         if (candidateIter->sequence >
             account.transactions.begin()->first)
@@ -1302,6 +1318,7 @@ TxQ::accept(Application& app,
         }
     }
 
+    publish();
     return ledgerChanged;
 }
 
@@ -1316,17 +1333,19 @@ TxQ::getMetrics(OpenView const& view, std::uint32_t txCountPadding) const
 
     Metrics result;
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    // Read the published snapshots rather than locking the queue
+    auto const queue = std::atomic_load(&queueSnapshot_);
+    auto const fees = feeMetrics_.getSnapshot();
 
-    result.txCount = byFee_.size();
-    result.txQMaxSize = maxSize_;
+    result.txCount = queue->txCount;
+    result.txQMaxSize = queue->maxSize;
     result.txInLedger = view.txCount();
-    result.txPerLedger = feeMetrics_.getTxnsExpected();
+    result.txPerLedger = fees.txnsExpected;
     result.referenceFeeLevel = baseLevel;
-    result.minFeeLevel = isFull() ? byFee_.rbegin()->feeLevel + 1 :
-        baseLevel;
-    result.medFeeLevel = feeMetrics_.getEscalationMultiplier();
-    result.expFeeLevel = feeMetrics_.scaleFeeLevel(view, txCountPadding);
+    result.minFeeLevel = queue->minFeeLevel;
+    result.medFeeLevel = fees.escalationMultiplier;
+    result.expFeeLevel = FeeMetrics::scaleFeeLevel(
+        fees, view, txCountPadding);
 
     return result;
 }
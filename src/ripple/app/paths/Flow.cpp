@@ -67,7 +67,8 @@ flow (
     boost::optional<Quality> const& limitQuality,
     boost::optional<STAmount> const& sendMax,
     beast::Journal j,
-    path::detail::FlowDebugInfo* flowDebugInfo)
+    path::detail::FlowDebugInfo* flowDebugInfo,
+    std::size_t strandThreads)
 {
     Issue const srcIssue = [&] {
         if (sendMax)
@@ -117,6 +118,9 @@ flow (
 
     auto const asDeliver = toAmountSpec (deliver);
 
+    StrandWorkers* const workers = strandThreads > 1 && strands.size () > 1
+        ? &StrandWorkers::instance (strandThreads) : nullptr;
+
     // The src account may send either xrp or iou. The dst account may receive
     // either xrp or iou. Since XRP and IOU amounts are represented by different
     // types, use templates to tell `flow` about the amount types.
@@ -125,7 +129,7 @@ flow (
         return finishFlow (sb, srcIssue, dstIssue,
             flow<XRPAmount, XRPAmount> (
                 sb, strands, asDeliver.xrp, partialPayment, offerCrossing,
-                limitQuality, sendMax, j, flowDebugInfo));
+                limitQuality, sendMax, j, flowDebugInfo, workers));
     }
 
     if (srcIsXRP && !dstIsXRP)
@@ -133,7 +137,7 @@ flow (
         return finishFlow (sb, srcIssue, dstIssue,
             flow<XRPAmount, IOUAmount> (
                 sb, strands, asDeliver.iou, partialPayment, offerCrossing,
-                limitQuality, sendMax, j, flowDebugInfo));
+                limitQuality, sendMax, j, flowDebugInfo, workers));
     }
 
     if (!srcIsXRP && dstIsXRP)
@@ -141,14 +145,14 @@ flow (
         return finishFlow (sb, srcIssue, dstIssue,
             flow<IOUAmount, XRPAmount> (
                 sb, strands, asDeliver.xrp, partialPayment, offerCrossing,
-                limitQuality, sendMax, j, flowDebugInfo));
+                limitQuality, sendMax, j, flowDebugInfo, workers));
     }
 
     assert (!srcIsXRP && !dstIsXRP);
     return finishFlow (sb, srcIssue, dstIssue,
         flow<IOUAmount, IOUAmount> (
             sb, strands, asDeliver.iou, partialPayment, offerCrossing,
-            limitQuality, sendMax, j, flowDebugInfo));
+            limitQuality, sendMax, j, flowDebugInfo, workers));
 
 }
 
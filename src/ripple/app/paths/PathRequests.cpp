@@ -47,7 +47,10 @@ PathRequests::getLineCache (
          (authoritative && ((lgrSeq + 8)  < lineSeq)) ||   // we jumped way back for some reason
          (lgrSeq > (lineSeq + 8)))                         // we jumped way forward for some reason
     {
-        mLineCache = std::make_shared<RippleLineCache> (ledger);
+        // Keep the lines which did not change
+        mLineCache = mLineCache
+            ? std::make_shared<RippleLineCache> (ledger, *mLineCache)
+            : std::make_shared<RippleLineCache> (ledger);
     }
     return mLineCache;
 }
@@ -258,7 +261,19 @@ PathRequests::doLegacyPathRequest (
         std::shared_ptr<ReadView const> const& inLedger,
         Json::Value const& request)
 {
-    auto cache = std::make_shared<RippleLineCache> (inLedger);
+    // Share the lines of the cache used by path_find if this is its ledger
+    std::shared_ptr<RippleLineCache> cache;
+    {
+        ScopedLockType sl (mLock);
+        if (mLineCache && ! inLedger->open() &&
+            ! mLineCache->getLedger()->open() &&
+            mLineCache->getLedger()->info().hash == inLedger->info().hash)
+        {
+            cache = mLineCache;
+        }
+    }
+    if (! cache)
+        cache = std::make_shared<RippleLineCache> (inLedger);
 
     auto req = std::make_shared<PathRequest> (app_, []{},
         consumer, ++mLastIdentifier, *this, mJournal);
@@ -118,10 +118,12 @@ RippleCalc::Output RippleCalc::rippleCalculate (
         bool partialPayment = false;
         boost::optional<Quality> limitQuality;
         boost::optional<STAmount> sendMax;
+        std::size_t strandThreads = 0;
 
         if (pInputs)
         {
             defaultPaths = pInputs->defaultPathsAllowed;
+            strandThreads = pInputs->strandThreads;
             partialPayment = pInputs->partialPaymentAllowed;
             if (pInputs->limitQuality && saMaxAmountReq > beast::zero)
                 limitQuality.emplace (
@@ -143,7 +145,8 @@ RippleCalc::Output RippleCalc::rippleCalculate (
             flowV2Out = flow (flowV2SB, saDstAmountReq, uSrcAccountID,
                 uDstAccountID, spsPaths, defaultPaths, partialPayment,
                 ownerPaysTransferFee, /* offerCrossing */ false, limitQuality, sendMax, j,
-                compareFlowV1V2 ? &flowV2FlowDebugInfo : nullptr);
+                compareFlowV1V2 ? &flowV2FlowDebugInfo : nullptr,
+                strandThreads);
         }
         catch (std::exception& e)
         {
@@ -50,6 +50,7 @@ public:
         bool defaultPathsAllowed = true;
         bool limitQuality = false;
         bool isLedgerOpen = true;
+        std::size_t strandThreads = 0;
     };
     struct Output
     {
@@ -19,6 +19,7 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/paths/RippleLineCache.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/ledger/OpenView.h>
 
 namespace ripple {
@@ -30,6 +31,64 @@ RippleLineCache::RippleLineCache(
     // And we need to own a shared_ptr to the input view
     // VFALCO TODO This should be a CachedLedger
     mLedger = std::make_shared<OpenView>(&*ledger, ledger);
+    base_ = std::dynamic_pointer_cast<Ledger const>(ledger);
+}
+
+RippleLineCache::RippleLineCache(
+    std::shared_ptr <ReadView const> const& ledger,
+    RippleLineCache& previous)
+    : RippleLineCache (ledger)
+{
+    // The most state entries which may differ between the ledgers
+    int const maxDifferences = 16384;
+
+    auto const prevLedger = previous.base_;
+    if (! base_ || ! prevLedger)
+        return;
+
+    // Find the accounts with a trust line which differs
+    hash_set<AccountID> changed;
+    if (prevLedger != base_)
+    {
+        try
+        {
+            SHAMap::Delta delta;
+            if (! prevLedger->stateMap().compare (
+                    base_->stateMap(), delta, maxDifferences))
+                return;
+
+            for (auto const& entry : delta)
+            {
+                for (auto const& item :
+                    {entry.second.first, entry.second.second})
+                {
+                    if (! item)
+                        continue;
+                    SerialIter sit (item->slice());
+                    SLE const sle (sit, item->key());
+                    if (sle.getType() != ltRIPPLE_STATE)
+                        continue;
+                    changed.insert (sle[sfLowLimit].getIssuer());
+                    changed.insert (sle[sfHighLimit].getIssuer());
+                }
+            }
+        }
+        catch (std::exception const&)
+        {
+            // Missing nodes, start empty
+            return;
+        }
+    }
+
+    std::lock_guard <std::mutex> sl (previous.mLock);
+    lines_.reserve (previous.lines_.size());
+    for (auto const& entry : previous.lines_)
+    {
+        auto const& account = entry.first.account_;
+        if (changed.count (account) == 0)
+            lines_.emplace (AccountKey (account, hasher_ (account)),
+                entry.second);
+    }
 }
 
 std::vector<RippleState::pointer> const&
@@ -49,4 +108,11 @@ RippleLineCache::getRippleLines (AccountID const& accountID)
     return it.first->second;
 }
 
+std::size_t
+RippleLineCache::size ()
+{
+    std::lock_guard <std::mutex> sl (mLock);
+    return lines_.size();
+}
+
 } // ripple
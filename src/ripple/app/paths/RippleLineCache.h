@@ -38,6 +38,16 @@ public:
     RippleLineCache (
         std::shared_ptr <ReadView const> const& l);
 
+    /** Create a cache for another ledger, starting from an earlier cache.
+
+        The lines of each account whose trust lines are the same in both
+        ledgers are taken from the earlier cache instead of being read
+        again. If the ledgers differ by too much, nothing is taken.
+    */
+    RippleLineCache (
+        std::shared_ptr <ReadView const> const& l,
+        RippleLineCache& previous);
+
     std::shared_ptr <ReadView const> const&
     getLedger () const
     {
@@ -47,12 +57,19 @@ public:
     std::vector<RippleState::pointer> const&
     getRippleLines (AccountID const& accountID);
 
+    /** Return the number of accounts whose lines are held. */
+    std::size_t
+    size ();
+
 private:
     std::mutex mLock;
 
     ripple::hardened_hash<> hasher_;
     std::shared_ptr <ReadView const> mLedger;
 
+    // The ledger itself, if it is one, to compare with other ledgers
+    std::shared_ptr <Ledger const> base_;
+
     struct AccountKey
     {
         AccountID account_;
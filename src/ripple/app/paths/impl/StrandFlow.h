@@ -27,12 +27,14 @@
 #include <ripple/app/paths/impl/FlowDebugInfo.h>
 #include <ripple/app/paths/impl/Steps.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/StrandWorkers.h>
 #include <ripple/protocol/IOUAmount.h>
 #include <ripple/protocol/XRPAmount.h>
 
 #include <boost/container/flat_set.hpp>
 
 #include <algorithm>
+#include <exception>
 #include <iterator>
 #include <numeric>
 #include <sstream>
@@ -377,6 +379,7 @@ qualityUpperBound(ReadView const& v, Strand const& strand)
    @param sendMaxST If present, the maximum STAmount to send
    @param j Journal to write journal messages to
    @param flowDebugInfo If pointer is non-null, write flow debug info here
+   @param workers If non-null, evaluate the strands of each pass on these
    @return Actual amount in and out from the strands, errors, and payment sandbox
 */
 template <class TInAmt, class TOutAmt>
@@ -389,7 +392,8 @@ flow (PaymentSandbox const& baseView,
     boost::optional<Quality> const& limitQuality,
     boost::optional<STAmount> const& sendMaxST,
     beast::Journal j,
-    path::detail::FlowDebugInfo* flowDebugInfo=nullptr)
+    path::detail::FlowDebugInfo* flowDebugInfo=nullptr,
+    StrandWorkers* workers=nullptr)
 {
     // Used to track the strand that offers the best quality (output/input ratio)
     struct BestStrand
@@ -470,23 +474,30 @@ flow (PaymentSandbox const& baseView,
         boost::container::flat_set<uint256> ofrsToRm;
         boost::optional<BestStrand> best;
         if (flowDebugInfo) flowDebugInfo->newLiquidityPass();
-        for (auto strand : activeStrands)
+
+        // Returns boost::none if the strand is skipped
+        auto evaluate = [&](Strand const* strand)
+            -> boost::optional<StrandResult<TInAmt, TOutAmt>>
         {
             if (offerCrossing && limitQuality)
             {
                 auto const strandQ = qualityUpperBound(sb, *strand);
                 if (!strandQ || *strandQ < *limitQuality)
-                    continue;
+                    return boost::none;
             }
-            auto f = flow<TInAmt, TOutAmt> (
+            return flow<TInAmt, TOutAmt> (
                 sb, *strand, remainingIn, remainingOut, j);
+        };
 
+        auto consider = [&](Strand const* strand,
+            StrandResult<TInAmt, TOutAmt>& f)
+        {
             // rm bad offers even if the strand fails
             ofrsToRm.insert (boost::container::ordered_unique_range_t{},
                 f.ofrsToRm.begin (), f.ofrsToRm.end ());
 
             if (f.ter != tesSUCCESS || f.out == beast::zero)
-                continue;
+                return;
 
             if (flowDebugInfo)
                 flowDebugInfo->pushLiquiditySrc(EitherAmount(f.in), EitherAmount(f.out));
@@ -508,7 +519,7 @@ flow (PaymentSandbox const& baseView,
                     << "Path rejected by limitQuality"
                     << " limit: " << *limitQuality
                     << " path q: " << q;
-                continue;
+                return;
             }
 
             activeStrands.push (strand);
@@ -516,6 +527,46 @@ flow (PaymentSandbox const& baseView,
             if (!best || best->quality < q ||
                 (best->quality == q && best->out < f.out))
                 best.emplace (f.in, f.out, std::move (*f.sandbox), *strand, q);
+        };
+
+        if (workers && activeStrands.size () > 1)
+        {
+            // The strands only read sb, so they are evaluated at the same
+            // time and then considered in order, as they would have been.
+            std::vector<Strand const*> const current (
+                activeStrands.begin (), activeStrands.end ());
+            std::vector<boost::optional<StrandResult<TInAmt, TOutAmt>>>
+                results (current.size ());
+            std::vector<std::exception_ptr> errors (current.size ());
+            workers->run (current.size (),
+                [&](std::size_t i)
+                {
+                    try
+                    {
+                        if (auto f = evaluate (current[i]))
+                            results[i].emplace (std::move (*f));
+                    }
+                    catch (...)
+                    {
+                        errors[i] = std::current_exception ();
+                    }
+                });
+
+            for (std::size_t i = 0; i < current.size (); ++i)
+            {
+                if (errors[i])
+                    std::rethrow_exception (errors[i]);
+                if (results[i])
+                    consider (current[i], *results[i]);
+            }
+        }
+        else
+        {
+            for (auto strand : activeStrands)
+            {
+                if (auto f = evaluate (strand))
+                    consider (strand, *f);
+            }
         }
 
         bool const shouldBreak = !bool(best);
@@ -21,6 +21,7 @@
 #include <ripple/app/tx/impl/CreateOffer.h>
 #include <ripple/app/ledger/OrderBookDB.h>
 #include <ripple/app/paths/Flow.h>
+#include <ripple/core/Config.h>
 #include <ripple/ledger/CashDiff.h>
 #include <ripple/ledger/PaymentSandbox.h>
 #include <ripple/protocol/Feature.h>
@@ -717,7 +718,8 @@ CreateOffer::flowCross (
             true,                       // owner pays transfer fee
             true,                       // offer crossing
             threshold,
-            sendMax, j_);
+            sendMax, j_, nullptr,
+            ctx_.app.config().PARALLEL_STRANDS);
 
         // If stale offers were found remove them.
         for (auto const& toRemove : result.removableOffers)
@@ -364,6 +364,7 @@ Payment::doApply ()
         rcInput.defaultPathsAllowed = defaultPathsAllowed;
         rcInput.limitQuality = limitQuality;
         rcInput.isLedgerOpen = view().open();
+        rcInput.strandThreads = ctx_.app.config().PARALLEL_STRANDS;
 
         path::RippleCalc::Output rc;
         {
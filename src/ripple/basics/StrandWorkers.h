@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_STRANDWORKERS_H_INCLUDED
+#define RIPPLE_BASICS_STRANDWORKERS_H_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+/** Threads which evaluate the strands of a payment at the same time.
+
+    The threads wait between payments, so a liquidity pass does not
+    pay to start them. One payment uses the threads at a time. Another
+    payment which asks for them meanwhile, as when transactions are
+    applied in parallel, does its work on its own thread instead.
+
+    Transactions applied in parallel to the open ledger, the nodes of a
+    ledger snapshot being loaded, and the search for and checking of the
+    nodes of a ledger being acquired, use the same kind of workers so
+    that each batch does not start threads either.
+*/
+class StrandWorkers
+{
+public:
+    /** Create workers using this many threads, including the caller's. */
+    explicit
+    StrandWorkers (std::size_t threads);
+
+    StrandWorkers (StrandWorkers const&) = delete;
+    StrandWorkers& operator= (StrandWorkers const&) = delete;
+
+    ~StrandWorkers ();
+
+    /** Return the workers shared by all payments using this many threads. */
+    static
+    StrandWorkers&
+    instance (std::size_t threads);
+
+    /** Call f(i) for each i below n, and wait until they all return.
+
+        The calls are made on the calling thread and the workers, in no
+        particular order. If a call throws, the calls not yet started are
+        skipped, and the exception is rethrown here once the others
+        return. When several throw, one of their exceptions is rethrown.
+    */
+    void
+    run (std::size_t n, std::function<void(std::size_t)> const& f);
+
+private:
+    void
+    work ();
+
+    void
+    loop ();
+
+    std::mutex busy_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::uint64_t generation_ = 0;
+    std::size_t active_ = 0;
+    bool stop_ = false;
+
+    std::function<void(std::size_t)> const* job_ = nullptr;
+    std::size_t count_ = 0;
+    std::atomic<std::size_t> next_ {0};
+    std::exception_ptr error_;
+
+    std::vector<std::thread> threads_;
+};
+
+} // ripple
+
+#endif
@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/basics/StrandWorkers.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+
+namespace ripple {
+
+StrandWorkers::StrandWorkers (std::size_t threads)
+{
+    for (std::size_t i = 1; i < threads; ++i)
+        threads_.emplace_back (&StrandWorkers::loop, this);
+}
+
+StrandWorkers::~StrandWorkers ()
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all ();
+    for (auto& t : threads_)
+        t.join ();
+}
+
+StrandWorkers&
+StrandWorkers::instance (std::size_t threads)
+{
+    static std::mutex mutex;
+    static std::map<std::size_t, std::unique_ptr<StrandWorkers>> workers;
+
+    std::lock_guard<std::mutex> lock (mutex);
+    auto& w = workers[threads];
+    if (! w)
+        w = std::make_unique<StrandWorkers> (threads);
+    return *w;
+}
+
+void
+StrandWorkers::run (std::size_t n,
+    std::function<void(std::size_t)> const& f)
+{
+    // The workers this thread is already running a job on. Asking
+    // them again, from a job, must not try the lock it holds.
+    static thread_local std::vector<StrandWorkers const*> running;
+
+    std::unique_lock<std::mutex> busy (busy_, std::defer_lock);
+    if (threads_.empty () || n < 2 ||
+        std::find (running.begin (), running.end (), this) !=
+            running.end () || ! busy.try_lock ())
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            f (i);
+        return;
+    }
+    running.push_back (this);
+
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        job_ = &f;
+        count_ = n;
+        next_ = 0;
+        active_ = threads_.size ();
+        ++generation_;
+    }
+    wake_.notify_all ();
+
+    work ();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock (mutex_);
+        done_.wait (lock, [this]{ return active_ == 0; });
+        job_ = nullptr;
+        std::swap (error, error_);
+    }
+    running.pop_back ();
+
+    if (error)
+        std::rethrow_exception (error);
+}
+
+void
+StrandWorkers::work ()
+{
+    for (auto i = next_++; i < count_; i = next_++)
+    {
+        try
+        {
+            (*job_) (i);
+        }
+        catch (...)
+        {
+            // Keep the first for the caller, and start no more calls
+            std::lock_guard<std::mutex> lock (mutex_);
+            if (! error_)
+                error_ = std::current_exception ();
+            next_ = count_;
+        }
+    }
+}
+
+void
+StrandWorkers::loop ()
+{
+    std::uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock (mutex_);
+    for (;;)
+    {
+        wake_.wait (lock, [&]{ return stop_ || generation_ != seen; });
+        if (stop_)
+            return;
+        seen = generation_;
+
+        lock.unlock ();
+        work ();
+        lock.lock ();
+
+        if (--active_ == 0)
+            done_.notify_one ();
+    }
+}
+
+} // ripple
@@ -26,6 +26,8 @@
 #include <ripple/consensus/ConsensusProposal.h>
 #include <ripple/consensus/DisputedTx.h>
 #include <ripple/json/json_writer.h>
+#include <boost/dynamic_bitset.hpp>
+#include <vector>
 
 namespace ripple {
 
@@ -322,6 +324,12 @@ protected:
             assert(set.id() == position.position());
         }
 
+        // disputeOrder points into disputes
+        Result(Result&&) = default;
+        Result(Result const&) = delete;
+        Result&
+        operator=(Result const&) = delete;
+
         //! The set of transactions consensus agrees go in the ledger
         TxSet_t set;
 
@@ -331,9 +339,16 @@ protected:
         //! Transactions which are under dispute with our peers
         hash_map<typename Tx_t::ID, Dispute_t> disputes;
 
+        // The disputes in the order they were created
+        std::vector<Dispute_t*> disputeOrder;
+
         // Set of TxSet ids we have already compared/created disputes
         hash_set<typename TxSet_t::ID> compares;
 
+        // Which disputed transactions each peer position contains,
+        // indexed like disputeOrder
+        hash_map<typename TxSet_t::ID, boost::dynamic_bitset<>> contains;
+
         // Measures the duration of the establish phase for this consensus round
         Stopwatch roundTime;
 
@@ -551,6 +566,14 @@ private:
     void
     updateDisputes(NodeID_t const& node, TxSet_t const& other);
 
+    // Remove this node's votes from our disputes
+    void
+    unVoteDisputes(NodeID_t const& node);
+
+    // The index of a peer in peerIDs_, assigning one if needed
+    std::size_t
+    peerIndex(NodeID_t const& node);
+
     Derived&
     impl()
     {
@@ -612,6 +635,11 @@ private:
     // Convergence tracking, trusted peers indexed by hash of public key
     hash_map<NodeID_t, Proposal_t> peerProposals_;
 
+    // Peers which have taken a position this round, numbered densely so
+    // disputes can track votes in bitsets
+    hash_map<NodeID_t, std::size_t> peerIndexes_;
+    std::vector<NodeID_t> peerIDs_;
+
     // The number of proposers who participated in the last consensus round
     std::size_t prevProposers_ = 0;
 
@@ -677,6 +705,8 @@ Consensus<Derived, Traits>::startRoundInternal(
     haveCloseTimeConsensus_ = false;
     openTime_.reset(clock_.now());
     peerProposals_.clear();
+    peerIndexes_.clear();
+    peerIDs_.clear();
     acquired_.clear();
     rawCloseTimes_.peers.clear();
     rawCloseTimes_.self = {};
@@ -758,10 +788,7 @@ Consensus<Derived, Traits>::peerProposal(
 
             JLOG(j_.info()) << "Peer bows out: " << to_string(peerID);
             if (result_)
-            {
-                for (auto& it : result_->disputes)
-                    it.second.unVote(peerID);
-            }
+                unVoteDisputes(peerID);
             if (currentPosition != peerProposals_.end())
                 peerProposals_.erase(peerID);
             deadNodes_.insert(peerID);
@@ -1016,7 +1043,9 @@ Consensus<Derived, Traits>::handleWrongLedger(
         if (result_)
         {
             result_->disputes.clear();
+            result_->disputeOrder.clear();
             result_->compares.clear();
+            result_->contains.clear();
         }
 
         peerProposals_.clear();
@@ -1236,8 +1265,7 @@ Consensus<Derived, Traits>::updateOurPositions()
                 // peer's proposal is stale, so remove it
                 auto const& peerID = it->second.nodeID();
                 JLOG(j_.warn()) << "Removing stale proposal from " << peerID;
-                for (auto& dt : result_->disputes)
-                    dt.second.unVote(peerID);
+                unVoteDisputes(peerID);
                 it = peerProposals_.erase(it);
             }
             else
@@ -1508,7 +1536,8 @@ Consensus<Derived, Traits>::createDisputes(TxSet_t const& o)
 
         JLOG(j_.debug()) << "Transaction " << txID << " is disputed";
 
-        typename Result::Dispute_t dtx{tx, result_->set.exists(txID), j_};
+        typename Result::Dispute_t dtx{
+            tx, result_->set.exists(txID), peerIDs_, j_};
 
         // Update all of the available peer's votes on the disputed transaction
         for (auto& pit : peerProposals_)
@@ -1516,11 +1545,12 @@ Consensus<Derived, Traits>::createDisputes(TxSet_t const& o)
             auto cit(acquired_.find(pit.second.position()));
 
             if (cit != acquired_.end())
-                dtx.setVote(pit.first, cit->second.exists(txID));
+                dtx.setVote(peerIndex(pit.first), cit->second.exists(txID));
         }
         impl().relay(dtx.tx());
 
-        result_->disputes.emplace(txID, std::move(dtx));
+        auto const it = result_->disputes.emplace(txID, std::move(dtx)).first;
+        result_->disputeOrder.push_back(&it->second);
     }
     JLOG(j_.debug()) << dc << " differences found";
 }
@@ -1539,11 +1569,43 @@ Consensus<Derived, Traits>::updateDisputes(
     if (result_->compares.find(other.id()) == result_->compares.end())
         createDisputes(other);
 
-    for (auto& it : result_->disputes)
+    // Look up the disputed transactions in each set only once, unless
+    // disputes were created since
+    auto const& order = result_->disputeOrder;
+    auto& contains = result_->contains[other.id()];
+    if (contains.size() < order.size())
     {
-        auto& d = it.second;
-        d.setVote(node, other.exists(d.tx().id()));
+        auto const known = contains.size();
+        contains.resize(order.size());
+        for (auto i = known; i < order.size(); ++i)
+            contains[i] = other.exists(order[i]->tx().id());
     }
+
+    auto const peer = peerIndex(node);
+    for (std::size_t i = 0; i < order.size(); ++i)
+        order[i]->setVote(peer, contains[i]);
+}
+
+template <class Derived, class Traits>
+void
+Consensus<Derived, Traits>::unVoteDisputes(NodeID_t const& node)
+{
+    auto const it = peerIndexes_.find(node);
+    if (it == peerIndexes_.end())
+        return;
+
+    for (auto& dt : result_->disputes)
+        dt.second.unVote(it->second);
+}
+
+template <class Derived, class Traits>
+std::size_t
+Consensus<Derived, Traits>::peerIndex(NodeID_t const& node)
+{
+    auto const result = peerIndexes_.emplace(node, peerIDs_.size());
+    if (result.second)
+        peerIDs_.push_back(node);
+    return result.first->second;
 }
 
 template <class Derived, class Traits>
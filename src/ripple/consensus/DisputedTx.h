@@ -26,7 +26,9 @@
 #include <ripple/consensus/LedgerTiming.h>
 #include <ripple/protocol/Serializer.h>
 #include <ripple/protocol/UintTypes.h>
+#include <boost/dynamic_bitset.hpp>
 #include <memory>
+#include <vector>
 
 namespace ripple {
 
@@ -38,6 +40,10 @@ namespace ripple {
 
     Undisputed transactions have no corresponding @ref DisputedTx object.
 
+    Peers are identified by their index in the list of peers taking part
+    in the round, so that the votes can be kept as bitsets instead of a
+    map from node identifier to vote.
+
     Refer to @ref Consensus for details on the template type requirements.
 
     @tparam Tx_t The type for a transaction
@@ -54,10 +60,15 @@ public:
 
         @param tx The transaction under dispute
         @param ourVote Our vote on whether tx should be included
+        @param peers Identifiers of the peers, by index
         @param j Journal for debugging
     */
-    DisputedTx(Tx_t const& tx, bool ourVote, beast::Journal j)
-        : yays_(0), nays_(0), ourVote_(ourVote), tx_(tx), j_(j)
+    DisputedTx(
+        Tx_t const& tx,
+        bool ourVote,
+        std::vector<NodeID_t> const& peers,
+        beast::Journal j)
+        : yays_(0), nays_(0), ourVote_(ourVote), tx_(tx), peers_(peers), j_(j)
     {
     }
 
@@ -91,18 +102,18 @@ public:
 
     /** Change a peer's vote
 
-        @param peer Identifier of peer.
+        @param peer Index of peer.
         @param votesYes Whether peer votes to include the disputed transaction.
     */
     void
-    setVote(NodeID_t const& peer, bool votesYes);
+    setVote(std::size_t peer, bool votesYes);
 
     /** Remove a peer's vote
 
-        @param peer Identifier of peer.
+        @param peer Index of peer.
     */
     void
-    unVote(NodeID_t const& peer);
+    unVote(std::size_t peer);
 
     /** Update our vote given progression of consensus.
 
@@ -127,64 +138,75 @@ private:
     bool ourVote_;  //< Our vote (true is yes)
     Tx_t tx_;       //< Transaction under dispute
 
-    hash_map<NodeID_t, bool> votes_;  //< Votes of our peers
-    beast::Journal j_;                //< Debug journal
+    std::vector<NodeID_t> const& peers_;  //< Peer identifiers, by index
+    boost::dynamic_bitset<> voted_;       //< Peers who have voted
+    boost::dynamic_bitset<> votesYes_;    //< Peers who vote yes
+    beast::Journal j_;                    //< Debug journal
 };
 
 // Track a peer's yes/no vote on a particular disputed tx_
 template <class Tx_t, class NodeID_t>
 void
-DisputedTx<Tx_t, NodeID_t>::setVote(NodeID_t const& peer, bool votesYes)
+DisputedTx<Tx_t, NodeID_t>::setVote(std::size_t peer, bool votesYes)
 {
-    auto res = votes_.insert(std::make_pair(peer, votesYes));
+    if (peer >= voted_.size())
+    {
+        voted_.resize(std::max(peer + 1, peers_.size()));
+        votesYes_.resize(voted_.size());
+    }
 
     // new vote
-    if (res.second)
+    if (!voted_[peer])
     {
+        voted_[peer] = true;
+        votesYes_[peer] = votesYes;
         if (votesYes)
         {
-            JLOG(j_.debug()) << "Peer " << peer << " votes YES on " << tx_.id();
+            JLOG(j_.debug())
+                << "Peer " << peers_[peer] << " votes YES on " << tx_.id();
             ++yays_;
         }
         else
         {
-            JLOG(j_.debug()) << "Peer " << peer << " votes NO on " << tx_.id();
+            JLOG(j_.debug())
+                << "Peer " << peers_[peer] << " votes NO on " << tx_.id();
             ++nays_;
         }
     }
     // changes vote to yes
-    else if (votesYes && !res.first->second)
+    else if (votesYes && !votesYes_[peer])
     {
-        JLOG(j_.debug()) << "Peer " << peer << " now votes YES on " << tx_.id();
+        JLOG(j_.debug())
+            << "Peer " << peers_[peer] << " now votes YES on " << tx_.id();
         --nays_;
         ++yays_;
-        res.first->second = true;
+        votesYes_[peer] = true;
     }
     // changes vote to no
-    else if (!votesYes && res.first->second)
+    else if (!votesYes && votesYes_[peer])
     {
-        JLOG(j_.debug()) << "Peer " << peer << " now votes NO on " << tx_.id();
+        JLOG(j_.debug())
+            << "Peer " << peers_[peer] << " now votes NO on " << tx_.id();
         ++nays_;
         --yays_;
-        res.first->second = false;
+        votesYes_[peer] = false;
     }
 }
 
 // Remove a peer's vote on this disputed transasction
 template <class Tx_t, class NodeID_t>
 void
-DisputedTx<Tx_t, NodeID_t>::unVote(NodeID_t const& peer)
+DisputedTx<Tx_t, NodeID_t>::unVote(std::size_t peer)
 {
-    auto it = votes_.find(peer);
-
-    if (it != votes_.end())
+    if (peer < voted_.size() && voted_[peer])
     {
-        if (it->second)
+        if (votesYes_[peer])
             --yays_;
         else
             --nays_;
 
-        votes_.erase(it);
+        voted_[peer] = false;
+        votesYes_[peer] = false;
     }
 }
 
@@ -256,11 +278,12 @@ DisputedTx<Tx_t, NodeID_t>::getJson() const
     ret["nays"] = nays_;
     ret["our_vote"] = ourVote_;
 
-    if (!votes_.empty())
+    if (voted_.any())
     {
         Json::Value votesj(Json::objectValue);
-        for (auto& vote : votes_)
-            votesj[to_string(vote.first)] = vote.second;
+        for (auto i = voted_.find_first(); i != voted_.npos;
+             i = voted_.find_next(i))
+            votesj[to_string(peers_[i])] = static_cast<bool>(votesYes_[i]);
         ret["votes"] = std::move(votesj);
     }
 
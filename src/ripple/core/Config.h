@@ -112,6 +112,12 @@ public:
     bool doImport = false;
     bool ELB_SUPPORT = false;
 
+    // Keep the binary keyed account transaction index
+    bool ACCOUNT_TX_INDEX = false;
+
+    // Write stale validations from untrusted validators to the database
+    bool SAVE_UNTRUSTED_VALIDATIONS = true;
+
     std::vector<std::string>    IPS;                    // Peer IPs from rippled.cfg.
     std::vector<std::string>    IPS_FIXED;              // Fixed Peer IPs from rippled.cfg.
     std::vector<std::string>    SNTP_SERVERS;           // SNTP servers from rippled.cfg.
@@ -122,6 +128,7 @@ public:
         NORMAL,
         LOAD,
         LOAD_FILE,
+        LOAD_SNAPSHOT,
         REPLAY,
         NETWORK
     };
@@ -149,6 +156,16 @@ public:
     int                         PATH_SEARCH_FAST = 2;
     int                         PATH_SEARCH_MAX = 10;
 
+    // Threads used to rebuild the open ledger, 0 or 1 to apply serially
+    std::size_t                 PARALLEL_APPLY = 0;
+
+    // Threads used to evaluate payment strands, 0 or 1 to evaluate serially
+    std::size_t                 PARALLEL_STRANDS = 0;
+
+    // Read only sessions of the transaction and ledger databases, and
+    // threads reading them for RPC, 0 to read with the main session
+    std::size_t                 DATABASE_READERS = 4;
+
     // Validation
     boost::optional<std::size_t> VALIDATION_QUORUM;     // Minimum validations to consider ledger authoritative
 
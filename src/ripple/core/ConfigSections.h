@@ -32,8 +32,10 @@ struct ConfigSection
 };
 
 // VFALCO TODO Rename and replace these macros with variables.
+#define SECTION_ACCOUNT_TX_INDEX        "account_tx_index"
 #define SECTION_AMENDMENTS              "amendments"
 #define SECTION_CLUSTER_NODES           "cluster_nodes"
+#define SECTION_DATABASE_READERS        "database_readers"
 #define SECTION_DEBUG_LOGFILE           "debug_logfile"
 #define SECTION_ELB_SUPPORT             "elb_support"
 #define SECTION_FEE_DEFAULT             "fee_default"
@@ -48,6 +50,8 @@ struct ConfigSection
 #define SECTION_NETWORK_QUORUM          "network_quorum"
 #define SECTION_NODE_SEED               "node_seed"
 #define SECTION_NODE_SIZE               "node_size"
+#define SECTION_PARALLEL_APPLY          "parallel_apply"
+#define SECTION_PARALLEL_STRANDS        "parallel_strands"
 #define SECTION_PATH_SEARCH_OLD         "path_search_old"
 #define SECTION_PATH_SEARCH             "path_search"
 #define SECTION_PATH_SEARCH_FAST        "path_search_fast"
@@ -55,6 +59,7 @@ struct ConfigSection
 #define SECTION_PEER_PRIVATE            "peer_private"
 #define SECTION_PEERS_MAX               "peers_max"
 #define SECTION_RPC_STARTUP             "rpc_startup"
+#define SECTION_SAVE_UNTRUSTED_VALIDATIONS "save_untrusted_validations"
 #define SECTION_SNTP                    "sntp_servers"
 #define SECTION_SSL_VERIFY              "ssl_verify"
 #define SECTION_SSL_VERIFY_FILE         "ssl_verify_file"
@@ -22,9 +22,19 @@
 
 #include <ripple/core/Config.h>
 #include <ripple/core/SociDB.h>
+#include <ripple/json/json_value.h>
 #include <boost/filesystem/path.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 
 namespace soci {
@@ -46,6 +56,10 @@ public:
     LockedPointer (T* it, mutex& m) : it_ (it), lock_ (m)
     {
     }
+    LockedPointer (T* it, std::unique_lock<mutex>&& lock)
+        : it_ (it), lock_ (std::move (lock))
+    {
+    }
     LockedPointer (LockedPointer&& rhs) noexcept
         : it_ (rhs.it_), lock_ (std::move (rhs.lock_))
     {
@@ -89,23 +103,132 @@ public:
                  const char* initString[],
                  int countInit);
 
+    ~DatabaseCon ();
+
     soci::session& getSession()
     {
         return session_;
     }
 
-    LockedSociSession checkoutDb ()
-    {
-        return LockedSociSession (&session_, lock_);
-    }
+    /** Return the main session, the only one which writes, locked.
+
+        Within a query passed to read, return the session of the query.
+    */
+    LockedSociSession checkoutDb ();
+
+    /** Return a read only session, locked.
+
+        A free session of the pool is returned, and the caller waits
+        only if they are all in use. Without a pool, the main session
+        is returned. Within a query passed to read, return the session
+        of the query.
+    */
+    LockedSociSession checkoutRead ();
+
+    /** Run a query which only reads, without blocking a job thread.
+
+        The query runs on a reader thread using a read only session,
+        and the coroutine is suspended until it returns. Calls to
+        checkoutDb and checkoutRead made by the query return the same
+        session. Without a coroutine, or without readers, the query
+        runs on the calling thread. An exception thrown by the query
+        is rethrown here.
+
+        @param name The name under which the latency is counted.
+    */
+    void
+    read (std::string const& name,
+        std::shared_ptr<JobQueue::Coro> const& coro,
+        std::function<void(soci::session&)> const& query);
+
+    /** Report the latencies of the queries run by read, by name. */
+    Json::Value
+    getReadJson () const;
+
+    /** Report how often, and how long, checkouts waited for a session. */
+    Json::Value
+    getCheckoutJson () const;
 
     void setupCheckpointing (JobQueue*, Logs&);
 
+    /** Open a pool of read only sessions, and threads running the
+        queries passed to read.
+
+        Each session applies the pragmas from the init strings, except
+        for those which only affect writing. This does nothing for a
+        database kept in a temporary file, which other sessions can't
+        open.
+
+        @param sessions The number of sessions in the pool, which is
+                        also the number of threads.
+    */
+    void setupReaders (std::size_t sessions, Logs&);
+
 private:
+    class Readers;
+
+    struct ReadSession
+    {
+        soci::session session;
+        LockedSociSession::mutex lock;
+    };
+
+    struct Waits
+    {
+        std::atomic<std::uint64_t> checkouts {0};
+        std::atomic<std::uint64_t> waits {0};
+        std::atomic<std::uint64_t> waitMicroseconds {0};
+
+        void
+        wait (LockedSociSession::mutex& m,
+            std::unique_lock<LockedSociSession::mutex>& lock);
+
+        Json::Value
+        getJson () const;
+    };
+
+    // Bucket i counts the queries which took less than 2^i
+    // milliseconds, and the last bucket counts the rest
+    using Latencies = std::array<std::uint64_t, 12>;
+
+    // The read session of a query running on this thread
+    static thread_local std::vector<
+        std::pair<DatabaseCon const*, ReadSession*>> pinned_;
+
+    ReadSession*
+    pinned () const;
+
+    std::pair<ReadSession*, std::unique_lock<LockedSociSession::mutex>>
+    lockRead ();
+
+    void
+    runRead (std::function<void(soci::session&)> const& query);
+
+    void
+    addLatency (std::string const& name,
+        std::chrono::steady_clock::time_point start);
+
     LockedSociSession::mutex lock_;
 
     soci::session session_;
     std::unique_ptr<Checkpointer> checkpointer_;
+
+    // The database file, empty for a temporary one
+    boost::filesystem::path path_;
+
+    // Connection settings from the init strings which also
+    // matter to the read sessions
+    std::vector<std::string> readPragmas_;
+
+    std::vector<std::unique_ptr<ReadSession>> readSessions_;
+    std::atomic<std::size_t> nextRead_ {0};
+    std::unique_ptr<Readers> readers_;
+
+    Waits writeWaits_;
+    Waits readWaits_;
+
+    mutable std::mutex latencyLock_;
+    std::map<std::string, Latencies> latencies_;
 };
 
 DatabaseCon::Setup
@@ -349,6 +349,13 @@ void Config::loadFromString (std::string const& fileContents)
     if (getSingleSection (secConfig, SECTION_ELB_SUPPORT, strTemp, j_))
         ELB_SUPPORT         = beast::lexicalCastThrow <bool> (strTemp);
 
+    if (getSingleSection (secConfig, SECTION_ACCOUNT_TX_INDEX, strTemp, j_))
+        ACCOUNT_TX_INDEX    = beast::lexicalCastThrow <bool> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_SAVE_UNTRUSTED_VALIDATIONS,
+            strTemp, j_))
+        SAVE_UNTRUSTED_VALIDATIONS = beast::lexicalCastThrow <bool> (strTemp);
+
     if (getSingleSection (secConfig, SECTION_WEBSOCKET_PING_FREQ, strTemp, j_))
         WEBSOCKET_PING_FREQ = std::chrono::seconds{beast::lexicalCastThrow <int>(strTemp)};
 
@@ -410,6 +417,15 @@ void Config::loadFromString (std::string const& fileContents)
     if (getSingleSection (secConfig, SECTION_PATH_SEARCH_MAX, strTemp, j_))
         PATH_SEARCH_MAX     = beast::lexicalCastThrow <int> (strTemp);
 
+    if (getSingleSection (secConfig, SECTION_PARALLEL_APPLY, strTemp, j_))
+        PARALLEL_APPLY      = beast::lexicalCastThrow <std::size_t> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_PARALLEL_STRANDS, strTemp, j_))
+        PARALLEL_STRANDS    = beast::lexicalCastThrow <std::size_t> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_DATABASE_READERS, strTemp, j_))
+        DATABASE_READERS    = beast::lexicalCastThrow <std::size_t> (strTemp);
+
     if (getSingleSection (secConfig, SECTION_DEBUG_LOGFILE, strTemp, j_))
         DEBUG_LOGFILE       = strTemp;
 
@@ -22,10 +22,156 @@
 #include <ripple/core/SociDB.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/Log.h>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <memory>
+#include <thread>
 
 namespace ripple {
 
+// Whether an init string is a pragma which only affects writing,
+// or the database file rather than the connection
+static
+bool
+writePragma (std::string const& s)
+{
+    for (auto const name : {
+        "PRAGMA synchronous",
+        "PRAGMA journal_mode",
+        "PRAGMA journal_size_limit",
+        "PRAGMA max_page_count" })
+    {
+        if (s.compare (0, std::strlen (name), name) == 0)
+            return true;
+    }
+    return false;
+}
+
+// Threads running queued queries
+class DatabaseCon::Readers
+{
+public:
+    Readers (std::size_t threads);
+
+    ~Readers ();
+
+    // Whether the calling thread is one of ours
+    bool
+    current () const
+    {
+        return current_ == this;
+    }
+
+    void
+    post (std::function<void()> task);
+
+private:
+    void
+    run ();
+
+    static thread_local Readers const* current_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    bool stop_ = false;
+
+    std::vector<std::thread> threads_;
+};
+
+thread_local DatabaseCon::Readers const*
+    DatabaseCon::Readers::current_ = nullptr;
+
+DatabaseCon::Readers::Readers (std::size_t threads)
+{
+    for (std::size_t i = 0; i < threads; ++i)
+        threads_.emplace_back (&Readers::run, this);
+}
+
+DatabaseCon::Readers::~Readers ()
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all ();
+    for (auto& t : threads_)
+        t.join ();
+}
+
+void
+DatabaseCon::Readers::post (std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        tasks_.push_back (std::move (task));
+    }
+    cv_.notify_one ();
+}
+
+void
+DatabaseCon::Readers::run ()
+{
+    current_ = this;
+
+    std::unique_lock<std::mutex> lock (mutex_);
+    for (;;)
+    {
+        // Queued tasks run even when stopping, since
+        // their coroutines wait for them
+        cv_.wait (lock, [this]{ return stop_ || ! tasks_.empty (); });
+        if (tasks_.empty ())
+            break;
+
+        auto task = std::move (tasks_.front ());
+        tasks_.pop_front ();
+
+        lock.unlock ();
+        task ();
+        lock.lock ();
+    }
+
+    current_ = nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+void
+DatabaseCon::Waits::wait (LockedSociSession::mutex& m,
+    std::unique_lock<LockedSociSession::mutex>& lock)
+{
+    using namespace std::chrono;
+
+    ++checkouts;
+    lock = std::unique_lock<LockedSociSession::mutex> (m, std::try_to_lock);
+    if (lock)
+        return;
+
+    auto const start = steady_clock::now ();
+    lock.lock ();
+    ++waits;
+    waitMicroseconds += duration_cast<microseconds> (
+        steady_clock::now () - start).count ();
+}
+
+Json::Value
+DatabaseCon::Waits::getJson () const
+{
+    Json::Value ret (Json::objectValue);
+    ret["checkouts"] = static_cast<Json::UInt> (checkouts.load ());
+    ret["waits"] = static_cast<Json::UInt> (waits.load ());
+    ret["wait_us"] = static_cast<Json::UInt> (waitMicroseconds.load ());
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+
+thread_local std::vector<
+    std::pair<DatabaseCon const*, DatabaseCon::ReadSession*>>
+        DatabaseCon::pinned_;
+
 DatabaseCon::DatabaseCon (
     Setup const& setup,
     std::string const& strName,
@@ -41,6 +187,7 @@ DatabaseCon::DatabaseCon (
         ? "" : (setup.dataDir / strName);
 
     open (session_, "sqlite", pPath.string());
+    path_ = pPath;
 
     for (int i = 0; i < initCount; ++i)
     {
@@ -54,7 +201,187 @@ DatabaseCon::DatabaseCon (
         {
             // ignore errors
         }
+
+        std::string const init = initStrings[i];
+        if (init.compare (0, 7, "PRAGMA ") == 0 && ! writePragma (init))
+            readPragmas_.push_back (init);
+    }
+}
+
+DatabaseCon::~DatabaseCon ()
+{
+    // Finish the queries before closing their sessions
+    readers_.reset ();
+}
+
+auto
+DatabaseCon::pinned () const -> ReadSession*
+{
+    for (auto const& p : pinned_)
+    {
+        if (p.first == this)
+            return p.second;
     }
+    return nullptr;
+}
+
+LockedSociSession
+DatabaseCon::checkoutDb ()
+{
+    if (auto const s = pinned ())
+        return LockedSociSession (&s->session, s->lock);
+
+    std::unique_lock<LockedSociSession::mutex> lock;
+    writeWaits_.wait (lock_, lock);
+    return LockedSociSession (&session_, std::move (lock));
+}
+
+LockedSociSession
+DatabaseCon::checkoutRead ()
+{
+    if (auto const s = pinned ())
+        return LockedSociSession (&s->session, s->lock);
+
+    if (readSessions_.empty ())
+        return checkoutDb ();
+
+    auto r = lockRead ();
+    return LockedSociSession (&r.first->session, std::move (r.second));
+}
+
+auto
+DatabaseCon::lockRead () ->
+    std::pair<ReadSession*, std::unique_lock<LockedSociSession::mutex>>
+{
+    // Try the sessions after the first one, then wait for
+    // the first one if those are all in use
+    auto const n = readSessions_.size ();
+    auto const first = nextRead_++;
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        auto& s = *readSessions_[(first + i) % n];
+        std::unique_lock<LockedSociSession::mutex> lock (
+            s.lock, std::try_to_lock);
+        if (lock)
+        {
+            ++readWaits_.checkouts;
+            return {&s, std::move (lock)};
+        }
+    }
+
+    auto& s = *readSessions_[first % n];
+    std::unique_lock<LockedSociSession::mutex> lock;
+    readWaits_.wait (s.lock, lock);
+    return {&s, std::move (lock)};
+}
+
+void
+DatabaseCon::runRead (std::function<void(soci::session&)> const& query)
+{
+    if (readSessions_.empty () || pinned ())
+    {
+        auto db = checkoutRead ();
+        query (*db);
+        return;
+    }
+
+    // Checkouts made by the query return its session
+    auto r = lockRead ();
+    pinned_.emplace_back (this, r.first);
+    try
+    {
+        query (r.first->session);
+    }
+    catch (...)
+    {
+        pinned_.pop_back ();
+        throw;
+    }
+    pinned_.pop_back ();
+}
+
+void
+DatabaseCon::read (std::string const& name,
+    std::shared_ptr<JobQueue::Coro> const& coro,
+    std::function<void(soci::session&)> const& query)
+{
+    auto const start = std::chrono::steady_clock::now ();
+
+    if (! coro || ! readers_ || readers_->current ())
+    {
+        try
+        {
+            runRead (query);
+        }
+        catch (std::exception const&)
+        {
+            addLatency (name, start);
+            throw;
+        }
+        addLatency (name, start);
+        return;
+    }
+
+    std::exception_ptr error;
+    readers_->post ([&]()
+    {
+        try
+        {
+            runRead (query);
+        }
+        catch (...)
+        {
+            error = std::current_exception ();
+        }
+        addLatency (name, start);
+        coro->post ();
+    });
+    coro->yield ();
+
+    if (error)
+        std::rethrow_exception (error);
+}
+
+void
+DatabaseCon::addLatency (std::string const& name,
+    std::chrono::steady_clock::time_point start)
+{
+    using namespace std::chrono;
+    auto const elapsed = duration_cast<milliseconds> (
+        steady_clock::now () - start).count ();
+
+    std::size_t bucket = 0;
+    while (bucket + 1 < std::tuple_size<Latencies>::value &&
+            elapsed >= (1 << bucket))
+        ++bucket;
+
+    std::lock_guard<std::mutex> lock (latencyLock_);
+    ++latencies_[name][bucket];
+}
+
+Json::Value
+DatabaseCon::getReadJson () const
+{
+    Json::Value ret (Json::objectValue);
+
+    std::lock_guard<std::mutex> lock (latencyLock_);
+    for (auto const& query : latencies_)
+    {
+        auto& buckets = (ret[query.first] = Json::arrayValue);
+        for (auto const count : query.second)
+            buckets.append (static_cast<Json::UInt> (count));
+    }
+    return ret;
+}
+
+Json::Value
+DatabaseCon::getCheckoutJson () const
+{
+    Json::Value ret (Json::objectValue);
+    ret["write"] = writeWaits_.getJson ();
+    if (! readSessions_.empty ())
+        ret["read"] = readWaits_.getJson ();
+    return ret;
 }
 
 DatabaseCon::Setup setup_DatabaseCon (Config const& c)
@@ -80,4 +407,35 @@ void DatabaseCon::setupCheckpointing (JobQueue* q, Logs& l)
     checkpointer_ = makeCheckpointer (session_, *q, l);
 }
 
+void DatabaseCon::setupReaders (std::size_t sessions, Logs& l)
+{
+    if (sessions == 0 || path_.empty ())
+        return;
+
+    for (std::size_t i = 0; i < sessions; ++i)
+    {
+        auto s = std::make_unique<ReadSession> ();
+        open (s->session, "sqlite", path_.string ());
+
+        // The main session is the only writer
+        s->session << "PRAGMA query_only=ON;";
+        for (auto const& pragma : readPragmas_)
+        {
+            try
+            {
+                s->session << pragma;
+            }
+            catch (soci::soci_error&)
+            {
+                // ignore errors, as the main session does
+            }
+        }
+        readSessions_.push_back (std::move (s));
+    }
+    readers_ = std::make_unique<Readers> (sessions);
+
+    JLOG (l.journal ("DatabaseCon").debug()) <<
+        "Opened " << sessions << " read sessions of " << path_.string ();
+}
+
 } // ripple
@@ -21,9 +21,16 @@
 #include <ripple/basics/contract.h>
 #include <ripple/json/json_reader.h>
 #include <algorithm>
+#include <cstdlib>
 #include <string>
 #include <cctype>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RIPPLE_JSON_READER_SSE2 1
+#endif
+
 namespace Json
 {
 // Implementation of class Reader
@@ -67,6 +74,37 @@ codePointToUTF8 (unsigned int cp)
     return result;
 }
 
+// Returns the first quote or backslash in [first, last), or last.
+// Nearly all of a request is string contents, so this is the inner loop.
+static
+Reader::Location
+findQuoteOrEscape (Reader::Location first, Reader::Location last)
+{
+#ifdef RIPPLE_JSON_READER_SSE2
+    auto const quote = _mm_set1_epi8 ('"');
+    auto const escape = _mm_set1_epi8 ('\\');
+
+    while (last - first >= 16)
+    {
+        auto const chunk = _mm_loadu_si128 (
+            reinterpret_cast<__m128i const*> (first));
+        auto const found = _mm_or_si128 (
+            _mm_cmpeq_epi8 (chunk, quote),
+            _mm_cmpeq_epi8 (chunk, escape));
+
+        if (_mm_movemask_epi8 (found) != 0)
+            break;
+
+        first += 16;
+    }
+#endif
+
+    while (first != last && *first != '"' && *first != '\\')
+        ++first;
+
+    return first;
+}
+
 
 // Class Reader
 // //////////////////////////////////////////////////////////////////
@@ -378,8 +416,6 @@ Reader::readCppStyleComment ()
 Reader::TokenType
 Reader::readNumber ()
 {
-    static char const extended_tokens[] = { '.', 'e', 'E', '+', '-' };
-
     TokenType type = tokenInteger;
 
     if ( current_ != end_ )
@@ -389,12 +425,12 @@ Reader::readNumber ()
 
         while ( current_ != end_ )
         {
-            if (!std::isdigit (*current_))
-            {
-                auto ret = std::find (std::begin (extended_tokens),
-                    std::end (extended_tokens), *current_);
+            Char const c = *current_;
 
-                if (ret == std::end (extended_tokens))
+            if ( c < '0'  ||  c > '9' )
+            {
+                if ( c != '.'  &&  c != 'e'  &&  c != 'E'  &&
+                        c != '+'  &&  c != '-' )
                     break;
 
                 type = tokenDouble;
@@ -410,19 +446,22 @@ Reader::readNumber ()
 bool
 Reader::readString ()
 {
-    Char c = 0;
-
     while ( current_ != end_ )
     {
-        c = getNextChar ();
+        current_ = findQuoteOrEscape ( current_, end_ );
 
-        if ( c == '\\' )
-            getNextChar ();
-        else if ( c == '"' )
+        if ( current_ == end_ )
             break;
+
+        if ( *current_++ == '"' )
+            return true;
+
+        // Skip the escaped character
+        if ( current_ != end_ )
+            ++current_;
     }
 
-    return c == '"';
+    return false;
 }
 
 
@@ -464,10 +503,13 @@ Reader::readObject ( Token& tokenStart )
         }
 
         // Reject duplicate names
-        if (currentValue ().isMember (name))
+        Value& object = currentValue ();
+        auto const size = object.size ();
+        Value& value = object[ name ];
+
+        if ( object.size () == size )
             return addError ( "Key '" + name + "' appears twice.", tokenName );
 
-        Value& value = currentValue ()[ name ];
         nodes_.push ( &value );
         bool ok = readValue ();
         nodes_.pop ();
@@ -631,31 +673,27 @@ Reader::decodeDouble( Token &token )
 {
     double value = 0;
     const int bufferSize = 32;
-    int count;
     int length = int(token.end_ - token.start_);
     // Sanity check to avoid buffer overflow exploits.
     if (length < 0) {
         return addError( "Unable to parse token length", token );
     }
-    // Avoid using a string constant for the format control string given to
-    // sscanf, as this can cause hard to debug crashes on OS X. See here for more
-    // info:
-    //
-    // http://developer.apple.com/library/mac/#DOCUMENTATION/DeveloperTools/gcc-4.0.1/gcc/Incompatibilities.html
-    char format[] = "%lf";
+    char* parsed;
     if ( length <= bufferSize )
     {
         Char buffer[bufferSize+1];
         memcpy( buffer, token.start_, length );
         buffer[length] = 0;
-        count = sscanf( buffer, format, &value );
+        value = std::strtod( buffer, &parsed );
+        parsed = parsed == buffer ? nullptr : parsed;
     }
     else
     {
         std::string buffer( token.start_, token.end_ );
-        count = sscanf( buffer.c_str(), format, &value );
+        value = std::strtod( buffer.c_str(), &parsed );
+        parsed = parsed == buffer.c_str() ? nullptr : parsed;
     }
-    if ( count != 1 )
+    if ( ! parsed )
         return addError( "'" + std::string( token.start_, token.end_ ) + "' is not a number.", token );
     currentValue() = value;
     return true;
@@ -666,6 +704,16 @@ Reader::decodeDouble( Token &token )
 bool
 Reader::decodeString ( Token& token )
 {
+    Location const begin = token.start_ + 1; // skip '"'
+    Location const end = token.end_ - 1;     // do not include '"'
+
+    // Without escapes the value is copied straight from the document
+    if ( findQuoteOrEscape ( begin, end ) == end )
+    {
+        currentValue () = Value ( begin, end );
+        return true;
+    }
+
     std::string decoded;
 
     if ( !decodeString ( token, decoded ) )
@@ -685,6 +733,14 @@ Reader::decodeString ( Token& token, std::string& decoded )
 
     while ( current != end )
     {
+        // Copy everything up to the next escape at once
+        Location const run = findQuoteOrEscape ( current, end );
+        decoded.append ( current, run );
+        current = run;
+
+        if ( current == end )
+            break;
+
         Char c = *current++;
 
         if ( c == '"' )
@@ -745,10 +801,6 @@ Reader::decodeString ( Token& token, std::string& decoded )
                 return addError ( "Bad escape sequence in string", token, current );
             }
         }
-        else
-        {
-            decoded += c;
-        }
     }
 
     return true;
@@ -19,10 +19,13 @@
 
 #include <BeastConfig.h>
 #include <ripple/basics/contract.h>
+#include <ripple/basics/LocalValue.h>
+#include <ripple/basics/qalloc.h>
 #include <ripple/json/impl/json_assert.h>
 #include <ripple/json/to_string.h>
 #include <ripple/json/json_writer.h>
 #include <ripple/beast/core/LexicalCast.h>
+#include <atomic>
 
 namespace Json {
 
@@ -89,6 +92,232 @@ static struct DummyValueAllocatorInitializer
     }
 } dummyValueAllocatorInitializer;
 
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// class ScopedArena
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// An arena and the trees allocated from it are used by one coroutine
+// or thread at a time (see ScopedArena), so nothing here is locked.
+class Arena
+{
+public:
+    void* allocate ( std::size_t bytes, std::size_t align )
+    {
+        return impl_.allocate ( bytes, align );
+    }
+
+    void deallocate ( void* p )
+    {
+        impl_.deallocate ( p );
+    }
+
+    // The ScopedArena which made the arena and each container using
+    // it hold a reference.
+    void retain ()
+    {
+        ++refs_;
+    }
+
+    void release ()
+    {
+        if ( --refs_ == 0 )
+            delete this;
+    }
+
+private:
+    std::size_t refs_ = 1;
+    ripple::detail::qalloc_impl<> impl_;
+};
+
+void* arenaAllocate ( Arena& arena, std::size_t bytes, std::size_t align )
+{
+    return arena.allocate ( bytes, align );
+}
+
+void arenaDeallocate ( Arena& arena, void* p )
+{
+    arena.deallocate ( p );
+}
+
+// Number of ScopedArena in existence, so objects created when there
+// are none don't pay for the coroutine local lookup.
+static std::atomic<int> activeArenas ( 0 );
+
+static ripple::LocalValue<Arena*>&
+localArena ()
+{
+    static ripple::LocalValue<Arena*> arena ( nullptr );
+    return arena;
+}
+
+Arena* currentArena ()
+{
+    if ( activeArenas.load ( std::memory_order_relaxed ) == 0 )
+        return nullptr;
+    return *localArena ();
+}
+
+} // detail
+
+ScopedArena::ScopedArena ()
+{
+    ++detail::activeArenas;
+    auto& arena = *detail::localArena ();
+    saved_ = arena;
+    arena = new detail::Arena;
+}
+
+ScopedArena::~ScopedArena ()
+{
+    auto& arena = *detail::localArena ();
+    arena->release ();
+    arena = saved_;
+    --detail::activeArenas;
+}
+
+static Value::ObjectValues* newObjectValues ()
+{
+    detail::ArenaAllocator<Value::ObjectValues> alloc (
+        detail::currentArena ());
+    auto const p = alloc.allocate ( 1 );
+    try
+    {
+        new ( p ) Value::ObjectValues ( alloc );
+        if ( alloc.arena () )
+            alloc.arena ()->retain ();
+        return p;
+    }
+    catch ( ... )
+    {
+        alloc.deallocate ( p, 1 );
+        throw;
+    }
+}
+
+static Value::ObjectValues* newObjectValues (
+    Value::ObjectValues const& other )
+{
+    detail::ArenaAllocator<Value::ObjectValues> alloc (
+        detail::currentArena ());
+    auto const p = alloc.allocate ( 1 );
+    try
+    {
+        new ( p ) Value::ObjectValues ( other, alloc );
+        if ( alloc.arena () )
+            alloc.arena ()->retain ();
+        return p;
+    }
+    catch ( ... )
+    {
+        alloc.deallocate ( p, 1 );
+        throw;
+    }
+}
+
+static void deleteObjectValues ( Value::ObjectValues* map )
+{
+    using ObjectValues = Value::ObjectValues;
+    detail::ArenaAllocator<Value::ObjectValues> alloc (
+        map->get_allocator ());
+    map->~ObjectValues ();
+    alloc.deallocate ( map, 1 );
+    if ( alloc.arena () )
+        alloc.arena ()->release ();
+}
+
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// Member name interning
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+
+// Remembers the StaticString member names seen so far, which in practice
+// are the jss:: field names, so that member names parsed from text or
+// given as std::string can share them instead of being duplicated.
+//
+// Entries are never removed and the table is filled to at most half of
+// its capacity, after which new names are not remembered. Readers never
+// lock, writers claim an empty slot with a compare and swap.
+class InternedNames
+{
+    enum
+    {
+        capacity = 2048
+    };
+
+    std::atomic<const char*> slots_[capacity];
+    std::atomic<int> size_;
+
+    static std::size_t hash ( const char* s )
+    {
+        // FNV-1a
+        std::size_t h = 2166136261u;
+        for (; *s; ++s)
+            h = ( h ^ static_cast<unsigned char> ( *s ) ) * 16777619u;
+        return h;
+    }
+
+public:
+    InternedNames ()
+        : size_ ( 0 )
+    {
+        for ( auto& slot : slots_ )
+            slot.store ( nullptr, std::memory_order_relaxed );
+    }
+
+    void insert ( const char* name )
+    {
+        for ( auto i = hash ( name );; ++i )
+        {
+            auto& slot = slots_[i % capacity];
+            auto current = slot.load ( std::memory_order_acquire );
+            if ( current == name )
+                return;
+            if ( ! current )
+            {
+                if ( size_.load ( std::memory_order_relaxed ) >=
+                        capacity / 2 )
+                    return;
+                if ( slot.compare_exchange_strong ( current, name,
+                        std::memory_order_acq_rel ) )
+                {
+                    ++size_;
+                    return;
+                }
+            }
+            if ( strcmp ( current, name ) == 0 )
+                return;
+        }
+    }
+
+    const char* find ( const char* name ) const
+    {
+        for ( auto i = hash ( name );; ++i )
+        {
+            auto const current =
+                slots_[i % capacity].load ( std::memory_order_acquire );
+            if ( ! current )
+                return nullptr;
+            if ( strcmp ( current, name ) == 0 )
+                return current;
+        }
+    }
+};
+
+static InternedNames& internedNames ()
+{
+    static InternedNames names;
+    return names;
+}
+
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
@@ -107,19 +336,40 @@ Value::CZString::CZString ( int index )
 }
 
 Value::CZString::CZString ( const char* cstr, DuplicationPolicy allocate )
-    : cstr_ ( allocate == duplicate ? valueAllocator ()->makeMemberName (cstr)
-              : cstr )
+    : cstr_ ( cstr )
     , index_ ( allocate )
 {
+    if ( allocate == duplicate )
+    {
+        if ( auto const interned = internedNames ().find ( cstr ) )
+        {
+            cstr_ = interned;
+            index_ = noDuplication;
+        }
+        else
+        {
+            cstr_ = valueAllocator ()->makeMemberName ( cstr );
+        }
+    }
 }
 
 Value::CZString::CZString ( const CZString& other )
-    : cstr_ ( other.index_ != noDuplication&&   other.cstr_ != 0
-              ?  valueAllocator ()->makeMemberName ( other.cstr_ )
-              : other.cstr_ )
-    , index_ ( other.cstr_ ? (other.index_ == noDuplication ? noDuplication : duplicate)
-               : other.index_ )
+    : cstr_ ( other.cstr_ )
+    , index_ ( other.index_ )
 {
+    if ( cstr_ && index_ != noDuplication )
+    {
+        if ( auto const interned = internedNames ().find ( cstr_ ) )
+        {
+            cstr_ = interned;
+            index_ = noDuplication;
+        }
+        else
+        {
+            cstr_ = valueAllocator ()->makeMemberName ( cstr_ );
+            index_ = duplicate;
+        }
+    }
 }
 
 Value::CZString::~CZString ()
@@ -217,7 +467,7 @@ Value::Value ( ValueType type )
 
     case arrayValue:
     case objectValue:
-        value_.map_ = new ObjectValues ();
+        value_.map_ = newObjectValues ();
         break;
 
     case booleanValue:
@@ -316,7 +566,7 @@ Value::Value ( const Value& other )
 
     case arrayValue:
     case objectValue:
-        value_.map_ = new ObjectValues ( *other.value_.map_ );
+        value_.map_ = newObjectValues ( *other.value_.map_ );
         break;
 
     default:
@@ -344,7 +594,7 @@ Value::~Value ()
 
     case arrayValue:
     case objectValue:
-        delete value_.map_;
+        deleteObjectValues ( value_.map_ );
         break;
 
     default:
@@ -839,8 +1089,7 @@ Value::operator[] ( UInt index )
     if ( it != value_.map_->end ()  &&  (*it).first == key )
         return (*it).second;
 
-    ObjectValues::value_type defaultValue ( key, null );
-    it = value_.map_->insert ( it, defaultValue );
+    it = value_.map_->emplace_hint ( it, key, null );
     return (*it).second;
 }
 
@@ -886,10 +1135,11 @@ Value::resolveReference ( const char* key,
     if ( it != value_.map_->end ()  &&  (*it).first == actualKey )
         return (*it).second;
 
-    ObjectValues::value_type defaultValue ( actualKey, null );
-    it = value_.map_->insert ( it, defaultValue );
-    Value& value = (*it).second;
-    return value;
+    if ( isStatic )
+        internedNames ().insert ( key );
+
+    it = value_.map_->emplace_hint ( it, actualKey, null );
+    return (*it).second;
 }
 
 
@@ -953,6 +1203,12 @@ Value::append ( const Value& value )
     return (*this)[size ()] = value;
 }
 
+Value&
+Value::append ( Value&& value )
+{
+    return (*this)[size ()] = std::move ( value );
+}
+
 
 Value
 Value::get ( const char* key,
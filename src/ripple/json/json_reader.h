@@ -26,6 +26,7 @@
 #include <ripple/json/json_value.h>
 #include <boost/asio/buffer.hpp>
 #include <stack>
+#include <vector>
 
 namespace Json
 {
@@ -117,7 +118,7 @@ private:
         Location extra_;
     };
 
-    using Errors = std::deque<ErrorInfo>;
+    using Errors = std::vector<ErrorInfo>;
 
     bool expectToken ( TokenType type, Token& token, const char* message );
     bool readToken ( Token& token );
@@ -160,7 +161,7 @@ private:
     std::string getLocationLineAndColumn ( Location location ) const;
     void skipCommentTokens ( Token& token );
 
-    using Nodes = std::stack<Value*>;
+    using Nodes = std::stack<Value*, std::vector<Value*>>;
     Nodes nodes_;
     Errors errors_;
     std::string document_;
@@ -176,11 +177,11 @@ bool
 Reader::parse(Value& root, BufferSequence const& bs)
 {
     using namespace boost::asio;
-    std::string s;
-    s.reserve (buffer_size(bs));
+    document_.clear ();
+    document_.reserve (buffer_size(bs));
     for (auto const& b : bs)
-        s.append(buffer_cast<char const*>(b), buffer_size(b));
-    return parse(s, root);
+        document_.append(buffer_cast<char const*>(b), buffer_size(b));
+    return parse(document_.data(), document_.data() + document_.size(), root);
 }
 
 /** \brief Read from 'sin' into 'root'.
@@ -21,10 +21,14 @@
 #define RIPPLE_JSON_JSON_VALUE_H_INCLUDED
 
 #include <ripple/json/json_forwards.h>
+#include <cstddef>
 #include <cstring>
 #include <functional>
 #include <map>
+#include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 /** \brief JSON (JavaScript Object Notation).
@@ -67,6 +71,10 @@ enum CommentPlacement
  * static const StaticString code("code");
  * object[code] = 1234;
  * \endcode
+ *
+ * A StaticString used as a member name must point to storage which lives
+ * for the rest of the program, since other member names with the same
+ * text are stored as a pointer to it (see Value::CZString).
  */
 class StaticString
 {
@@ -122,6 +130,146 @@ inline bool operator!= (StaticString x, std::string const& y)
     return ! (y == x);
 }
 
+namespace detail {
+
+class Arena;
+
+void* arenaAllocate ( Arena& arena, std::size_t bytes, std::size_t align );
+void arenaDeallocate ( Arena& arena, void* p );
+
+/** Returns the arena of the innermost ScopedArena on this coroutine or
+    thread, or nullptr if there is none.
+*/
+Arena* currentArena ();
+
+/** Allocator for the storage of objects and arrays.
+
+    Allocates from an Arena if it has one, and from the heap otherwise.
+    Copies of a container pick the arena which is current where the copy
+    is made, so a tree copied out of a ScopedArena goes to the heap.
+
+    The allocator does not keep the arena alive. The containers which
+    use it do, so copying the allocator costs no more than a pointer.
+*/
+template <class T>
+class ArenaAllocator
+{
+private:
+    template <class>
+    friend class ArenaAllocator;
+
+    Arena* arena_ = nullptr;
+
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <class U>
+    struct rebind
+    {
+        using other = ArenaAllocator<U>;
+    };
+
+    ArenaAllocator () = default;
+
+    explicit
+    ArenaAllocator ( Arena* arena )
+        : arena_ ( arena )
+    {
+    }
+
+    template <class U>
+    ArenaAllocator ( ArenaAllocator<U> const& other )
+        : arena_ ( other.arena_ )
+    {
+    }
+
+    T* allocate ( std::size_t n )
+    {
+        if ( ! arena_ )
+            return std::allocator<T> ().allocate ( n );
+        if ( n > std::size_t (-1) / sizeof (T) )
+            throw std::bad_alloc ();
+        return static_cast<T*> ( arenaAllocate (
+            *arena_, n * sizeof (T), std::alignment_of<T>::value ) );
+    }
+
+    void deallocate ( T* p, std::size_t n )
+    {
+        if ( ! arena_ )
+            std::allocator<T> ().deallocate ( p, n );
+        else
+            arenaDeallocate ( *arena_, p );
+    }
+
+    Arena* arena () const
+    {
+        return arena_;
+    }
+
+    ArenaAllocator select_on_container_copy_construction () const
+    {
+        return ArenaAllocator ( currentArena () );
+    }
+
+    template <class U>
+    bool operator== ( ArenaAllocator<U> const& other ) const
+    {
+        return arena_ == other.arena_;
+    }
+
+    template <class U>
+    bool operator!= ( ArenaAllocator<U> const& other ) const
+    {
+        return ! ( *this == other );
+    }
+};
+
+} // detail
+
+/** Allocates objects and arrays from an arena while in scope.
+
+    RPC handlers build large trees which are serialized once and then
+    destroyed. While a ScopedArena exists, every object and array created
+    on the same coroutine or thread gets its storage from a shared arena
+    instead of one heap allocation per member, and releasing the tree
+    returns whole blocks at once.
+
+    The arena stays alive until the last Value allocated from it is
+    destroyed, so a tree may safely outlive the scope. Holding on to a
+    small part of such a tree keeps its arena block allocated, so long
+    lived copies should be made after the scope ends.
+
+    An arena is not locked. Its trees belong to one coroutine or thread
+    at a time, and are handed to another one as a whole, such as the
+    result of a handler which the server then writes. A part that
+    another thread will use while the owner still uses the rest must be
+    copied outside of any ScopedArena first, which puts the copy on the
+    heap.
+
+    Example:
+    \code
+    Json::Value result;
+    {
+        Json::ScopedArena arena;
+        result = buildLargeTree ();
+    }
+    \endcode
+*/
+class ScopedArena
+{
+public:
+    ScopedArena ();
+    ~ScopedArena ();
+
+    ScopedArena ( ScopedArena const& ) = delete;
+    ScopedArena& operator= ( ScopedArena const& ) = delete;
+
+private:
+    detail::Arena* saved_;
+};
+
 /** \brief Represents a <a HREF="http://www.json.org">JSON</a> value.
  *
  * This class is a discriminated union wrapper that can represent a:
@@ -167,6 +315,8 @@ public:
     static const UInt maxUInt;
 
 private:
+    // Member names which have the same text as a StaticString already used
+    // as a member name are stored as a pointer to it instead of a copy.
     class CZString
     {
     public:
@@ -193,7 +343,8 @@ private:
     };
 
 public:
-    using ObjectValues = std::map<CZString, Value>;
+    using ObjectValues = std::map<CZString, Value, std::less<CZString>,
+        detail::ArenaAllocator<std::pair<const CZString, Value>>>;
 
 public:
     /** \brief Create a default Value of the given type.
@@ -307,6 +458,7 @@ public:
     ///
     /// Equivalent to jsonvalue[jsonvalue.size()] = value;
     Value& append ( const Value& value );
+    Value& append ( Value&& value );
 
     /// Access an object value by name, create a null member if it does not exist.
     Value& operator[] ( const char* key );
@@ -112,7 +112,7 @@ ApplyStateTable::apply (OpenView& to,
 {
     // Build metadata and insert
     auto const sTx =
-        std::make_shared<Serializer>();
+        std::make_shared<Serializer>(tx.serializedSize());
     tx.add(*sTx);
     std::shared_ptr<Serializer> sMeta;
     if (!to.open())
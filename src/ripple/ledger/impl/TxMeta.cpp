@@ -264,7 +264,9 @@ void TxMeta::addRaw (Serializer& s, TER result, std::uint32_t index)
 
     mNodes.sort (compare);
 
-    getAsObject ().add (s);
+    auto const object = getAsObject ();
+    s.reserve (s.size () + object.serializedSize ());
+    object.add (s);
 }
 
 } // ripple
@@ -1027,6 +1027,7 @@ public:
     //      {   "ledger_entry",         &RPCParser::parseLedgerEntry,          -1, -1   },
             {   "ledger_header",        &RPCParser::parseLedgerId,              1,  1   },
             {   "ledger_request",       &RPCParser::parseLedgerId,              1,  1   },
+            {   "ledger_snapshot",      &RPCParser::parseLedger,                0,  1   },
             {   "log_level",            &RPCParser::parseLogLevel,              0,  2   },
             {   "logrotate",            &RPCParser::parseAsIs,                  0,  0   },
             {   "owner_info",           &RPCParser::parseAccountItems,          1,  2   },
@@ -116,6 +116,13 @@ public:
                         Blob&& data,
                         uint256 const& hash) = 0;
 
+    /** Store a batch of objects directly in the backend.
+
+        The objects are not added to the cache. This is meant for loading
+        many objects at once, as from a ledger snapshot.
+    */
+    virtual void storeBatch (Batch const& batch) = 0;
+
     /** Visit every object in the database
         This is usually called during import.
 
@@ -21,12 +21,19 @@
 #define RIPPLE_NODESTORE_NODEOBJECT_H_INCLUDED
 
 #include <ripple/basics/CountedObject.h>
+#include <ripple/basics/Slice.h>
 #include <ripple/protocol/Protocol.h>
+#include <cstdint>
+#include <memory>
 
 // VFALCO NOTE Intentionally not in the NodeStore namespace
 
 namespace ripple {
 
+namespace NodeStore {
+class DecodedBlob;
+}
+
 /** The types of node objects. */
 enum NodeObjectType
 {
@@ -43,6 +50,9 @@ enum NodeObjectType
     the blob. The blob is a variable length block of serialized data. The
     type identifies what the blob contains.
 
+    The header and the blob share a single allocation with the shared_ptr
+    control block, so each object costs exactly one trip to the allocator.
+
     @note No checking is performed to make sure the hash matches the data.
     @see SHAMap
 */
@@ -64,25 +74,48 @@ public:
 
 private:
     // This hack is used to make the constructor effectively private
-    // except for when we use it in the call to make_shared.
-    // There's no portable way to make make_shared<> a friend work.
+    // except for when we use it in the call to allocate_shared.
+    // There's no portable way to make allocate_shared<> a friend work.
     struct PrivateAccess { };
+
+    friend class NodeStore::DecodedBlob;
+
 public:
     // This constructor is private, use createObject instead.
+    //
+    // The storage pointer is taken by reference because it is only
+    // known once allocate_shared has obtained the memory block.
     NodeObject (NodeObjectType type,
-                Blob&& data,
                 uint256 const& hash,
+                std::uint8_t* const& storage,
+                std::size_t prefix,
+                std::size_t size,
                 PrivateAccess);
 
+    NodeObject (NodeObject const&) = delete;
+    NodeObject& operator= (NodeObject const&) = delete;
+
     /** Create an object from fields.
 
-        The caller's variable is modified during this call. The
-        underlying storage for the Blob is taken over by the NodeObject.
+        The payload is copied into storage allocated together
+        with the object.
+
+        @param type The type of object.
+        @param data The payload.
+        @param hash The 256-bit hash of the payload data.
+    */
+    static
+    std::shared_ptr<NodeObject>
+    createObject (NodeObjectType type,
+        Slice data, uint256 const& hash);
+
+    /** Create an object from fields.
+
+        The caller's variable is consumed during this call.
 
         @param type The type of object.
-        @param ledgerIndex The ledger in which this object appears.
         @param data A buffer containing the payload. The caller's variable
-                    is overwritten.
+                    is cleared.
         @param hash The 256-bit hash of the payload data.
     */
     static
@@ -97,12 +130,23 @@ public:
     uint256 const& getHash () const;
 
     /** Returns the underlying data. */
-    Blob const& getData () const;
+    Slice getData () const;
 
 private:
+    /** Allocate an object with an uninitialized payload.
+
+        @param prefix The number of scratch bytes to reserve immediately
+                      in front of the payload, in the same allocation.
+    */
+    static
+    std::shared_ptr<NodeObject>
+    allocate (NodeObjectType type, uint256 const& hash,
+        std::size_t size, std::size_t prefix);
+
     NodeObjectType mType;
-    uint256 mHash;
-    Blob mData;
+    uint256 const mHash;
+    std::uint8_t* const mData;
+    std::uint32_t const mSize;
 };
 
 }
@@ -20,9 +20,11 @@
 #include <BeastConfig.h>
 
 #include <ripple/basics/contract.h>
+#include <ripple/basics/Log.h>
 #include <ripple/nodestore/Factory.h>
 #include <ripple/nodestore/Manager.h>
 #include <ripple/nodestore/impl/codec.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
 #include <nudb/nudb.hpp>
@@ -56,6 +58,7 @@ public:
     nudb::store db_;
     std::atomic <bool> deletePath_;
     Scheduler& scheduler_;
+    std::unique_ptr<CompressionDictionary> dict_;
 
     NuDBBackend (int keyBytes, Section const& keyValues,
         Scheduler& scheduler, beast::Journal journal)
@@ -95,6 +98,27 @@ public:
             std::cerr << e.what();
             std::terminate();
         }
+
+        // A dictionary is kept with the database since values which
+        // were compressed with it can't be read back without it.
+        auto const dictPath = folder / "nudb.dict";
+        dict_ = CompressionDictionary::load (dictPath);
+        auto const source =
+            get<std::string>(keyValues, "compression_dictionary");
+        if (! dict_ && ! source.empty())
+        {
+            dict_ = CompressionDictionary::load (source);
+            if (! dict_)
+                Throw<std::runtime_error> (
+                    "nodestore: Missing compression dictionary " + source);
+            dict_->save (dictPath);
+        }
+        if (dict_)
+        {
+            JLOG (journal_.info()) <<
+                "Using compression dictionary " << int(dict_->id()) <<
+                    " (" << dict_->data().size() << " bytes)";
+        }
     }
 
     ~NuDBBackend ()
@@ -131,19 +155,15 @@ public:
         pno->reset();
         nudb::error_code ec;
         db_.fetch (key,
-            [key, pno, &status](void const* data, std::size_t size)
+            [this, key, pno, &status](void const* data, std::size_t size)
             {
-                nudb::detail::buffer bf;
-                auto const result =
-                    nodeobject_decompress(data, size, bf);
-                DecodedBlob decoded (key, result.first, result.second);
-                if (! decoded.wasOk ())
-                {
-                    status = dataCorrupt;
-                    return;
-                }
-                *pno = decoded.createObject();
-                status = ok;
+                *pno = DecodedBlob::decode (key,
+                    [this, data, size](auto&& bf)
+                    {
+                        return nodeobject_decompress(
+                            data, size, bf, dict_.get());
+                    });
+                status = *pno ? ok : dataCorrupt;
             }, ec);
         if(ec == nudb::error::key_not_found)
             return notFound;
@@ -173,7 +193,7 @@ public:
         nudb::error_code ec;
         nudb::detail::buffer bf;
         auto const result = nodeobject_compress(
-            e.getData(), e.getSize(), bf);
+            e.getData(), e.getSize(), bf, dict_.get());
         db_.insert (e.getKey(), result.first, result.second, ec);
         if(ec && ec != nudb::error::key_exists)
             Throw<nudb::system_error>(ec);
@@ -226,16 +246,18 @@ public:
                 void const* data, std::size_t size,
                 nudb::error_code&)
             {
-                nudb::detail::buffer bf;
-                auto const result =
-                    nodeobject_decompress(data, size, bf);
-                DecodedBlob decoded (key, result.first, result.second);
-                if (! decoded.wasOk ())
+                auto object = DecodedBlob::decode (key,
+                    [this, data, size](auto&& bf)
+                    {
+                        return nodeobject_decompress(
+                            data, size, bf, dict_.get());
+                    });
+                if (! object)
                 {
                     ec = make_error_code(nudb::error::missing_value);
                     return;
                 }
-                f (decoded.createObject());
+                f (std::move(object));
             }, nudb::no_progress{}, ec);
         if(ec)
             Throw<nudb::system_error>(ec);
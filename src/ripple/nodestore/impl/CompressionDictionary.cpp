@@ -0,0 +1,225 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
+#include <ripple/basics/contract.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ripple {
+namespace NodeStore {
+
+/*  File format:
+
+    Bytes
+
+    0...3       Magic           The characters "RNDC"
+    4           Identifier      Stored with every compressed value
+    5...end     Dictionary
+*/
+
+static char const magic[4] = { 'R', 'N', 'D', 'C' };
+
+CompressionDictionary::CompressionDictionary (std::uint8_t id, Blob data)
+    : id_ (id)
+    , data_ (std::move (data))
+{
+    if (data_.size () > maxBytes)
+        Throw<std::runtime_error> (
+            "nodestore: compression dictionary too large");
+    LZ4_resetStream (&stream_);
+    LZ4_loadDict (&stream_,
+        reinterpret_cast<char const*>(data_.data ()),
+            static_cast<int>(data_.size ()));
+}
+
+void
+CompressionDictionary::prime (LZ4_stream_t& stream) const
+{
+    std::memcpy (&stream, &stream_, sizeof(stream));
+}
+
+std::unique_ptr<CompressionDictionary>
+CompressionDictionary::load (boost::filesystem::path const& path)
+{
+    if (! boost::filesystem::exists (path))
+        return nullptr;
+
+    std::ifstream in (path.string (), std::ios::in | std::ios::binary);
+    Blob contents {
+        std::istreambuf_iterator<char> (in),
+        std::istreambuf_iterator<char> ()};
+    if (in.bad ())
+        Throw<std::runtime_error> (
+            "nodestore: can't read " + path.string ());
+
+    if (contents.size () < sizeof(magic) + 1 ||
+        std::memcmp (contents.data (), magic, sizeof(magic)) != 0)
+    {
+        Throw<std::runtime_error> (
+            "nodestore: malformed compression dictionary " +
+                path.string ());
+    }
+
+    auto const id = contents[sizeof(magic)];
+    contents.erase (contents.begin (),
+        contents.begin () + sizeof(magic) + 1);
+    return std::make_unique<CompressionDictionary> (
+        id, std::move (contents));
+}
+
+void
+CompressionDictionary::save (boost::filesystem::path const& path) const
+{
+    std::ofstream out (path.string (),
+        std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write (magic, sizeof(magic));
+    out.put (static_cast<char>(id_));
+    out.write (reinterpret_cast<char const*>(data_.data ()), data_.size ());
+    out.flush ();
+    if (! out)
+        Throw<std::runtime_error> (
+            "nodestore: can't write " + path.string ());
+}
+
+//------------------------------------------------------------------------------
+
+std::unique_ptr<CompressionDictionary>
+CompressionDictionary::train (std::uint8_t id,
+    std::vector<Blob> const& samples, std::size_t size)
+{
+    // Matches shorter than this are not worth an lz4 back reference
+    std::size_t const gram = 8;
+    // Length of the segments copied into the dictionary
+    std::size_t const segment = 32;
+
+    size = std::min<std::size_t> (size, maxBytes);
+
+    auto const key = [](std::uint8_t const* p)
+    {
+        std::uint64_t k;
+        std::memcpy (&k, p, sizeof(k));
+        return k;
+    };
+
+    // Count how many samples contain each gram
+    std::unordered_map<std::uint64_t, std::uint32_t> counts;
+    std::size_t total = 0;
+    for (auto const& sample : samples)
+    {
+        total += sample.size ();
+        if (sample.size () < gram)
+            continue;
+        std::unordered_set<std::uint64_t> seen;
+        for (std::size_t i = 0; i + gram <= sample.size (); ++i)
+        {
+            auto const k = key (sample.data () + i);
+            if (seen.insert (k).second)
+                ++counts[k];
+        }
+    }
+
+    Blob data;
+    data.reserve (size);
+
+    // Too little input to choose from, keep all of it
+    if (total <= size)
+    {
+        for (auto const& sample : samples)
+            data.insert (data.end (), sample.begin (), sample.end ());
+        return std::make_unique<CompressionDictionary> (id, std::move (data));
+    }
+
+    // Split the input into one epoch per segment wanted and keep the
+    // best scoring segment of each epoch, where the score is the sum of
+    // the counts of the grams it contains. Grams already in the
+    // dictionary score zero so later picks add new material.
+    auto const epochs = std::max<std::size_t> (1, size / segment);
+    auto const epochBytes = std::max<std::size_t> (segment, total / epochs);
+
+    std::vector<Blob> picked;
+    std::size_t pickedBytes = 0;
+
+    std::size_t epochStart = 0;
+    std::size_t offset = 0;
+    auto sample = samples.begin ();
+    while (pickedBytes < size && sample != samples.end ())
+    {
+        std::size_t bestScore = 0;
+        Blob const* bestSample = nullptr;
+        std::size_t bestPos = 0;
+
+        // Scan the samples which fall in this epoch
+        while (sample != samples.end () &&
+            offset < epochStart + epochBytes)
+        {
+            auto const& s = *sample;
+            if (s.size () >= segment)
+            {
+                std::size_t score = 0;
+                for (std::size_t i = 0; i + gram <= segment; ++i)
+                    score += counts[key (s.data () + i)];
+                for (std::size_t pos = 0;; ++pos)
+                {
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        bestSample = &s;
+                        bestPos = pos;
+                    }
+                    if (pos + segment >= s.size ())
+                        break;
+                    score -= counts[key (s.data () + pos)];
+                    score += counts[key (s.data () + pos + segment - gram + 1)];
+                }
+            }
+            offset += s.size ();
+            ++sample;
+        }
+        epochStart = offset;
+
+        if (! bestSample)
+            continue;
+
+        auto const p = bestSample->data () + bestPos;
+        for (std::size_t i = 0; i + gram <= segment; ++i)
+            counts[key (p + i)] = 0;
+        picked.emplace_back (p, p + segment);
+        pickedBytes += segment;
+    }
+
+    // lz4 finds matches anywhere in the window, order is not significant
+    for (auto const& s : picked)
+    {
+        if (data.size () + s.size () > size)
+            break;
+        data.insert (data.end (), s.begin (), s.end ());
+    }
+
+    return std::make_unique<CompressionDictionary> (id, std::move (data));
+}
+
+}
+}
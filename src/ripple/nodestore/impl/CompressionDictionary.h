@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_COMPRESSIONDICTIONARY_H_INCLUDED
+#define RIPPLE_NODESTORE_COMPRESSIONDICTIONARY_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/Slice.h>
+#include <lz4/lib/lz4.h>
+#include <boost/filesystem/path.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A pre-trained dictionary used to compress leaf node objects.
+
+    Account states and transactions are small serialized objects which
+    share field codes, flags, currency codes and popular accounts, but
+    are rarely large enough to contain repetition of their own. Priming
+    lz4 with a dictionary of those common byte sequences lets it find
+    matches anyway.
+
+    Every value compressed with a dictionary records the dictionary's
+    one byte identifier, so a value is never decoded with the wrong one.
+    The dictionary must remain available for as long as such values
+    exist, so backends keep a copy next to their data files.
+*/
+class CompressionDictionary
+{
+public:
+    enum
+    {
+        /** The largest dictionary lz4 is able to use. */
+        maxBytes = 64 * 1024
+    };
+
+    CompressionDictionary (std::uint8_t id, Blob data);
+
+    CompressionDictionary (CompressionDictionary const&) = delete;
+    CompressionDictionary& operator= (CompressionDictionary const&) = delete;
+
+    /** Returns the identifier stored with each compressed value. */
+    std::uint8_t
+    id () const
+    {
+        return id_;
+    }
+
+    /** Returns the dictionary contents. */
+    Slice
+    data () const
+    {
+        return makeSlice (data_);
+    }
+
+    /** Initialize a compression stream with the dictionary loaded.
+
+        The dictionary is hashed once on construction and the prepared
+        state is copied, which is much cheaper than loading it again.
+    */
+    void
+    prime (LZ4_stream_t& stream) const;
+
+    /** Read a dictionary file.
+
+        @return The dictionary, or nullptr if the file does not exist.
+        @throws std::runtime_error if the file is malformed.
+    */
+    static
+    std::unique_ptr<CompressionDictionary>
+    load (boost::filesystem::path const& path);
+
+    /** Write the dictionary to a file. */
+    void
+    save (boost::filesystem::path const& path) const;
+
+    /** Build a dictionary from sample values.
+
+        Samples are cut into short segments and the segments containing
+        the byte sequences shared by the most samples are kept, until
+        the dictionary reaches the requested size.
+
+        @param id The identifier for the new dictionary.
+        @param samples Representative decoded values.
+        @param size The target dictionary size, at most maxBytes.
+    */
+    static
+    std::unique_ptr<CompressionDictionary>
+    train (std::uint8_t id,
+        std::vector<Blob> const& samples, std::size_t size);
+
+private:
+    std::uint8_t id_;
+    Blob data_;
+    LZ4_stream_t stream_;
+};
+
+}
+}
+
+#endif
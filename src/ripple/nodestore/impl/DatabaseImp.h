@@ -293,6 +293,22 @@ public:
         m_negCache.erase (hash);
     }
 
+    void storeBatch (Batch const& batch) override
+    {
+        storeBatchInternal (batch, *m_backend.get());
+    }
+
+    void storeBatchInternal (Batch const& batch, Backend& backend)
+    {
+        backend.storeBatch (batch);
+        for (auto const& object : batch)
+        {
+            ++m_storeCount;
+            m_storeSize += object->getData().size();
+            m_negCache.erase (object->getHash());
+        }
+    }
+
     //------------------------------------------------------------------------------
 
     float getCacheHitRate () override
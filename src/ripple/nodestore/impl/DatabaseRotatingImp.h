@@ -120,6 +120,11 @@ public:
                 *getWritableBackend());
     }
 
+    void storeBatch (Batch const& batch) override
+    {
+        storeBatchInternal (batch, *getWritableBackend());
+    }
+
     std::shared_ptr<NodeObject> fetchNode (uint256 const& hash) override
     {
         return fetchFrom (hash);
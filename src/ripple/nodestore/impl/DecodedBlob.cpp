@@ -80,10 +80,8 @@ std::shared_ptr<NodeObject> DecodedBlob::createObject ()
 
     if (m_success)
     {
-        Blob data(m_objectData, m_objectData + m_dataBytes);
-
-        object = NodeObject::createObject (
-            m_objectType, std::move(data), uint256::fromVoid(m_key));
+        object = NodeObject::createObject (m_objectType,
+            Slice (m_objectData, m_dataBytes), uint256::fromVoid(m_key));
     }
 
     return object;
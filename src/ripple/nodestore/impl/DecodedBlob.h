@@ -21,6 +21,8 @@
 #define RIPPLE_NODESTORE_DECODEDBLOB_H_INCLUDED
 
 #include <ripple/nodestore/NodeObject.h>
+#include <algorithm>
+#include <cassert>
 
 namespace ripple {
 namespace NodeStore {
@@ -47,7 +49,30 @@ public:
     /** Create a NodeObject from this data. */
     std::shared_ptr<NodeObject> createObject ();
 
+    /** Decode a stored value directly into a new NodeObject.
+
+        @param key The 256-bit key of the object.
+        @param decompress A callable which is passed a BufferFactory and
+                          returns the decoded value as a pair of pointer
+                          and size, for example a call to
+                          nodeobject_decompress. Storage handed out by the
+                          factory belongs to the new object, so a value
+                          that needs decompressing is written in place
+                          instead of going through an intermediate buffer.
+        @return The object, or nullptr if the value is corrupt.
+    */
+    template <class Decompress>
+    static
+    std::shared_ptr<NodeObject>
+    decode (void const* key, Decompress&& decompress);
+
 private:
+    enum
+    {
+        // Size of the header which precedes the object data
+        headerBytes = 9
+    };
+
     bool m_success;
 
     void const* m_key;
@@ -56,6 +81,36 @@ private:
     int m_dataBytes;
 };
 
+template <class Decompress>
+std::shared_ptr<NodeObject>
+DecodedBlob::decode (void const* key, Decompress&& decompress)
+{
+    std::shared_ptr<NodeObject> object;
+    auto const result = decompress (
+        [&](std::size_t n) -> void*
+        {
+            // The header is decompressed into scratch space reserved
+            // in front of the payload.
+            assert (! object);
+            auto const prefix = std::min<std::size_t> (n, headerBytes);
+            object = NodeObject::allocate (hotUNKNOWN,
+                uint256::fromVoid (key), n - prefix, prefix);
+            return object->mData - prefix;
+        });
+
+    DecodedBlob decoded (key, result.first, result.second);
+    if (! decoded.wasOk ())
+        return nullptr;
+
+    // The value was not compressed and still points into
+    // the caller's memory, so it has to be copied.
+    if (! object)
+        return decoded.createObject ();
+
+    object->mType = decoded.m_objectType;
+    return object;
+}
+
 }
 }
 
@@ -19,21 +19,122 @@
 
 #include <BeastConfig.h>
 #include <ripple/nodestore/NodeObject.h>
+#include <cstring>
 #include <memory>
+#include <new>
 
 namespace ripple {
 
+namespace {
+
+// Allocator which over-allocates the block that allocate_shared requests
+// for the control block and object by `extra` bytes. The address of the
+// extra bytes is reported through `tail` before the object is constructed,
+// which lets the payload live in the same allocation as the header.
+template <class T>
+class TailAllocator
+{
+public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind
+    {
+        using other = TailAllocator<U>;
+    };
+
+    TailAllocator (std::size_t extra, std::uint8_t*& tail) noexcept
+        : extra_ (extra)
+        , tail_ (&tail)
+    {
+    }
+
+    template <class U>
+    TailAllocator (TailAllocator<U> const& other) noexcept
+        : extra_ (other.extra_)
+        , tail_ (other.tail_)
+    {
+    }
+
+    T*
+    allocate (std::size_t n)
+    {
+        auto const bytes = n * sizeof(T);
+        auto const p = static_cast<std::uint8_t*>(
+            ::operator new (bytes + extra_));
+        *tail_ = p + bytes;
+        return reinterpret_cast<T*>(p);
+    }
+
+    void
+    deallocate (T* p, std::size_t) noexcept
+    {
+        ::operator delete (p);
+    }
+
+    template <class U>
+    bool
+    operator== (TailAllocator<U> const& other) const noexcept
+    {
+        return extra_ == other.extra_;
+    }
+
+    template <class U>
+    bool
+    operator!= (TailAllocator<U> const& other) const noexcept
+    {
+        return ! (*this == other);
+    }
+
+private:
+    template <class U>
+    friend class TailAllocator;
+
+    std::size_t extra_;
+    std::uint8_t** tail_;
+};
+
+}
+
 //------------------------------------------------------------------------------
 
 NodeObject::NodeObject (
     NodeObjectType type,
-    Blob&& data,
     uint256 const& hash,
+    std::uint8_t* const& storage,
+    std::size_t prefix,
+    std::size_t size,
     PrivateAccess)
     : mType (type)
     , mHash (hash)
+    , mData (storage + prefix)
+    , mSize (static_cast<std::uint32_t>(size))
+{
+}
+
+std::shared_ptr<NodeObject>
+NodeObject::allocate (
+    NodeObjectType type,
+    uint256 const& hash,
+    std::size_t size,
+    std::size_t prefix)
+{
+    std::uint8_t* storage = nullptr;
+    return std::allocate_shared <NodeObject> (
+        TailAllocator<NodeObject> (prefix + size, storage),
+            type, hash, storage, prefix, size, PrivateAccess ());
+}
+
+std::shared_ptr<NodeObject>
+NodeObject::createObject (
+    NodeObjectType type,
+    Slice data,
+    uint256 const& hash)
 {
-    mData = std::move (data);
+    auto object = allocate (type, hash, data.size (), 0);
+    if (! data.empty ())
+        std::memcpy (object->mData, data.data (), data.size ());
+    return object;
 }
 
 std::shared_ptr<NodeObject>
@@ -42,8 +143,9 @@ NodeObject::createObject (
     Blob&& data,
     uint256 const& hash)
 {
-    return std::make_shared <NodeObject> (
-        type, std::move (data), hash, PrivateAccess ());
+    auto object = createObject (type, makeSlice (data), hash);
+    Blob ().swap (data);
+    return object;
 }
 
 NodeObjectType
@@ -58,10 +160,10 @@ NodeObject::getHash () const
     return mHash;
 }
 
-Blob const&
+Slice
 NodeObject::getData () const
 {
-    return mData;
+    return Slice (mData, mSize);
 }
 
 }
@@ -22,6 +22,7 @@
 
 #include <ripple/basics/contract.h>
 #include <nudb/detail/field.hpp>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
 #include <ripple/nodestore/impl/varint.h>
 #include <ripple/nodestore/NodeObject.h>
 #include <ripple/protocol/HashPrefix.h>
@@ -127,6 +128,66 @@ lz4_compress (void const* in,
     return result;
 }
 
+template <class BufferFactory>
+std::pair<void const*, std::size_t>
+lz4_dict_decompress (void const* in, std::size_t in_size,
+    CompressionDictionary const& dict, BufferFactory&& bf)
+{
+    using namespace nudb::detail;
+    std::pair<void const*, std::size_t> result;
+    std::uint8_t const* p = reinterpret_cast<
+        std::uint8_t const*>(in);
+    auto const n = read_varint(
+        p, in_size, result.second);
+    if (n == 0)
+        Throw<std::runtime_error> (
+            "lz4 decompress");
+    void* const out = bf(result.second);
+    result.first = out;
+    auto const d = dict.data();
+    if (LZ4_decompress_safe_usingDict(
+        reinterpret_cast<char const*>(in) + n,
+            reinterpret_cast<char*>(out),
+                static_cast<int>(in_size - n),
+                    static_cast<int>(result.second),
+                        reinterpret_cast<char const*>(d.data()),
+                            static_cast<int>(d.size())) !=
+                                static_cast<int>(result.second))
+        Throw<std::runtime_error> (
+            "lz4 decompress");
+    return result;
+}
+
+template <class BufferFactory>
+std::pair<void const*, std::size_t>
+lz4_dict_compress (void const* in, std::size_t in_size,
+    CompressionDictionary const& dict, BufferFactory&& bf)
+{
+    using namespace nudb::detail;
+    std::pair<void const*, std::size_t> result;
+    std::array<std::uint8_t, varint_traits<
+        std::size_t>::max> vi;
+    auto const n = write_varint(
+        vi.data(), in_size);
+    auto const out_max =
+        LZ4_compressBound(in_size);
+    std::uint8_t* out = reinterpret_cast<
+        std::uint8_t*>(bf(n + out_max));
+    result.first = out;
+    std::memcpy(out, vi.data(), n);
+    LZ4_stream_t stream;
+    dict.prime(stream);
+    auto const out_size = LZ4_compress_fast_continue(&stream,
+        reinterpret_cast<char const*>(in),
+            reinterpret_cast<char*>(out + n),
+                in_size, out_max, 1);
+    if (out_size == 0)
+        Throw<std::runtime_error> (
+            "lz4 compress");
+    result.second = n + out_size;
+    return result;
+}
+
 //------------------------------------------------------------------------------
 
 /*
@@ -136,12 +197,20 @@ lz4_compress (void const* in,
     1 = lz4 compressed
     2 = inner node compressed
     3 = full inner node
+    5 = v2 inner node compressed
+    6 = full v2 inner node
+    7 = lz4 compressed with a dictionary
+
+    Values of type 7 are followed by the one byte identifier
+    of the dictionary, then the lz4 compressed data. They can
+    only be decoded when that dictionary is supplied.
 */
 
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
 nodeobject_decompress (void const* in,
-    std::size_t in_size, BufferFactory&& bf)
+    std::size_t in_size, BufferFactory&& bf,
+        CompressionDictionary const* dict = nullptr)
 {
     using namespace nudb::detail;
 
@@ -309,6 +378,20 @@ nodeobject_decompress (void const* in,
         write(os, is((depth+1)/2), (depth+1)/2);
         break;
     }
+    case 7: // lz4 with dictionary
+    {
+        if (in_size < 1)
+            Throw<std::runtime_error> (
+                "nodeobject codec: short dictionary value");
+        auto const id = *p;
+        if (! dict || dict->id() != id)
+            Throw<std::runtime_error> (
+                "nodeobject codec: missing dictionary=" +
+                    std::to_string(id));
+        result = lz4_dict_decompress(
+            p + 1, in_size - 1, *dict, bf);
+        break;
+    }
     default:
         Throw<std::runtime_error> (
             "nodeobject codec: bad type=" +
@@ -334,7 +417,8 @@ zero32()
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
 nodeobject_compress (void const* in,
-    std::size_t in_size, BufferFactory&& bf)
+    std::size_t in_size, BufferFactory&& bf,
+        CompressionDictionary const* dict = nullptr)
 {
     using std::runtime_error;
     using namespace nudb::detail;
@@ -487,6 +571,16 @@ nodeobject_compress (void const* in,
         }
     }
 
+    // Check for a leaf node which may use the dictionary
+    if (dict && in_size > 9)
+    {
+        auto const kind = reinterpret_cast<
+            std::uint8_t const*>(in)[8];
+        if (kind == hotACCOUNT_NODE ||
+                kind == hotTRANSACTION_NODE)
+            type = 7;
+    }
+
     std::array<std::uint8_t, varint_traits<
         std::size_t>::max> vi;
     auto const vn = write_varint(
@@ -512,6 +606,24 @@ nodeobject_compress (void const* in,
         result.second = vn + lzr.second;
         break;
     }
+    case 7: // lz4 with dictionary
+    {
+        std::uint8_t* p;
+        auto const lzr = lz4_dict_compress(
+                in, in_size, *dict, [&p, &vn, &bf]
+            (std::size_t n)
+            {
+                p = reinterpret_cast<
+                    std::uint8_t*>(
+                        bf(vn + 1 + n));
+                return p + vn + 1;
+            });
+        std::memcpy(p, vi.data(), vn);
+        p[vn] = dict->id();
+        result.first = p;
+        result.second = vn + 1 + lzr.second;
+        break;
+    }
     default:
         Throw<std::logic_error> (
             "nodeobject codec: unknown=" +
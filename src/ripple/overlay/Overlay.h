@@ -114,6 +114,11 @@ public:
     Json::Value
     json () = 0;
 
+    /** Returns the counters of transactions relayed by peers. */
+    virtual
+    Json::Value
+    txAdmission () = 0;
+
     /** Returns a sequence representing the current list of peers.
         The snapshot is made at the time of the call.
     */
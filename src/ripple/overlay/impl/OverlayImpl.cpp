@@ -22,6 +22,7 @@
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/ValidatorList.h>
 #include <ripple/core/DatabaseCon.h>
+#include <ripple/core/JobQueue.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/make_SSLContext.h>
@@ -152,6 +153,7 @@ OverlayImpl::OverlayImpl (
     , m_resourceManager (resourceManager)
     , m_peerFinder (PeerFinder::make_Manager (*this, io_service,
         stopwatch(), app_.journal("PeerFinder"), config))
+    , txAdmission_ (std::make_shared<TxAdmission>())
     , m_resolver (resolver)
     , next_id_(1)
     , timer_count_(0)
@@ -161,6 +163,7 @@ OverlayImpl::OverlayImpl (
 
 OverlayImpl::~OverlayImpl ()
 {
+    jobCounter_.join();
     stop();
 
     // Block until dependent objects have been destroyed.
@@ -566,6 +569,8 @@ OverlayImpl::onStart ()
 void
 OverlayImpl::onStop ()
 {
+    // Wait for the jobs checking transactions, and refuse new ones
+    jobCounter_.join();
     strand_.dispatch(std::bind(&OverlayImpl::stop, this));
 }
 
@@ -729,6 +734,43 @@ OverlayImpl::reportTraffic (
     m_traffic.addCount (cat, isInbound, number);
 }
 
+// Check the best waiting transactions, then start again if more wait
+static
+void
+checkTransactions (JobQueue& jobQueue, JobCounter& jobCounter,
+    std::shared_ptr<TxAdmission> const& admission)
+{
+    if (! jobQueue.addCountedJob (jtTRANSACTION,
+        "recvTransaction->checkTransactions", jobCounter,
+        [&jobQueue, &jobCounter, admission] (Job&)
+        {
+            auto const start = TxAdmission::clock_type::now();
+            auto const batch = admission->takeBatch();
+            for (auto const& check : batch)
+                check();
+            if (admission->finishBatch (batch.size(),
+                    TxAdmission::clock_type::now() - start))
+                checkTransactions (jobQueue, jobCounter, admission);
+        }))
+    {
+        admission->cancelJob();
+    }
+}
+
+void
+OverlayImpl::admitTransaction (TxAdmission::Priority const& priority,
+    TxAdmission::Check check)
+{
+    if (txAdmission_->insert (priority, std::move (check)))
+        checkTransactions (app_.getJobQueue(), jobCounter_, txAdmission_);
+}
+
+void
+OverlayImpl::duplicateTransaction ()
+{
+    txAdmission_->duplicate();
+}
+
 std::size_t
 OverlayImpl::selectPeers (PeerSet& set, std::size_t limit,
     std::function<bool(std::shared_ptr<Peer> const&)> score)
@@ -776,6 +818,12 @@ OverlayImpl::limit()
     return m_peerFinder->config().maxPeers;
 }
 
+Json::Value
+OverlayImpl::txAdmission()
+{
+    return txAdmission_->getJson();
+}
+
 Json::Value
 OverlayImpl::crawl()
 {
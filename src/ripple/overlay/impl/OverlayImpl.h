@@ -22,8 +22,10 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/core/Job.h>
+#include <ripple/core/JobCounter.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/overlay/impl/TrafficCount.h>
+#include <ripple/overlay/impl/TxAdmission.h>
 #include <ripple/server/Handoff.h>
 #include <ripple/rpc/ServerHandler.h>
 #include <ripple/basics/Resolver.h>
@@ -112,6 +114,8 @@ private:
     Resource::Manager& m_resourceManager;
     std::unique_ptr <PeerFinder::Manager> m_peerFinder;
     TrafficCount m_traffic;
+    std::shared_ptr<TxAdmission> txAdmission_;
+    JobCounter jobCounter_;
     hash_map <PeerFinder::Slot::ptr,
         std::weak_ptr <PeerImp>> m_peers;
     hash_map<Peer::id_t, std::weak_ptr<PeerImp>> ids_;
@@ -262,6 +266,15 @@ public:
         bool isInbound,
         int bytes);
 
+    // Called when a transaction relayed by a peer should be checked
+    void
+    admitTransaction (TxAdmission::Priority const& priority,
+        TxAdmission::Check check);
+
+    // Called when a peer relays a transaction seen recently
+    void
+    duplicateTransaction ();
+
 private:
     std::shared_ptr<Writer>
     makeRedirectResponse (PeerFinder::Slot::ptr const& slot,
@@ -295,6 +308,9 @@ private:
     Json::Value
     json() override;
 
+    Json::Value
+    txAdmission() override;
+
     //--------------------------------------------------------------------------
 
     //
@@ -1051,19 +1051,38 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
         return;
     }
 
-    SerialIter sit (makeSlice(m->rawtransaction()));
+    auto const raw = makeSlice(m->rawtransaction());
+
+    // Drop transactions seen recently before paying to deserialize them
+    int flags;
+    auto const rawID = sha512Half (HashPrefix::transactionID, raw);
+    if (! app_.getHashRouter ().addSuppressionPeer (rawID, id_, flags))
+    {
+        // we have seen this transaction recently
+        if (flags & SF_BAD)
+        {
+            fee_ = Resource::feeInvalidSignature;
+            return;
+        }
+
+        if (!(flags & SF_RETRY))
+        {
+            overlay_.duplicateTransaction ();
+            return;
+        }
+    }
+
+    SerialIter sit (raw);
 
     try
     {
         auto stx = std::make_shared<STTx const>(sit);
         uint256 txID = stx->getTransactionID ();
 
-        int flags;
-
-        if (! app_.getHashRouter ().addSuppressionPeer (
+        // A transaction not encoded canonically has another ID
+        if (txID != rawID && ! app_.getHashRouter ().addSuppressionPeer (
             txID, id_, flags))
         {
-            // we have seen this transaction recently
             if (flags & SF_BAD)
             {
                 fee_ = Resource::feeInvalidSignature;
@@ -1071,7 +1090,10 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
             }
 
             if (!(flags & SF_RETRY))
+            {
+                overlay_.duplicateTransaction ();
                 return;
+            }
         }
 
         JLOG(p_journal_.debug()) << "Got tx " << txID;
@@ -1094,25 +1116,34 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
             }
         }
 
-        if (app_.getJobQueue().getJobCount(jtTRANSACTION) > 100)
-        {
-            JLOG(p_journal_.info()) << "Transaction queue is full";
-        }
-        else if (app_.getLedgerMaster().getValidatedLedgerAge() > 4min)
+        if (app_.getLedgerMaster().getValidatedLedgerAge() > 4min)
         {
             JLOG(p_journal_.trace()) << "No new transactions until synchronized";
+            return;
         }
-        else
+
+        // Transactions are checked best first: those from the cluster,
+        // then those paying more for each signature, then those from
+        // peers which have cost us less.
+        TxAdmission::Priority priority;
+        priority.trusted = cluster();
+        auto const fee = stx->getFieldAmount (sfFee);
+        if (fee.native () && fee.signum () > 0)
         {
-            app_.getJobQueue ().addJob (
-                jtTRANSACTION, "recvTransaction->checkTransaction",
-                [weak = std::weak_ptr<PeerImp>(shared_from_this()),
-                flags, checkSignature, stx] (Job&) {
-                    if (auto peer = weak.lock())
-                        peer->checkTransaction(flags,
-                            checkSignature, stx);
-                });
+            std::uint64_t signers = 1;
+            if (stx->isFieldPresent (sfSigners))
+                signers += stx->getFieldArray (sfSigners).size ();
+            priority.feeLevel = fee.xrp ().drops () / signers;
         }
+        priority.balance = usage_.balance ();
+
+        overlay_.admitTransaction (priority,
+            [weak = std::weak_ptr<PeerImp>(shared_from_this()),
+            flags, checkSignature, stx] () {
+                if (auto peer = weak.lock())
+                    peer->checkTransaction(flags,
+                        checkSignature, stx);
+            });
     }
     catch (std::exception const&)
     {
@@ -1672,7 +1703,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMGetObjectByHash> const& m)
                 {
                     protocol::TMIndexedObject& newObj = *reply.add_objects ();
                     newObj.set_hash (hash.begin (), hash.size ());
-                    newObj.set_data (&hObj->getData ().front (),
+                    newObj.set_data (hObj->getData ().data (),
                         hObj->getData ().size ());
 
                     if (obj.has_nodeid ())
@@ -1692,6 +1723,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMGetObjectByHash> const& m)
     {
         // this is a reply
         std::uint32_t pLSeq = 0;
+        uint256 pLHash;
         bool pLDo = true;
         bool progress = false;
 
@@ -1733,6 +1765,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMGetObjectByHash> const& m)
                             obj.data ().begin (), obj.data ().end ()));
 
                     app_.getLedgerMaster ().addFetchPack (hash, data);
+                    pLHash = hash;
                 }
             }
         }
@@ -1743,7 +1776,8 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMGetObjectByHash> const& m)
                 "GetObj: Partial fetch pack for " << pLSeq;
         }
         if (packet.type () == protocol::TMGetObjectByHash::otFETCH_PACK)
-            app_.getLedgerMaster ().gotFetchPack (progress, pLSeq);
+            app_.getLedgerMaster ().gotFetchPack (
+                progress, pLDo ? pLSeq : 0, pLHash);
     }
 }
 
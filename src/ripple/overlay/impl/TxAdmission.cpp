@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/overlay/impl/TxAdmission.h>
+#include <ripple/protocol/JsonFields.h>
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+
+namespace ripple {
+
+std::size_t const TxAdmission::batchSize;
+std::size_t const TxAdmission::maxJobs;
+std::size_t const TxAdmission::minCapacity;
+std::size_t const TxAdmission::maxCapacity;
+
+// How long a transaction should wait, at most, to be checked
+static std::chrono::duration<double> const targetDelay =
+    std::chrono::seconds (1);
+
+bool
+TxAdmission::Key::operator< (Key const& other) const
+{
+    auto const& a = priority;
+    auto const& b = other.priority;
+    return std::tie (b.trusted, b.feeLevel, a.balance, seq) <
+        std::tie (a.trusted, a.feeLevel, b.balance, other.seq);
+}
+
+void
+TxAdmission::duplicate ()
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    ++duplicates_;
+}
+
+bool
+TxAdmission::insert (Priority const& priority, Check check)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    ++received_;
+
+    Key key {priority, seq_++};
+    if (pending_.size() >= capacity_)
+    {
+        // Make room by dropping the worst, unless this is no better
+        ++dropped_;
+        auto const worst = std::prev (pending_.end());
+        if (! (key < worst->first))
+            return false;
+        pending_.erase (worst);
+    }
+
+    pending_.emplace (key, std::move (check));
+    return startJob ();
+}
+
+std::vector<TxAdmission::Check>
+TxAdmission::takeBatch ()
+{
+    std::vector<Check> batch;
+    std::lock_guard<std::mutex> lock (mutex_);
+    batch.reserve (std::min (batchSize, pending_.size()));
+    while (! pending_.empty() && batch.size() < batchSize)
+    {
+        auto const iter = pending_.begin();
+        batch.push_back (std::move (iter->second));
+        pending_.erase (iter);
+    }
+    return batch;
+}
+
+bool
+TxAdmission::finishBatch (std::size_t count, clock_type::duration elapsed)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    --jobs_;
+    ++batches_;
+    checked_ += count;
+
+    auto const seconds =
+        std::chrono::duration<double> (elapsed).count();
+    if (count != 0 && seconds > 0)
+    {
+        auto const rate = count / seconds;
+        rate_ = (rate_ == 0) ? rate : (3 * rate_ + rate) / 4;
+        capacity_ = std::max (minCapacity, std::min (maxCapacity,
+            static_cast<std::size_t> (rate_ * targetDelay.count())));
+
+        while (pending_.size() > capacity_)
+        {
+            pending_.erase (std::prev (pending_.end()));
+            ++dropped_;
+        }
+    }
+
+    return startJob ();
+}
+
+void
+TxAdmission::cancelJob ()
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    --jobs_;
+}
+
+bool
+TxAdmission::startJob ()
+{
+    // Add a job only when the running ones have more than they can take
+    if (pending_.empty() || jobs_ >= maxJobs ||
+            pending_.size() <= jobs_ * batchSize)
+        return false;
+    ++jobs_;
+    return true;
+}
+
+std::size_t
+TxAdmission::size () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return pending_.size();
+}
+
+std::size_t
+TxAdmission::capacity () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return capacity_;
+}
+
+Json::Value
+TxAdmission::getJson () const
+{
+    Json::Value ret (Json::objectValue);
+    std::lock_guard<std::mutex> lock (mutex_);
+    ret[jss::received] = std::to_string (received_);
+    ret[jss::duplicates] = std::to_string (duplicates_);
+    ret[jss::dropped] = std::to_string (dropped_);
+    ret[jss::batches] = std::to_string (batches_);
+    ret[jss::checked] = std::to_string (checked_);
+    ret[jss::pending] = static_cast<Json::UInt> (pending_.size());
+    ret[jss::capacity] = static_cast<Json::UInt> (capacity_);
+    return ret;
+}
+
+} // ripple
@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_OVERLAY_TXADMISSION_H_INCLUDED
+#define RIPPLE_OVERLAY_TXADMISSION_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** Transactions relayed by peers, waiting to be checked.
+
+    Transactions from all peers are collected and checked in batches,
+    so a burst costs one job per batch rather than one per transaction.
+    The best transactions are checked first. When more arrive than can
+    be checked in about a second, at the rate checks have been taking,
+    the worst are dropped.
+*/
+class TxAdmission
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    /** The order in which waiting transactions are checked. */
+    struct Priority
+    {
+        /** The transaction came from a cluster peer. */
+        bool trusted = false;
+
+        /** The fee paid for each signature, in drops. */
+        std::uint64_t feeLevel = 0;
+
+        /** The resource balance of the sending peer. Lower is better. */
+        int balance = 0;
+    };
+
+    using Check = std::function<void()>;
+
+    /** The most transactions checked by one job. */
+    static std::size_t const batchSize = 64;
+
+    /** The most jobs checking transactions at the same time. */
+    static std::size_t const maxJobs = 4;
+
+    /** Bounds on the number of transactions kept waiting. */
+    static std::size_t const minCapacity = 100;
+    static std::size_t const maxCapacity = 10000;
+
+    TxAdmission () = default;
+    TxAdmission (TxAdmission const&) = delete;
+    TxAdmission& operator= (TxAdmission const&) = delete;
+
+    /** Count a transaction which was seen recently and not queued. */
+    void
+    duplicate ();
+
+    /** Queue a transaction to be checked.
+
+        @return `true` if the caller must start a job to check a batch.
+    */
+    bool
+    insert (Priority const& priority, Check check);
+
+    /** Remove the best waiting transactions, to be checked together. */
+    std::vector<Check>
+    takeBatch ();
+
+    /** Report that a job checked a batch.
+
+        @return `true` if the job must be started again.
+    */
+    bool
+    finishBatch (std::size_t count, clock_type::duration elapsed);
+
+    /** Report that a job which was to check a batch was not added. */
+    void
+    cancelJob ();
+
+    /** The number of transactions waiting. */
+    std::size_t
+    size () const;
+
+    /** The number of transactions which may wait. */
+    std::size_t
+    capacity () const;
+
+    Json::Value
+    getJson () const;
+
+private:
+    struct Key
+    {
+        Priority priority;
+        std::uint64_t seq;
+
+        // Better transactions sort first
+        bool
+        operator< (Key const& other) const;
+    };
+
+    bool
+    startJob ();
+
+    std::mutex mutable mutex_;
+    std::map<Key, Check> pending_;
+    std::uint64_t seq_ = 0;
+    std::size_t jobs_ = 0;
+
+    // Transactions checked per second by one job
+    double rate_ = 0;
+    std::size_t capacity_ = 1000;
+
+    std::uint64_t received_ = 0;
+    std::uint64_t duplicates_ = 0;
+    std::uint64_t dropped_ = 0;
+    std::uint64_t batches_ = 0;
+    std::uint64_t checked_ = 0;
+};
+
+} // ripple
+
+#endif
@@ -69,6 +69,7 @@ JSS ( account_hash );               // out: LedgerToJson
 JSS ( account_id );                 // out: WalletPropose
 JSS ( account_objects );            // out: AccountObjects
 JSS ( account_root );               // in: LedgerEntry
+JSS ( account_tx_index );           // out: NetworkOPs
 JSS ( accounts );                   // in: LedgerEntry, Subscribe,
                                     //     handlers/Ledger, Unsubscribe
                                     // out: WalletAccounts
@@ -92,6 +93,7 @@ JSS ( balances );                   // out: GatewayBalances
 JSS ( base );                       // out: LogLevel
 JSS ( base_fee );                   // out: NetworkOPs
 JSS ( base_fee_xrp );               // out: NetworkOPs
+JSS ( batches );                    // out: GetCounts
 JSS ( bids );                       // out: Subscribe
 JSS ( binary );                     // in: AccountTX, LedgerEntry,
                                     //     AccountTxOld, Tx LedgerData
@@ -102,9 +104,11 @@ JSS ( build_path );                 // in: TransactionSign
 JSS ( build_version );              // out: NetworkOPs
 JSS ( cancel_after );               // out: AccountChannels
 JSS ( can_delete );                 // out: CanDelete
+JSS ( capacity );                   // out: GetCounts
 JSS ( channel_id );                 // out: AccountChannels
 JSS ( channels );                   // out: AccountChannels
 JSS ( check_nodes );                // in: LedgerCleaner
+JSS ( checked );                    // out: GetCounts
 JSS ( clear );                      // in/out: FetchInfo
 JSS ( close_flags );                // out: LedgerToJson
 JSS ( close_time );                 // in: Application, out: NetworkOPs,
@@ -132,9 +136,13 @@ JSS ( current_ledger_size );        // out: TxQ
 JSS ( current_queue_size );         // out: TxQ
 JSS ( data );                       // out: LedgerData
 JSS ( date );                       // out: tx/Transaction, NetworkOPs
+JSS ( dbCheckoutsLedger );          // out: getCounts
+JSS ( dbCheckoutsTransaction );     // out: getCounts
 JSS ( dbKBLedger );                 // out: getCounts
 JSS ( dbKBTotal );                  // out: getCounts
 JSS ( dbKBTransaction );            // out: getCounts
+JSS ( dbReadsLedger );              // out: getCounts
+JSS ( dbReadsTransaction );         // out: getCounts
 JSS ( debug_signing );              // in: TransactionSign
 JSS ( delivered_amount );           // out: addPaymentDeliveredAmount
 JSS ( deprecated );                 // out: WalletSeed
@@ -149,7 +157,9 @@ JSS ( dir_entry );                  // out: DirectoryEntryIterator
 JSS ( dir_index );                  // out: DirectoryEntryIterator
 JSS ( dir_root );                   // out: DirectoryEntryIterator
 JSS ( directory );                  // in: LedgerEntry
+JSS ( dropped );                    // out: GetCounts
 JSS ( drops );                      // out: TxQ
+JSS ( duplicates );                 // out: GetCounts
 JSS ( duration_us );                // out: NetworkOPs
 JSS ( enabled );                    // out: AmendmentTable
 JSS ( engine_result );              // out: NetworkOPs, TransactionSign, Submit
@@ -173,6 +183,7 @@ JSS ( fee_div_max );                // in: TransactionSign
 JSS ( fee_level );                  // out: AccountInfo
 JSS ( fee_mult_max );               // in: TransactionSign
 JSS ( fee_ref );                    // out: NetworkOPs
+JSS ( fetch_delta_hit_rate );       // out: GetCounts
 JSS ( fetch_pack );                 // out: NetworkOPs
 JSS ( first );                      // out: rpc/Version
 JSS ( fix_txns );                   // in: LedgerCleaner
@@ -236,6 +247,7 @@ JSS ( ledger_index_min );           // in, out: AccountTx*
 JSS ( ledger_max );                 // in, out: AccountTx*
 JSS ( ledger_min );                 // in, out: AccountTx*
 JSS ( ledger_time );                // out: NetworkOPs
+JSS ( ledgers_left );               // out: NetworkOPs
 JSS ( levels );                     // LogLevels
 JSS ( limit );                      // in/out: AccountTx*, AccountOffers,
                                     //         AccountLines, AccountObjects
@@ -320,6 +332,7 @@ JSS ( peer );                       // in: AccountLines
 JSS ( peer_authorized );            // out: AccountLines
 JSS ( peer_id );                    // out: RCLCxPeerPos
 JSS ( peers );                      // out: InboundLedger, handlers/Peers, Overlay
+JSS ( pending );                    // out: GetCounts
 JSS ( port );                       // in: Connect
 JSS ( previous_ledger );            // out: LedgerPropose
 JSS ( proof );                      // in: BookOffers
@@ -339,6 +352,7 @@ JSS ( queue_data );                 // out: AccountInfo
 JSS ( random );                     // out: Random
 JSS ( raw_meta );                   // out: AcceptedLedgerTx
 JSS ( receive_currencies );         // out: AccountCurrencies
+JSS ( received );                   // out: GetCounts
 JSS ( reference_level );            // out: TxQ
 JSS ( regular_seed );               // in/out: LedgerEntry
 JSS ( remote );                     // out: Logic.h
@@ -353,6 +367,7 @@ JSS ( ripple_lines );               // out: NetworkOPs
 JSS ( ripple_state );               // in: LedgerEntr
 JSS ( ripplerpc );                  // ripple RPC version
 JSS ( role );                       // out: Ping.cpp
+JSS ( rows_copied );                // out: NetworkOPs
 JSS ( rt_accounts );                // in: Subscribe, Unsubscribe
 JSS ( sanity );                     // out: PeerImp
 JSS ( search_depth );               // in: RipplePathFind
@@ -376,7 +391,7 @@ JSS ( signing_key );                // out: NetworkOPs
 JSS ( signing_time );               // out: NetworkOPs
 JSS ( signer_list );                // in: AccountObjects
 JSS ( signer_lists );               // in/out: AccountInfo
-JSS ( snapshot );                   // in: Subscribe
+JSS ( snapshot );                   // in: Subscribe, out: LedgerSnapshot
 JSS ( source_account );             // in: PathRequest, RipplePathFind
 JSS ( source_amount );              // in: PathRequest, RipplePathFind
 JSS ( source_currencies );          // in: PathRequest, RipplePathFind
@@ -418,6 +433,7 @@ JSS ( treenode_cache_size );        // out: GetCounts
 JSS ( treenode_track_size );        // out: GetCounts
 JSS ( trusted );                    // out: UnlList
 JSS ( tx );                         // out: STTx, AccountTx*
+JSS ( tx_admission );               // out: GetCounts
 JSS ( tx_blob );                    // in/out: Submit,
                                     // in: TransactionSign, AccountTx*
 JSS ( tx_hash );                    // in: TransactionEntry
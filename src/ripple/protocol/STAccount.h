@@ -78,6 +78,12 @@ public:
         s.addVL (value_.data(), size);
     }
 
+    std::size_t
+    serializedSize() const override
+    {
+        return Serializer::lengthVL (isDefault() ? 0 : uint160::bytes);
+    }
+
     bool
     isEquivalent (const STBase& t) const override
     {
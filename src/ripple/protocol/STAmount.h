@@ -272,6 +272,13 @@ public:
     void
     add (Serializer& s) const override;
 
+    std::size_t
+    serializedSize() const override
+    {
+        // Native amounts are 64 bits, others add the issue
+        return mIsNative ? 8 : 8 + 2 * uint160::bytes;
+    }
+
     bool
     isEquivalent (const STBase& t) const override;
 
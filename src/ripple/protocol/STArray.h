@@ -150,6 +150,8 @@ public:
     virtual Json::Value getJson (int index) const override;
     virtual void add (Serializer & s) const override;
 
+    virtual std::size_t serializedSize () const override;
+
     void sort (bool (*compare) (const STObject & o1, const STObject & o2));
 
     bool operator== (const STArray & s) const
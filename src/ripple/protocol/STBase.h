@@ -126,6 +126,13 @@ public:
     void
     add (Serializer& s) const;
 
+    /** Returns the number of bytes add() writes.
+        Used to size a Serializer before writing to it.
+    */
+    virtual
+    std::size_t
+    serializedSize() const;
+
     virtual
     bool
     isEquivalent (STBase const& t) const;
@@ -98,6 +98,12 @@ public:
         s.addBitString<Bits> (value_);
     }
 
+    std::size_t
+    serializedSize() const override
+    {
+        return Bits / 8;
+    }
+
     template <typename Tag>
     void setValue (base_uint<Bits, Tag> const& v)
     {
@@ -115,6 +115,12 @@ public:
         s.addVL (value_.data (), value_.size ());
     }
 
+    std::size_t
+    serializedSize() const override
+    {
+        return Serializer::lengthVL (value_.size ());
+    }
+
     Buffer const&
     peekValue () const
     {
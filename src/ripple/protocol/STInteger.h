@@ -71,6 +71,12 @@ public:
         s.addInteger (value_);
     }
 
+    std::size_t
+    serializedSize() const override
+    {
+        return sizeof (value_);
+    }
+
     STInteger& operator= (value_type const& v)
     {
         value_ = v;
@@ -24,6 +24,7 @@
 #include <ripple/basics/contract.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/Slice.h>
+#include <ripple/protocol/digest.h>
 #include <ripple/protocol/STAmount.h>
 #include <ripple/protocol/STPathSet.h>
 #include <ripple/protocol/STVector256.h>
@@ -358,12 +359,19 @@ public:
         add (s, false);
     }
 
+    virtual std::size_t serializedSize () const override
+    {
+        return serializedSize (true);
+    }
+
+    std::size_t serializedSize (bool withSigningFields) const;
+
     // VFALCO NOTE does this return an expensive copy of an object with a
     //             dynamic buffer?
     // VFALCO TODO Remove this function and fix the few callers.
     Serializer getSerializer () const
     {
-        Serializer s;
+        Serializer s (serializedSize (true));
         add (s, true);
         return s;
     }
@@ -536,6 +544,11 @@ public:
 private:
     void add (Serializer & s, bool withSigningFields) const;
 
+    // Serialize the fields into `buffer`, passing it to the
+    // hasher whenever it holds a block's worth of data.
+    void hashFields (sha512_half_hasher& h, Serializer& buffer,
+        bool withSigningFields) const;
+
     // Sort the entries in an STObject into the order that they will be
     // serialized.  Note: they are not sorted into pointer value order, they
     // are sorted by SField::fieldCode.
@@ -319,6 +319,9 @@ public:
     void
     add (Serializer& s) const override;
 
+    std::size_t
+    serializedSize() const override;
+
     Json::Value
     getJson (int) const override;
 
@@ -69,6 +69,12 @@ public:
     void
     add (Serializer& s) const override;
 
+    std::size_t
+    serializedSize() const override
+    {
+        return Serializer::lengthVL (mValue.size () * (256 / 8));
+    }
+
     Json::Value
     getJson (int) const override;
 
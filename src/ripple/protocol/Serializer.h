@@ -273,11 +273,19 @@ public:
     static int decodeVLLength (int b1);
     static int decodeVLLength (int b1, int b2);
     static int decodeVLLength (int b1, int b2, int b3);
-private:
+
+    // Bytes written by addVL for a value of the given length
     static int lengthVL (int length)
     {
         return length + encodeLengthLength (length);
     }
+
+    // Bytes written by addFieldID
+    static int lengthFieldID (int type, int name)
+    {
+        return 1 + (type >= 16) + (name >= 16);
+    }
+private:
     static int encodeLengthLength (int length); // length to encode length
     int addEncoded (int length);
 };
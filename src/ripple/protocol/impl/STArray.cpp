@@ -171,6 +171,19 @@ void STArray::add (Serializer& s) const
     }
 }
 
+std::size_t STArray::serializedSize () const
+{
+    std::size_t size = 0;
+    for (STObject const& object : v_)
+    {
+        auto const& name = object.getFName ();
+        size += Serializer::lengthFieldID (name.fieldType, name.fieldValue) +
+            object.serializedSize () +
+                Serializer::lengthFieldID (STI_OBJECT, 1);
+    }
+    return size;
+}
+
 bool STArray::isEquivalent (const STBase& t) const
 {
     auto v = dynamic_cast<const STArray*> (&t);
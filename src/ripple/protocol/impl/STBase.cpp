@@ -108,6 +108,14 @@ STBase::add (Serializer& s) const
     assert(false);
 }
 
+std::size_t
+STBase::serializedSize() const
+{
+    Serializer s;
+    add (s);
+    return s.size();
+}
+
 bool
 STBase::isEquivalent (const STBase& t) const
 {
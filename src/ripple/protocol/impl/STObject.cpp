@@ -24,6 +24,9 @@
 #include <ripple/protocol/STArray.h>
 #include <ripple/protocol/STBlob.h>
 #include <ripple/basics/Log.h>
+#include <boost/container/small_vector.hpp>
+#include <algorithm>
+#include <tuple>
 
 namespace ripple {
 
@@ -292,18 +295,22 @@ bool STObject::isEquivalent (const STBase& t) const
 
 uint256 STObject::getHash (std::uint32_t prefix) const
 {
-    Serializer s;
-    s.add32 (prefix);
-    add (s, true);
-    return s.getSHA512Half ();
+    sha512_half_hasher h;
+    Serializer buffer;
+    buffer.add32 (prefix);
+    hashFields (h, buffer, true);
+    h (buffer.data (), buffer.size ());
+    return static_cast<uint256> (h);
 }
 
 uint256 STObject::getSigningHash (std::uint32_t prefix) const
 {
-    Serializer s;
-    s.add32 (prefix);
-    add (s, false);
-    return s.getSHA512Half ();
+    sha512_half_hasher h;
+    Serializer buffer;
+    buffer.add32 (prefix);
+    hashFields (h, buffer, false);
+    h (buffer.data (), buffer.size ());
+    return static_cast<uint256> (h);
 }
 
 int STObject::getFieldIndex (SField const& field) const
@@ -693,37 +700,144 @@ bool STObject::operator== (const STObject& obj) const
     return true;
 }
 
-void STObject::add (Serializer& s, bool withSigningFields) const
+// The end marker following a field of this type, if any. Objects
+// derived from STObject report their own types.
+static
+SerializedTypeID
+endMarker (SerializedTypeID type)
 {
-    std::map<int, STBase const*> fields;
-    for (auto const& e : v_)
+    switch (type)
+    {
+    case STI_ARRAY:
+        return STI_ARRAY;
+    case STI_OBJECT:
+    case STI_TRANSACTION:
+    case STI_LEDGERENTRY:
+        return STI_OBJECT;
+    default:
+        return STI_NOTPRESENT;
+    }
+}
+
+// Calls f with each field to serialize and its type, in canonical order
+template <class F>
+static
+void
+forEachField (std::vector<detail::STVar> const& v,
+    bool withSigningFields, F&& f)
+{
+    struct Entry
+    {
+        int code;
+        std::size_t order;
+        STBase const* field;
+        SerializedTypeID type;
+    };
+
+    // Objects rarely have more fields than this, so
+    // sorting them usually needs no allocation
+    boost::container::small_vector<Entry, 32> fields;
+    for (auto const& e : v)
     {
         // pick out the fields and sort them
-        if ((e->getSType() != STI_NOTPRESENT) &&
+        auto const type = e->getSType();
+        if ((type != STI_NOTPRESENT) &&
             e->getFName().shouldInclude (withSigningFields))
         {
-            fields.insert (std::make_pair (
-                e->getFName().fieldCode, &e.get()));
+            fields.push_back ({ e->getFName().fieldCode,
+                fields.size(), &e.get(), type });
         }
     }
+    std::sort (fields.begin(), fields.end(),
+        [](Entry const& lhs, Entry const& rhs)
+        {
+            return std::tie (lhs.code, lhs.order) <
+                std::tie (rhs.code, rhs.order);
+        });
+
+    // keep the first of any duplicates
+    for (auto iter = fields.begin(); iter != fields.end(); ++iter)
+    {
+        if (iter == fields.begin() || std::prev (iter)->code != iter->code)
+            f (*iter->field, iter->type);
+    }
+}
+
+void STObject::add (Serializer& s, bool withSigningFields) const
+{
+    forEachField (v_, withSigningFields,
+        [&s](STBase const& field, SerializedTypeID type)
+        {
+            // When we serialize an object inside another object,
+            // the type associated by rule with this field name
+            // must be OBJECT, or the object cannot be deserialized
+            assert ((type != STI_OBJECT) ||
+                (field.getFName().fieldType == STI_OBJECT));
+            field.addFieldID (s);
+            field.add (s);
+            auto const end = endMarker (type);
+            if (end != STI_NOTPRESENT)
+                s.addFieldID (end, 1);
+        });
+}
 
-    // insert sorted
-    for (auto const& e : fields)
+void STObject::hashFields (sha512_half_hasher& h, Serializer& buffer,
+    bool withSigningFields) const
+{
+    // The SHA-512 block size
+    std::size_t const blockSize = 128;
+
+    forEachField (v_, withSigningFields,
+        [&](STBase const& field, SerializedTypeID type)
+        {
+            field.addFieldID (buffer);
+            auto const end = endMarker (type);
+            if (end == STI_ARRAY)
+            {
+                for (auto const& object : static_cast<STArray const&>(field))
+                {
+                    object.addFieldID (buffer);
+                    object.hashFields (h, buffer, true);
+                    buffer.addFieldID (STI_OBJECT, 1);
+                }
+            }
+            else if (end == STI_OBJECT)
+            {
+                static_cast<STObject const&>(field).hashFields (
+                    h, buffer, true);
+            }
+            else
+            {
+                field.add (buffer);
+            }
+            if (end != STI_NOTPRESENT)
+                buffer.addFieldID (end, 1);
+
+            if (buffer.size() >= blockSize)
+            {
+                h (buffer.data(), buffer.size());
+                buffer.erase();
+            }
+        });
+}
+
+std::size_t STObject::serializedSize (bool withSigningFields) const
+{
+    std::size_t size = 0;
+    for (auto const& e : v_)
     {
-        auto const field = e.second;
-
-        // When we serialize an object inside another object,
-        // the type associated by rule with this field name
-        // must be OBJECT, or the object cannot be deserialized
-        assert ((field->getSType() != STI_OBJECT) ||
-            (field->getFName().fieldType == STI_OBJECT));
-        field->addFieldID (s);
-        field->add (s);
-        if (dynamic_cast<const STArray*> (field) != nullptr)
-            s.addFieldID (STI_ARRAY, 1);
-        else if (dynamic_cast<const STObject*> (field) != nullptr)
-            s.addFieldID (STI_OBJECT, 1);
+        auto const type = e->getSType();
+        auto const& name = e->getFName();
+        if ((type == STI_NOTPRESENT) || ! name.shouldInclude (withSigningFields))
+            continue;
+
+        size += Serializer::lengthFieldID (name.fieldType, name.fieldValue) +
+            e->serializedSize();
+        auto const end = endMarker (type);
+        if (end != STI_NOTPRESENT)
+            size += Serializer::lengthFieldID (end, 1);
     }
+    return size;
 }
 
 std::vector<STBase const*>
@@ -221,4 +221,26 @@ STPathSet::add (Serializer& s) const
     s.add8 (STPathElement::typeNone);
 }
 
+std::size_t
+STPathSet::serializedSize () const
+{
+    // One byte ends each path, the last one ends the set
+    std::size_t size = value.empty () ? 1 : value.size ();
+
+    for (auto const& spPath : value)
+    {
+        for (auto const& speElement : spPath)
+        {
+            int const iType = speElement.getNodeType ();
+
+            size += 1 +
+                (iType & STPathElement::typeAccount ? 20 : 0) +
+                (iType & STPathElement::typeCurrency ? 20 : 0) +
+                (iType & STPathElement::typeIssuer ? 20 : 0);
+        }
+    }
+
+    return size;
+}
+
 } // ripple
@@ -141,7 +141,7 @@ STTx::getMentionedAccounts () const
 
 static Blob getSigningData (STTx const& that)
 {
-    Serializer s;
+    Serializer s (4 + that.serializedSize (false));
     s.add32 (HashPrefix::txSign);
     that.addWithoutSigningFields (s);
     return s.getData();
@@ -239,7 +239,7 @@ STTx::getMetaSQLInsertReplaceHeader ()
 std::string STTx::getMetaSQL (std::uint32_t inLedger,
                                                std::string const& escapedMetaData) const
 {
-    Serializer s;
+    Serializer s (serializedSize ());
     add (s);
     return getMetaSQL (s, inLedger, TXN_SQL_VALIDATED, escapedMetaData);
 }
@@ -510,7 +510,7 @@ bool passesLocalChecks (STObject const& st, std::string& reason)
 std::shared_ptr<STTx const>
 sterilize (STTx const& stx)
 {
-    Serializer s;
+    Serializer s (stx.serializedSize());
     stx.add(s);
     SerialIter sit(s.slice());
     return std::make_shared<STTx const>(std::ref(sit));
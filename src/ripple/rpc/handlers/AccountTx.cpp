@@ -22,6 +22,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/Transaction.h>
+#include <ripple/core/DatabaseCon.h>
 #include <ripple/json/json_value.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/net/RPCErr.h>
@@ -46,6 +47,8 @@ namespace ripple {
 // }
 Json::Value doAccountTx (RPC::Context& context)
 {
+    // The response can hold thousands of objects
+    Json::ScopedArena arena;
     auto& params = context.params;
 
     int limit = params.isMember (jss::limit) ?
@@ -126,9 +129,14 @@ Json::Value doAccountTx (RPC::Context& context)
 
         if (bBinary)
         {
-            auto txns = context.netOps.getTxsAccountB (
-                *account, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
-                isUnlimited (context.role));
+            NetworkOPs::MetaTxsList txns;
+            context.app.getTxnDB ().read ("account_tx", context.coro,
+                [&](soci::session&)
+                {
+                    txns = context.netOps.getTxsAccountB (
+                        *account, uLedgerMin, uLedgerMax, bForward,
+                        resumeToken, limit, isUnlimited (context.role));
+                });
 
             for (auto& it: txns)
             {
@@ -147,9 +155,14 @@ Json::Value doAccountTx (RPC::Context& context)
         }
         else
         {
-            auto txns = context.netOps.getTxsAccount (
-                *account, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
-                isUnlimited (context.role));
+            NetworkOPs::AccountTxs txns;
+            context.app.getTxnDB ().read ("account_tx", context.coro,
+                [&](soci::session&)
+                {
+                    txns = context.netOps.getTxsAccount (
+                        *account, uLedgerMin, uLedgerMax, bForward,
+                        resumeToken, limit, isUnlimited (context.role));
+                });
 
             for (auto& it: txns)
             {
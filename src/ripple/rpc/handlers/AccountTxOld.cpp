@@ -22,6 +22,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/Transaction.h>
+#include <ripple/core/DatabaseCon.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/protocol/ErrorCodes.h>
@@ -145,9 +146,14 @@ Json::Value doAccountTxOld (RPC::Context& context)
 
         if (bBinary)
         {
-            auto txns = context.netOps.getAccountTxsB (
-                *raAccount, uLedgerMin, uLedgerMax, bDescending, offset, limit,
-                isUnlimited (context.role));
+            NetworkOPs::MetaTxsList txns;
+            context.app.getTxnDB ().read ("account_tx", context.coro,
+                [&](soci::session&)
+                {
+                    txns = context.netOps.getAccountTxsB (
+                        *raAccount, uLedgerMin, uLedgerMax, bDescending,
+                        offset, limit, isUnlimited (context.role));
+                });
 
             for (auto it = txns.begin (), end = txns.end (); it != end; ++it)
             {
@@ -167,9 +173,14 @@ Json::Value doAccountTxOld (RPC::Context& context)
         }
         else
         {
-            auto txns = context.netOps.getAccountTxs (
-                *raAccount, uLedgerMin, uLedgerMax, bDescending, offset, limit,
-                isUnlimited (context.role));
+            NetworkOPs::AccountTxs txns;
+            context.app.getTxnDB ().read ("account_tx", context.coro,
+                [&](soci::session&)
+                {
+                    txns = context.netOps.getAccountTxs (
+                        *raAccount, uLedgerMin, uLedgerMax, bDescending,
+                        offset, limit, isUnlimited (context.role));
+                });
 
             for (auto it = txns.begin (), end = txns.end (); it != end; ++it)
             {
@@ -29,6 +29,7 @@
 #include <ripple/ledger/CachedSLEs.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/nodestore/Database.h>
+#include <ripple/overlay/Overlay.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/rpc/Context.h>
@@ -91,6 +92,25 @@ Json::Value doGetCounts (RPC::Context& context)
     if (dbKB > 0)
         ret[jss::dbKBTransaction] = dbKB;
 
+    // Latencies of reads made for RPC, counted in buckets of
+    // 1, 2, 4 and up to 1024 or more milliseconds
+    {
+        auto reads = context.app.getLedgerDB ().getReadJson ();
+        if (reads.size () > 0)
+            ret[jss::dbReadsLedger] = std::move (reads);
+
+        reads = context.app.getTxnDB ().getReadJson ();
+        if (reads.size () > 0)
+            ret[jss::dbReadsTransaction] = std::move (reads);
+    }
+
+    // How often, and for how many microseconds in all, checkouts
+    // of the writing and of the read only sessions waited
+    ret[jss::dbCheckoutsLedger] =
+        context.app.getLedgerDB ().getCheckoutJson ();
+    ret[jss::dbCheckoutsTransaction] =
+        context.app.getTxnDB ().getCheckoutJson ();
+
     {
         std::size_t c = context.app.getOPs().getLocalTxCount ();
         if (c > 0)
@@ -104,6 +124,8 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::SLE_hit_rate] = context.app.cachedSLEs().rate();
     ret[jss::node_hit_rate] = context.app.getNodeStore ().getCacheHitRate ();
     ret[jss::ledger_hit_rate] = context.app.getLedgerMaster ().getCacheHitRate ();
+    ret[jss::fetch_delta_hit_rate] =
+        context.app.getLedgerMaster ().getFetchPackDeltaHitRate ();
     ret[jss::AL_hit_rate] = context.app.getAcceptedLedgerCache ().getHitRate ();
 
     ret[jss::fullbelow_size] = static_cast<int>(context.app.family().fullbelow().size());
@@ -125,6 +147,8 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::node_written_bytes] = context.app.getNodeStore().getStoreSize();
     ret[jss::node_read_bytes] = context.app.getNodeStore().getFetchSize();
 
+    ret[jss::tx_admission] = context.app.overlay().txAdmission();
+
     return ret;
 }
 
@@ -22,6 +22,7 @@
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
+#include <ripple/core/DatabaseCon.h>
 #include <ripple/json/Object.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/JsonFields.h>
@@ -45,6 +46,19 @@ Status LedgerHandler::check()
     if (! needsLedger)
         return Status::OK;
 
+    // A ledger given by sequence may have to be loaded from the database.
+    // Holding it keeps it cached, so the lookup below finds it without
+    // another query.
+    std::shared_ptr<ReadView const> loaded;
+    if (auto const seq = ledgerSeqFromRequest (params))
+    {
+        context_.app.getLedgerDB ().read ("ledger", context_.coro,
+            [&](soci::session&)
+            {
+                loaded = context_.ledgerMaster.getLedgerBySeq (*seq);
+            });
+    }
+
     if (auto s = lookupLedger (ledger_, context_, result_))
         return s;
 
@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerSnapshot.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/app/misc/SHAMapStore.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/rpc/Context.h>
+#include <ripple/rpc/impl/RPCHelpers.h>
+
+namespace ripple {
+
+// Write a snapshot of a closed ledger to the snapshot_path of [node_db]
+// in the background. Without a ledger, report the latest snapshot.
+//
+// {
+//   ledger_hash : <ledger>
+//   ledger_index : <ledger_index>
+// }
+Json::Value doLedgerSnapshot (RPC::Context& context)
+{
+    auto& store = context.app.getSHAMapStore();
+    if (store.snapshotPath().empty())
+        return RPC::make_error (rpcNOT_ENABLED);
+
+    if (! context.params.isMember (jss::ledger_hash) &&
+        ! context.params.isMember (jss::ledger_index))
+    {
+        Json::Value ret (Json::objectValue);
+        ret[jss::snapshot] = store.getSnapshotJson();
+        return ret;
+    }
+
+    std::shared_ptr<ReadView const> view;
+    auto jvResult = RPC::lookupLedger (view, context);
+    if (! view)
+        return jvResult;
+
+    if (view->open())
+        return RPC::make_error (rpcNOT_SUPPORTED,
+            "Can't write a snapshot of an open ledger.");
+
+    auto const ledger = context.ledgerMaster.getLedgerByHash (
+        view->info().hash);
+    if (! ledger)
+        return RPC::make_error (rpcLGR_NOT_FOUND);
+
+    if (! store.writeSnapshot (ledger))
+        return RPC::make_error (rpcTOO_BUSY,
+            "A snapshot is already being written.");
+
+    jvResult[jss::message] = "Snapshot queued";
+    return jvResult;
+}
+
+} // ripple
@@ -23,6 +23,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/Transaction.h>
+#include <ripple/core/DatabaseCon.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/JsonFields.h>
@@ -97,8 +98,17 @@ Json::Value doTx (RPC::Context& context)
     if (!isHexTxID (txid))
         return rpcError (rpcNOT_IMPL);
 
-    auto txn = context.app.getMasterTransaction ().fetch (
-        from_hex_text<uint256>(txid), true);
+    auto const id = from_hex_text<uint256>(txid);
+    auto& master = context.app.getMasterTransaction ();
+    auto txn = master.fetch (id, false);
+    if (! txn)
+    {
+        context.app.getTxnDB ().read ("tx", context.coro,
+            [&](soci::session&)
+            {
+                txn = master.fetch (id, true);
+            });
+    }
 
     if (!txn)
         return rpcError (rpcTXN_NOT_FOUND);
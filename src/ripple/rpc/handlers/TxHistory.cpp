@@ -29,6 +29,8 @@
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/Role.h>
 #include <boost/format.hpp>
+#include <tuple>
+#include <vector>
 
 namespace ripple {
 
@@ -58,16 +60,20 @@ Json::Value doTxHistory (RPC::Context& context)
             "FROM Transactions ORDER BY LedgerSeq desc LIMIT %u,20;")
                     % startIndex);
 
-    {
-        auto db = context.app.getTxnDB ().checkoutDb ();
+    using Row = std::tuple<boost::optional<std::uint64_t>,
+        boost::optional<std::string>, Blob>;
+    std::vector<Row> rows;
 
+    context.app.getTxnDB ().read ("tx_history", context.coro,
+        [&](soci::session& session)
+    {
         boost::optional<std::uint64_t> ledgerSeq;
         boost::optional<std::string> status;
-        soci::blob sociRawTxnBlob (*db);
+        soci::blob sociRawTxnBlob (session);
         soci::indicator rti;
         Blob rawTxn;
 
-        soci::statement st = (db->prepare << sql,
+        soci::statement st = (session.prepare << sql,
                               soci::into (ledgerSeq),
                               soci::into (status),
                               soci::into (sociRawTxnBlob, rti));
@@ -80,10 +86,16 @@ Json::Value doTxHistory (RPC::Context& context)
             else
                 rawTxn.clear ();
 
-            if (auto trans = Transaction::transactionFromSQL (
-                    ledgerSeq, status, rawTxn, context.app))
-                txs.append (trans->getJson (0));
+            rows.emplace_back (ledgerSeq, status, std::move (rawTxn));
         }
+    });
+
+    for (auto const& row : rows)
+    {
+        if (auto trans = Transaction::transactionFromSQL (
+                std::get<0> (row), std::get<1> (row), std::get<2> (row),
+                    context.app))
+            txs.append (trans->getJson (0));
     }
 
     obj[jss::txs] = txs;
@@ -26,6 +26,7 @@
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <boost/algorithm/string/case_conv.hpp>
+#include <tuple>
 
 namespace ripple {
 namespace RPC {
@@ -170,17 +171,10 @@ isValidatedOld(LedgerMaster& ledgerMaster, bool standalone)
         Tuning::maxValidatedLedgerAge;
 }
 
-template <class T>
-Status
-ledgerFromRequest(T& ledger, Context& context)
+// The index and hash a request names its ledger by
+std::pair<Json::Value, Json::Value>
+ledgerIndexAndHash (Json::Value const& params)
 {
-    static auto const minSequenceGap = 10;
-
-    ledger.reset();
-
-    auto& params = context.params;
-    auto& ledgerMaster = context.ledgerMaster;
-
     auto indexValue = params[jss::ledger_index];
     auto hashValue = params[jss::ledger_hash];
 
@@ -194,6 +188,24 @@ ledgerFromRequest(T& ledger, Context& context)
             indexValue = legacyLedger;
     }
 
+    return {indexValue, hashValue};
+}
+
+template <class T>
+Status
+ledgerFromRequest(T& ledger, Context& context)
+{
+    static auto const minSequenceGap = 10;
+
+    ledger.reset();
+
+    auto& params = context.params;
+    auto& ledgerMaster = context.ledgerMaster;
+
+    Json::Value indexValue;
+    Json::Value hashValue;
+    std::tie (indexValue, hashValue) = ledgerIndexAndHash (params);
+
     if (hashValue)
     {
         if (! hashValue.isString ())
@@ -323,6 +335,18 @@ isValidated(LedgerMaster& ledgerMaster, ReadView const& ledger,
 
 } // namespace
 
+boost::optional<std::uint32_t>
+ledgerSeqFromRequest (Json::Value const& params)
+{
+    Json::Value indexValue;
+    Json::Value hashValue;
+    std::tie (indexValue, hashValue) = ledgerIndexAndHash (params);
+
+    if (hashValue || ! indexValue.isNumeric ())
+        return boost::none;
+    return indexValue.asInt ();
+}
+
 // The previous version of the lookupLedger command would accept the
 // "ledger_index" argument as a string and silently treat it as a request to
 // return the current ledger which, while not strictly wrong, could cause a lot
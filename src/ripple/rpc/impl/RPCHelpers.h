@@ -83,6 +83,13 @@ lookupLedger (std::shared_ptr<ReadView const>&, Context&);
 Status
 lookupLedger (std::shared_ptr<ReadView const>&, Context&, Json::Value& result);
 
+/** Return the sequence of the ledger a request names by its index, as
+    lookupLedger reads the request, or nothing if it names a ledger some
+    other way.
+*/
+boost::optional<std::uint32_t>
+ledgerSeqFromRequest (Json::Value const& params);
+
 hash_set <AccountID>
 parseAccountIds(Json::Value const& jvArray);
 
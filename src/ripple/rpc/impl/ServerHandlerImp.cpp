@@ -326,6 +326,25 @@ ServerHandlerImp::onRequest (Session& session)
         });
 }
 
+std::size_t
+ServerHandlerImp::pipelineLimit (Session& session)
+{
+    auto const limit = session.port().pipeline_limit;
+    if (limit <= 1)
+        return 1;
+
+    // Clients which are being charged heavily get
+    // one request at a time until their balance recovers.
+    auto const iter = session.request().fields.find("X-User");
+    auto const usage = requestInboundEndpoint (m_resourceManager,
+        session.remoteAddress().at_port (0), session.port(),
+            iter != session.request().fields.end() ?
+                iter->second : std::string{});
+    if (! usage.isUnlimited() && usage.disposition() != Resource::ok)
+        return 1;
+    return limit;
+}
+
 void
 ServerHandlerImp::onWSMessage(
     std::shared_ptr<WSSession> session,
@@ -833,6 +852,7 @@ to_Port(ParsedPort const& parsed, std::ostream& log)
     p.ssl_ciphers = parsed.ssl_ciphers;
     p.pmd_options = parsed.pmd_options;
     p.ws_queue_limit = parsed.ws_queue_limit;
+    p.pipeline_limit = parsed.pipeline_limit;
 
     return p;
 }
@@ -137,6 +137,15 @@ public:
     void
     onRequest (Session& session);
 
+    /** Returns how many requests on the session's connection
+        may be in progress at the same time.
+
+        The connection keeps the result for a second rather than
+        asking again for every request it reads.
+    */
+    std::size_t
+    pipelineLimit (Session& session);
+
     void
     onWSMessage(std::shared_ptr<WSSession> session,
         std::vector<boost::asio::const_buffer> const& buffers);
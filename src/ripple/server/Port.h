@@ -61,6 +61,11 @@ struct Port
     // Websocket disconnects if send queue exceeds this limit
     std::uint16_t ws_queue_limit;
 
+    // How many HTTP requests on one connection may be processed
+    // at the same time. 1 means a request is read only after the
+    // response to the previous one has been sent.
+    std::uint16_t pipeline_limit = 1;
+
     // Returns `true` if any websocket protocols are specified
     bool websockets() const;
 
@@ -91,6 +96,7 @@ struct ParsedPort
     beast::websocket::permessage_deflate pmd_options;
     int limit = 0;
     std::uint16_t ws_queue_limit;
+    std::uint16_t pipeline_limit = 1;
 
     boost::optional<boost::asio::ip::address> ip;
     boost::optional<std::uint16_t> port;
@@ -34,9 +34,11 @@
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/asio/streambuf.hpp>
 #include <boost/asio/spawn.hpp>
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <chrono>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -45,7 +47,14 @@
 
 namespace ripple {
 
-/** Represents an active connection. */
+/** Represents an active connection.
+
+    Requests which are not handed off are given to the Handler's
+    onRequest as separate sessions. When the port allows it, further
+    requests are read and dispatched while earlier ones are still being
+    processed (HTTP/1.1 pipelining). Responses are always sent in the
+    order the requests were received.
+*/
 template<class Handler, class Impl>
 class BaseHTTPPeer
     : public io_list::work
@@ -65,7 +74,10 @@ protected:
 
         // Max seconds without completing a message
         timeoutSeconds = 30,
-        timeoutSecondsLocal = 3 //used for localhost clients
+        timeoutSecondsLocal = 3, //used for localhost clients
+
+        // Seconds to keep using the handler's pipeline limit
+        limitSeconds = 1
     };
 
     struct buffer
@@ -83,6 +95,22 @@ protected:
         std::size_t used;
     };
 
+    // A request whose response has not been completely queued.
+    struct pending
+    {
+        // Guarded by mutex_
+        std::vector<buffer> wq;
+        bool head = false;
+
+        // Accessed on the strand
+        std::shared_ptr<Writer> writer;
+        bool running = false;
+        bool done = false;
+        bool keep_alive = true;
+    };
+
+    class request_session;
+
     Port const& port_;
     Handler& handler_;
     boost::asio::io_service::work work_;
@@ -100,9 +128,18 @@ protected:
     std::vector<buffer> wq2_;
     std::mutex mutex_;
     bool graceful_ = false;
-    bool complete_ = false;
     boost::system::error_code ec_;
 
+    // Requests in the order they were received
+    std::deque<std::shared_ptr<pending>> pipeline_;
+    std::size_t limit_ = 1;
+    std::chrono::steady_clock::time_point limit_expires_;
+    bool reading_ = false;
+    bool read_timer_ = false;
+    bool read_closed_ = false;
+    bool deferred_ = false;
+    bool closed_ = false;
+
     int request_count_ = 0;
     std::size_t bytes_in_ = 0;
     std::size_t bytes_out_ = 0;
@@ -145,6 +182,9 @@ protected:
     void
     on_timer(error_code ec);
 
+    void
+    time_read();
+
     void
     do_read(yield_context do_yield);
 
@@ -156,6 +196,25 @@ protected:
     do_writer(std::shared_ptr <Writer> const& writer,
         bool keep_alive, yield_context do_yield);
 
+    bool
+    writing();
+
+    void
+    maybe_read();
+
+    void
+    dispatch();
+
+    void
+    promote(pending& p);
+
+    void
+    advance();
+
+    void
+    on_finish(std::shared_ptr<pending> const& p,
+        std::shared_ptr<Writer> const& writer, bool keep_alive);
+
     virtual
     void
     do_request() = 0;
@@ -209,6 +268,128 @@ protected:
 
 //------------------------------------------------------------------------------
 
+// The Session given to onRequest for one request on the connection.
+// Output written before the responses to earlier requests have been
+// queued is held here until it is this request's turn.
+template<class Handler, class Impl>
+class BaseHTTPPeer<Handler, Impl>::request_session
+    : public Session
+    , public std::enable_shared_from_this<request_session>
+{
+    std::shared_ptr<Impl> impl_;
+    std::shared_ptr<pending> pending_;
+    http_request_type message_;
+    bool finished_ = false;
+
+public:
+    request_session(std::shared_ptr<Impl> impl,
+        std::shared_ptr<pending> p, http_request_type&& message)
+        : impl_(std::move(impl))
+        , pending_(std::move(p))
+        , message_(std::move(message))
+    {
+    }
+
+    ~request_session()
+    {
+        // Abandoned without a response
+        if(! finished_)
+            finish(nullptr, false);
+    }
+
+    beast::Journal
+    journal() override
+    {
+        return peer().journal_;
+    }
+
+    Port const&
+    port() override
+    {
+        return peer().port_;
+    }
+
+    beast::IP::Endpoint
+    remoteAddress() override
+    {
+        return peer().remoteAddress();
+    }
+
+    http_request_type&
+    request() override
+    {
+        return message_;
+    }
+
+    void
+    write(void const* buffer, std::size_t bytes) override
+    {
+        if(bytes == 0)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(peer().mutex_);
+            if(! pending_->head)
+            {
+                pending_->wq.emplace_back(buffer, bytes);
+                return;
+            }
+        }
+        peer().write(buffer, bytes);
+    }
+
+    void
+    write(std::shared_ptr <Writer> const& writer,
+        bool keep_alive) override
+    {
+        finish(writer, keep_alive);
+    }
+
+    std::shared_ptr<Session>
+    detach() override
+    {
+        return this->shared_from_this();
+    }
+
+    void
+    complete() override
+    {
+        finish(nullptr, true);
+    }
+
+    void
+    close(bool graceful) override
+    {
+        if(graceful)
+            return finish(nullptr, false);
+        peer().close(false);
+    }
+
+    std::shared_ptr<WSSession>
+    websocketUpgrade() override
+    {
+        return impl_->websocketUpgrade();
+    }
+
+private:
+    BaseHTTPPeer&
+    peer()
+    {
+        return *impl_;
+    }
+
+    void
+    finish(std::shared_ptr<Writer> const& writer, bool keep_alive)
+    {
+        if(finished_)
+            return;
+        finished_ = true;
+        peer().strand_.post(std::bind(&BaseHTTPPeer::on_finish,
+            impl_, pending_, writer, keep_alive));
+    }
+};
+
+//------------------------------------------------------------------------------
+
 template<class Handler, class Impl>
 template<class ConstBufferSequence>
 BaseHTTPPeer<Handler, Impl>::
@@ -315,6 +496,19 @@ on_timer(error_code ec)
     fail(ec, "timer");
 }
 
+// Time the read in progress once every request read so far
+// has been answered. A client waiting on responses is not idle.
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+time_read()
+{
+    if(! reading_ || read_timer_ || ! pipeline_.empty() || writing())
+        return;
+    read_timer_ = true;
+    start_timer();
+}
+
 //------------------------------------------------------------------------------
 
 template<class Handler, class Impl>
@@ -322,14 +516,37 @@ void
 BaseHTTPPeer<Handler, Impl>::
 do_read(yield_context do_yield)
 {
-    complete_ = false;
+    reading_ = true;
     error_code ec;
-    start_timer();
+    time_read();
     beast::http::async_read(impl().stream_,
         read_buf_, message_, do_yield[ec]);
-    cancel_timer();
+    reading_ = false;
+    if(read_timer_)
+    {
+        read_timer_ = false;
+        cancel_timer();
+    }
+    if(graceful_)
+    {
+        // The connection is closing, whatever was read is discarded
+        return advance();
+    }
+    if(ec == boost::asio::error::eof && ! pipeline_.empty())
+    {
+        // The client sent its last request, finish answering
+        read_closed_ = true;
+        graceful_ = true;
+        return advance();
+    }
     if(ec)
         return fail(ec, "http::read");
+    if(! pipeline_.empty() && beast::http::is_upgrade(message_))
+    {
+        // The handoff takes the stream, wait for earlier responses
+        deferred_ = true;
+        return advance();
+    }
     do_request();
 }
 
@@ -342,6 +559,7 @@ on_write(error_code const& ec,
     std::size_t bytes_transferred)
 {
     cancel_timer();
+    read_timer_ = false;
     if(ec)
         return fail(ec, "write");
     bytes_out_ += bytes_transferred;
@@ -364,13 +582,14 @@ on_write(error_code const& ec,
                 impl().shared_from_this(), placeholders::error,
                     placeholders::bytes_transferred)));
     }
-    if(! complete_)
-        return;
-    if(graceful_)
-        return do_close();
-    boost::asio::spawn(strand_,
-        std::bind(&BaseHTTPPeer<Handler, Impl>::do_read,
-            impl().shared_from_this(), std::placeholders::_1));
+    // Writes share the timer. The client has everything it was
+    // waiting on so far, so time the read in progress again.
+    if(reading_)
+    {
+        read_timer_ = true;
+        start_timer();
+    }
+    advance();
 }
 
 template<class Handler, class Impl>
@@ -406,11 +625,158 @@ do_writer(std::shared_ptr <Writer> const& writer,
             break;
     }
 
-    if(! keep_alive)
-        return do_close();
+    // The writer belongs to the request at the head of the pipeline
+    if(! pipeline_.empty())
+        pipeline_.front()->writer.reset();
+    advance();
+}
 
-    boost::asio::spawn(strand_, std::bind(&BaseHTTPPeer<Handler, Impl>::do_read,
-        impl().shared_from_this(), std::placeholders::_1));
+template<class Handler, class Impl>
+bool
+BaseHTTPPeer<Handler, Impl>::
+writing()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ! wq_.empty() || ! wq2_.empty();
+}
+
+// Start reading the next request if there is room for it.
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+maybe_read()
+{
+    if(reading_ || read_closed_ || deferred_ || graceful_ || ec_)
+        return;
+    if(pipeline_.empty() ? writing() : pipeline_.size() >= limit_)
+        return;
+    reading_ = true;
+    boost::asio::spawn(strand_,
+        std::bind(&BaseHTTPPeer<Handler, Impl>::do_read,
+            impl().shared_from_this(), std::placeholders::_1));
+}
+
+// Give the request in message_ to the handler.
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+dispatch()
+{
+    if(! is_keep_alive(message_))
+        read_closed_ = true;
+    auto p = std::make_shared<pending>();
+    p->head = pipeline_.empty();
+    pipeline_.push_back(p);
+    auto const session = std::make_shared<request_session>(
+        impl().shared_from_this(), std::move(p), std::move(message_));
+    message_ = {};
+    // Looking up the limit may be costly, and it changes
+    // slowly compared to how fast pipelined requests arrive.
+    auto const now = std::chrono::steady_clock::now();
+    if(now >= limit_expires_)
+    {
+        limit_ = std::max<std::size_t>(handler_.pipelineLimit(*session), 1);
+        limit_expires_ = now + std::chrono::seconds(limitSeconds);
+    }
+    handler_.onRequest(*session);
+    maybe_read();
+}
+
+// Make p the request whose output goes straight to the write queue.
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+promote(pending& p)
+{
+    bool start;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        start = wq_.empty() && wq2_.empty() && ! p.wq.empty();
+        for(auto& b : p.wq)
+            wq_.push_back(std::move(b));
+        p.wq.clear();
+        p.head = true;
+    }
+    if(start)
+        on_write(error_code{}, 0);
+}
+
+// Retire finished requests in order, then decide
+// whether to read, close, or wait.
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+advance()
+{
+    while(! pipeline_.empty())
+    {
+        auto const& head = pipeline_.front();
+        if(! head->done)
+            break;
+        if(head->writer)
+        {
+            // A writer sends directly, after the queued output
+            if(! head->running && ! writing())
+            {
+                head->running = true;
+                boost::asio::spawn(strand_, std::bind(
+                    &BaseHTTPPeer<Handler, Impl>::do_writer,
+                        impl().shared_from_this(), head->writer,
+                            head->keep_alive, std::placeholders::_1));
+            }
+            return;
+        }
+        if(! head->keep_alive)
+        {
+            // Responses to later requests are never sent
+            read_closed_ = true;
+            graceful_ = true;
+            pipeline_.clear();
+            break;
+        }
+        pipeline_.pop_front();
+        if(! pipeline_.empty())
+            promote(*pipeline_.front());
+    }
+
+    if(pipeline_.empty() && ! writing())
+    {
+        if(graceful_)
+        {
+            if(reading_)
+            {
+                // Stop reading ahead, do_read returns here
+                error_code ec;
+                impl().stream_.lowest_layer().cancel(ec);
+                return;
+            }
+            if(! closed_)
+            {
+                closed_ = true;
+                do_close();
+            }
+            return;
+        }
+        if(deferred_)
+        {
+            deferred_ = false;
+            return do_request();
+        }
+        time_read();
+    }
+    maybe_read();
+}
+
+template<class Handler, class Impl>
+void
+BaseHTTPPeer<Handler, Impl>::
+on_finish(std::shared_ptr<pending> const& p,
+    std::shared_ptr<Writer> const& writer, bool keep_alive)
+{
+    p->writer = writer;
+    p->keep_alive = keep_alive;
+    p->done = true;
+    advance();
 }
 
 //------------------------------------------------------------------------------
@@ -441,15 +807,28 @@ write(
     }
 }
 
+// Send a response produced during the handoff. It
+// takes its turn behind the requests already dispatched.
 template<class Handler, class Impl>
 void
 BaseHTTPPeer<Handler, Impl>::
 write(std::shared_ptr <Writer> const& writer,
     bool keep_alive)
 {
-    boost::asio::spawn(strand_, std::bind(
-        &BaseHTTPPeer<Handler, Impl>::do_writer, impl().shared_from_this(),
-            writer, keep_alive, std::placeholders::_1));
+    if(! strand_.running_in_this_thread())
+        return strand_.post(std::bind(
+            (void(BaseHTTPPeer::*)(std::shared_ptr<Writer> const&, bool))
+                &BaseHTTPPeer<Handler, Impl>::write,
+                    impl().shared_from_this(), writer, keep_alive));
+    if(! keep_alive)
+        read_closed_ = true;
+    auto p = std::make_shared<pending>();
+    p->head = pipeline_.empty();
+    p->writer = writer;
+    p->keep_alive = keep_alive;
+    p->done = true;
+    pipeline_.push_back(std::move(p));
+    advance();
 }
 
 // DEPRECATED
@@ -463,7 +842,7 @@ detach()
 }
 
 // DEPRECATED
-// Called to indicate the response has been written(but not sent)
+// Requests are completed through the sessions given to onRequest.
 template<class Handler, class Impl>
 void
 BaseHTTPPeer<Handler, Impl>::
@@ -473,18 +852,7 @@ complete()
         return strand_.post(std::bind(&BaseHTTPPeer<Handler, Impl>::complete,
             impl().shared_from_this()));
 
-    message_ = {};
-    complete_ = true;
-
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if(! wq_.empty() && ! wq2_.empty())
-            return;
-    }
-
-    // keep-alive
-    boost::asio::spawn(strand_, std::bind(&BaseHTTPPeer<Handler, Impl>::do_read,
-        impl().shared_from_this(), std::placeholders::_1));
+    advance();
 }
 
 // DEPRECATED
@@ -499,16 +867,11 @@ close(bool graceful)
            (void(BaseHTTPPeer::*)(bool))&BaseHTTPPeer<Handler, Impl>::close,
                 impl().shared_from_this(), graceful));
 
-    complete_ = true;
     if(graceful)
     {
+        read_closed_ = true;
         graceful_ = true;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if(! wq_.empty() || ! wq2_.empty())
-                return;
-        }
-        return do_close();
+        return advance();
     }
 
     error_code ec;
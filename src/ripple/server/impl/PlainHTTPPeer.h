@@ -137,7 +137,7 @@ do_request()
     if (ec)
         return this->fail(ec, "request");
     // legacy
-    this->handler_.onRequest(this->session());
+    this->dispatch();
 }
 
 template<class Handler>
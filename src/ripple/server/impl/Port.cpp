@@ -233,6 +233,29 @@ parse_Port (ParsedPort& port, Section const& section, std::ostream& log)
         }
     }
 
+    {
+        auto const result = section.find("pipeline_limit");
+        if (result.second)
+        {
+            try
+            {
+                port.pipeline_limit =
+                    beast::lexicalCastThrow<std::uint16_t>(result.first);
+
+                // At least one request must be processed
+                if (port.pipeline_limit == 0)
+                    Throw<std::exception>();
+            }
+            catch (std::exception const&)
+            {
+                log <<
+                    "Invalid value '" << result.first << "' for key " <<
+                    "'pipeline_limit' in [" << section.name() << "]\n";
+                Rethrow();
+            }
+        }
+    }
+
     populate (section, "admin", log, port.admin_ip, true, {});
     populate (section, "secure_gateway", log, port.secure_gateway_ip, false,
         port.admin_ip.get_value_or({}));
@@ -36,6 +36,7 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_lock_guard.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <bitset>
 #include <cassert>
 #include <stack>
 #include <vector>
@@ -190,12 +191,19 @@ public:
         concurrency, to discover nodes referenced in the
         SHAMap but not available locally.
 
+        With more than one thread, the subtrees below the root
+        are divided among the threads, each of which posts its own
+        reads. The nodes found by each thread are interleaved.
+
         @param maxNodes The maximum number of found nodes to return
         @param filter The filter to use when retrieving nodes
+        @param threads The most threads to traverse the map with,
+                       including the caller's
         @param return The nodes known to be missing
     */
     std::vector<std::pair<SHAMapNodeID, uint256>>
-    getMissingNodes (int maxNodes, SHAMapSyncFilter *filter);
+    getMissingNodes (int maxNodes, SHAMapSyncFilter *filter,
+        std::size_t threads = 1);
 
     bool getNodeFat (SHAMapNodeID node,
         std::vector<SHAMapNodeID>& nodeIDs,
@@ -209,6 +217,24 @@ public:
     SHAMapAddNode addKnownNode (SHAMapNodeID const& nodeID, Slice const& rawNode,
                                 SHAMapSyncFilter * filter);
 
+    /** Add a node made by makeKnownNode. */
+    SHAMapAddNode addKnownNode (SHAMapNodeID const& nodeID,
+                                std::shared_ptr<SHAMapAbstractNode> newNode,
+                                SHAMapSyncFilter * filter);
+
+    /** Parse a node received from a peer, and compute its hash.
+
+        This does not use the map, so nodes from several peers can be
+        checked at the same time, on different threads, before they
+        are added.
+
+        @return The node, or null if it could not be parsed.
+    */
+    static
+    std::shared_ptr<SHAMapAbstractNode>
+    makeKnownNode (SHAMapNodeID const& nodeID, Slice const& rawNode,
+                   beast::Journal j);
+
 
     // status functions
     void setImmutable ();
@@ -360,6 +386,9 @@ private:
         // nodes we need to resume after we get their children from deferred reads
         std::map<SHAMapInnerNode*, SHAMapNodeID> resumes_;
 
+        // the branches of the root this traversal descends
+        std::bitset<16> rootBranches_;
+
         MissingNodes (
             int max, SHAMapSyncFilter* filter,
             int maxDefer, std::uint32_t generation) :
@@ -368,10 +397,12 @@ private:
         {
             missingNodes_.reserve (max);
             deferredReads_.reserve(maxDefer);
+            rootBranches_.set ();
         }
     };
 
     // getMissingNodes helper functions
+    void gmn_Traverse (MissingNodes&);
     void gmn_ProcessNodes (MissingNodes&, MissingNodes::StackEntry& node);
     void gmn_ProcessDeferredReads (MissingNodes&);
 };
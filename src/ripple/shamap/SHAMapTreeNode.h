@@ -25,6 +25,7 @@
 #include <ripple/basics/TaggedCache.h>
 #include <ripple/beast/utility/Journal.h>
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <mutex>
@@ -150,7 +151,7 @@ class SHAMapInnerNode
     std::array<SHAMapHash, 16>          mHashes;
     std::shared_ptr<SHAMapAbstractNode> mChildren[16];
     int                             mIsBranch = 0;
-    std::uint32_t                   mFullBelowGen = 0;
+    std::atomic<std::uint32_t>      mFullBelowGen {0};
 
     static std::mutex               childLock;
 public:
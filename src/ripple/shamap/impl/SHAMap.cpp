@@ -252,7 +252,7 @@ SHAMap::fetchNodeFromDB (SHAMapHash const& hash) const
         {
             try
             {
-                node = SHAMapAbstractNode::make(makeSlice(obj->getData()),
+                node = SHAMapAbstractNode::make(obj->getData(),
                     0, snfPREFIX, hash, true, f_.journal());
                 if (node && node->isInner())
                 {
@@ -490,7 +490,7 @@ SHAMap::descendAsync (SHAMapInnerNode* parent, int branch,
             if (!obj)
                 return nullptr;
 
-            ptr = SHAMapAbstractNode::make(makeSlice(obj->getData()), 0, snfPREFIX,
+            ptr = SHAMapAbstractNode::make(obj->getData(), 0, snfPREFIX,
                                            hash, true, f_.journal());
             if (ptr && backed_)
                 canonicalize (hash, ptr);
@@ -19,8 +19,11 @@
 
 #include <BeastConfig.h>
 #include <ripple/basics/random.h>
+#include <ripple/basics/StrandWorkers.h>
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/nodestore/Database.h>
+#include <algorithm>
+#include <exception>
 
 namespace ripple {
 
@@ -118,6 +121,13 @@ void SHAMap::gmn_ProcessNodes (MissingNodes& mn, MissingNodes::StackEntry& se)
         if (node->isEmptyBranch (branch))
             continue;
 
+        if (! mn.rootBranches_[branch] && node == root_.get ())
+        {
+            // another traversal descends this branch
+            fullBelow = false;
+            continue;
+        }
+
         auto const& childHash = node->getChildHash (branch);
 
         if (mn.missingHashes_.count (childHash) != 0)
@@ -235,29 +245,11 @@ void SHAMap::gmn_ProcessDeferredReads (MissingNodes& mn)
     }
 }
 
-/** Get a list of node IDs and hashes for nodes that are part of this SHAMap
-    but not available locally.  The filter can hold alternate sources of
-    nodes that are not permanently stored locally
-*/
-std::vector<std::pair<SHAMapNodeID, uint256>>
-SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
+// Traverse the branches of the root given by
+// the MissingNodes, until the nodes below them are
+// all found or as many missing nodes are found as asked for.
+void SHAMap::gmn_Traverse (MissingNodes& mn)
 {
-    assert (root_->isValid ());
-    assert (root_->getNodeHash().isNonZero ());
-    assert (max > 0);
-
-    MissingNodes mn (max, filter,
-        f_.db().getDesiredAsyncReadCount(),
-        f_.fullbelow().getGeneration());
-
-    if (! root_->isInner () ||
-            std::static_pointer_cast<SHAMapInnerNode>(root_)->
-                isFullBelow (mn.generation_))
-    {
-        clearSynching ();
-        return std::move (mn.missingNodes_);
-    }
-
     // Start at the root.
     // The firstChild value is selected randomly so if multiple threads
     // are traversing the map, each thread will start at a different
@@ -281,7 +273,7 @@ SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
             gmn_ProcessNodes (mn, pos);
 
             if (mn.max_ <= 0)
-                return std::move(mn.missingNodes_);
+                return;
 
             if ((node == nullptr) && ! mn.stack_.empty ())
             {
@@ -311,7 +303,7 @@ SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
             gmn_ProcessDeferredReads(mn);
 
         if (mn.max_ <= 0)
-            return std::move(mn.missingNodes_);
+            return;
 
         if (node == nullptr)
         { // We weren't in the middle of processing a node
@@ -341,11 +333,126 @@ SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
         // and we have no nodes to resume
 
     } while (node != nullptr);
+}
+
+/** Get a list of node IDs and hashes for nodes that are part of this SHAMap
+    but not available locally.  The filter can hold alternate sources of
+    nodes that are not permanently stored locally
+*/
+std::vector<std::pair<SHAMapNodeID, uint256>>
+SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter,
+    std::size_t threads)
+{
+    assert (root_->isValid ());
+    assert (root_->getNodeHash().isNonZero ());
+    assert (max > 0);
+
+    auto const generation = f_.fullbelow().getGeneration();
+    auto const maxDefer = f_.db().getDesiredAsyncReadCount();
+
+    if (! root_->isInner () ||
+            std::static_pointer_cast<SHAMapInnerNode>(root_)->
+                isFullBelow (generation))
+    {
+        clearSynching ();
+        return {};
+    }
+
+    auto const root = static_cast<SHAMapInnerNode*>(root_.get());
+    auto const poolSize = threads;
+
+    // The branches of the root which may have missing nodes below them
+    std::vector<int> branches;
+    if (threads > 1)
+    {
+        int const firstChild = rand_int(255);
+        for (int i = 0; i < 16; ++i)
+        {
+            int const branch = (firstChild + i) % 16;
+            if (! root->isEmptyBranch (branch) && (! backed_ ||
+                ! f_.fullbelow().touch_if_exists (
+                    root->getChildHash (branch).as_uint256())))
+                branches.push_back (branch);
+        }
+        threads = std::min (threads, branches.size ());
+    }
 
-    if (mn.missingNodes_.empty ())
+    if (threads < 2)
+    {
+        MissingNodes mn (max, filter, maxDefer, generation);
+        gmn_Traverse (mn);
+
+        if (mn.missingNodes_.empty ())
+            clearSynching ();
+
+        return std::move(mn.missingNodes_);
+    }
+
+    // Divide the branches among the threads of a pool kept for maps
+    // synced with this many threads. Each thread posts its own reads,
+    // so more reads are outstanding at once.
+    int const deferEach = std::max (maxDefer / static_cast<int>(threads), 1);
+    std::vector<std::unique_ptr<MissingNodes>> work;
+    work.reserve (threads);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        work.push_back (std::make_unique<MissingNodes> (
+            max, filter, deferEach, generation));
+        work.back()->rootBranches_.reset ();
+    }
+    for (std::size_t i = 0; i < branches.size (); ++i)
+        work[i % threads]->rootBranches_.set (branches[i]);
+
+    std::vector<std::exception_ptr> errors (threads);
+    auto const traverse = [this, &work, &errors](std::size_t i)
+    {
+        try
+        {
+            gmn_Traverse (*work[i]);
+        }
+        catch (std::exception const&)
+        {
+            errors[i] = std::current_exception ();
+        }
+    };
+
+    StrandWorkers::instance (poolSize).run (threads, traverse);
+
+    for (auto const& e : errors)
+        if (e)
+            std::rethrow_exception (e);
+
+    // Take the nodes found by each thread in turn, so a short
+    // list still asks for nodes from every part of the map
+    std::size_t const limit = max;
+    std::vector<std::pair<SHAMapNodeID, uint256>> missingNodes;
+    missingNodes.reserve (limit);
+    for (std::size_t i = 0; missingNodes.size () < limit; ++i)
+    {
+        bool more = false;
+        for (auto const& mn : work)
+        {
+            if (i < mn->missingNodes_.size () &&
+                missingNodes.size () < limit)
+            {
+                missingNodes.push_back (mn->missingNodes_[i]);
+                more = true;
+            }
+        }
+        if (! more)
+            break;
+    }
+
+    if (missingNodes.empty ())
+    {
+        // Each thread found every node below its branches
+        root->setFullBelowGen (generation);
+        if (backed_)
+            f_.fullbelow().insert (root->getNodeHash ().as_uint256());
         clearSynching ();
+    }
 
-    return std::move(mn.missingNodes_);
+    return missingNodes;
 }
 
 std::vector<uint256> SHAMap::getNeededHashes (int max, SHAMapSyncFilter* filter)
@@ -517,9 +624,40 @@ SHAMap::addKnownNode (const SHAMapNodeID& node, Slice const& rawNode,
         return SHAMapAddNode::duplicate ();
     }
 
+    return addKnownNode (node,
+        makeKnownNode (node, rawNode, f_.journal()), filter);
+}
+
+std::shared_ptr<SHAMapAbstractNode>
+SHAMap::makeKnownNode (SHAMapNodeID const& node, Slice const& rawNode,
+                       beast::Journal j)
+{
+    try
+    {
+        return SHAMapAbstractNode::make(rawNode, 0, snfWIRE,
+            SHAMapHash{}, false, j, node);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(j.warn()) << "Invalid node received: " << e.what();
+        return nullptr;
+    }
+}
+
+SHAMapAddNode
+SHAMap::addKnownNode (SHAMapNodeID const& node,
+                      std::shared_ptr<SHAMapAbstractNode> newNode,
+                      SHAMapSyncFilter* filter)
+{
+    assert (!node.isRoot ());
+
+    if (!isSynching ())
+    {
+        JLOG(journal_.trace()) << "AddKnownNode while not synching";
+        return SHAMapAddNode::duplicate ();
+    }
+
     std::uint32_t generation = f_.fullbelow().getGeneration();
-    auto newNode = SHAMapAbstractNode::make(rawNode, 0, snfWIRE,
-                      SHAMapHash{}, false, f_.journal(), node);
     SHAMapNodeID iNodeID;
     auto iNode = root_.get();
 
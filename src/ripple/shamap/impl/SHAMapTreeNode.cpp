@@ -42,7 +42,7 @@ SHAMapInnerNode::clone(std::uint32_t seq) const
     auto p = std::make_shared<SHAMapInnerNode>(seq);
     p->mHash = mHash;
     p->mIsBranch = mIsBranch;
-    p->mFullBelowGen = mFullBelowGen;
+    p->mFullBelowGen = mFullBelowGen.load();
     p->mHashes = mHashes;
     std::lock_guard <std::mutex> lock(childLock);
     for (int i = 0; i < 16; ++i)
@@ -59,7 +59,7 @@ SHAMapInnerNodeV2::clone(std::uint32_t seq) const
     auto p = std::make_shared<SHAMapInnerNodeV2>(seq);
     p->mHash = mHash;
     p->mIsBranch = mIsBranch;
-    p->mFullBelowGen = mFullBelowGen;
+    p->mFullBelowGen = mFullBelowGen.load();
     p->mHashes = mHashes;
     p->common_ = common_;
     p->depth_ = depth_;
@@ -505,9 +505,16 @@ SHAMapInnerNodeV2::updateHash()
 
     if (mIsBranch != 0)
     {
-        Serializer s(580);
-        addRaw (s, snfPREFIX);
-        nh = s.getSHA512Half();
+        sha512_half_hasher h;
+        using beast::hash_append;
+        hash_append(h, HashPrefix::innerNodeV2);
+        for(auto const& hh : mHashes)
+            hash_append(h, hh);
+        auto const depth = static_cast<std::uint8_t>(depth_);
+        h(&depth, 1);
+        h(common_.data(), (depth_ + 1) / 2);
+        nh = static_cast<typename
+            sha512_half_hasher::result_type>(h);
     }
 
     if (nh == mHash.as_uint256())
@@ -22,6 +22,7 @@
 #include <ripple/app/ledger/AcceptedLedger.cpp>
 #include <ripple/app/ledger/AcceptedLedgerTx.cpp>
 #include <ripple/app/ledger/AccountStateSF.cpp>
+#include <ripple/app/ledger/BookIndex.cpp>
 #include <ripple/app/ledger/BookListeners.cpp>
 #include <ripple/app/ledger/ConsensusTransSetSF.cpp>
 #include <ripple/app/ledger/Ledger.cpp>
@@ -34,8 +35,10 @@
 #include <ripple/app/ledger/impl/InboundTransactions.cpp>
 #include <ripple/app/ledger/impl/LedgerCleaner.cpp>
 #include <ripple/app/ledger/impl/LedgerMaster.cpp>
+#include <ripple/app/ledger/impl/LedgerSnapshot.cpp>
 #include <ripple/app/ledger/impl/LocalTxs.cpp>
 #include <ripple/app/ledger/impl/OpenLedger.cpp>
+#include <ripple/app/ledger/impl/RecentLedgers.cpp>
 #include <ripple/app/ledger/impl/LedgerToJson.cpp>
 #include <ripple/app/ledger/impl/TransactionAcquire.cpp>
 #include <ripple/app/ledger/impl/TransactionMaster.cpp>
@@ -29,6 +29,7 @@
 #include <ripple/basics/impl/RangeSet.cpp>
 #include <ripple/basics/impl/ResolverAsio.cpp>
 #include <ripple/basics/impl/strHex.cpp>
+#include <ripple/basics/impl/StrandWorkers.cpp>
 #include <ripple/basics/impl/StringUtilities.cpp>
 #include <ripple/basics/impl/Sustain.cpp>
 #include <ripple/basics/impl/Time.cpp>
@@ -26,6 +26,7 @@
 #include <ripple/nodestore/backend/RocksDBQuickFactory.cpp>
 
 #include <ripple/nodestore/impl/BatchWriter.cpp>
+#include <ripple/nodestore/impl/CompressionDictionary.cpp>
 #include <ripple/nodestore/impl/DatabaseImp.h>
 #include <ripple/nodestore/impl/DatabaseRotatingImp.cpp>
 #include <ripple/nodestore/impl/DummyScheduler.cpp>
@@ -27,6 +27,7 @@
 #include <ripple/overlay/impl/PeerSet.cpp>
 #include <ripple/overlay/impl/TMHello.cpp>
 #include <ripple/overlay/impl/TrafficCount.cpp>
+#include <ripple/overlay/impl/TxAdmission.cpp>
 
 #if DOXYGEN
 #include <ripple/overlay/README.md>
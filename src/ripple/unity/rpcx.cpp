@@ -58,6 +58,7 @@
 #include <ripple/rpc/handlers/LedgerEntry.cpp>
 #include <ripple/rpc/handlers/LedgerHeader.cpp>
 #include <ripple/rpc/handlers/LedgerRequest.cpp>
+#include <ripple/rpc/handlers/LedgerSnapshot.cpp>
 #include <ripple/rpc/handlers/LogLevel.cpp>
 #include <ripple/rpc/handlers/LogRotate.cpp>
 #include <ripple/rpc/handlers/NoRippleCheck.cpp>
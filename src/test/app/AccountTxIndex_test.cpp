@@ -0,0 +1,345 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/main/DBInit.h>
+#include <ripple/app/misc/impl/AccountTxPaging.h>
+#include <ripple/basics/random.h>
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/protocol/AccountID.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+namespace ripple {
+
+class AccountTxIndexSuite : public beast::unit_test::suite
+{
+protected:
+    using clock_type = std::chrono::steady_clock;
+
+    // Ledger sequence, status, raw transaction and metadata of a row
+    using Row = std::tuple<std::uint32_t, std::string, Blob, Blob>;
+
+    static std::size_t const txPerLedger = 40;
+    static std::size_t const accounts = 10000;
+
+    static
+    AccountID
+    makeAccount (std::size_t i)
+    {
+        AccountID id;
+        std::memcpy (id.data(), &i, sizeof(i));
+        return id;
+    }
+
+    static
+    std::unique_ptr<DatabaseCon>
+    makeDatabase (beast::temp_dir const& td)
+    {
+        DatabaseCon::Setup setup;
+        setup.dataDir = td.path();
+        auto con = std::make_unique<DatabaseCon> (
+            setup, "transaction.db", TxnDBInit, TxnDBCount);
+        auto db = con->checkoutDb();
+        for (int i = 0; i < AccountTxIndexDBCount; ++i)
+            *db << AccountTxIndexDBInit[i];
+        return con;
+    }
+
+    // Write ledgers first + 1 to last to the AccountTransactions and
+    // Transactions tables, the way they are saved without the index
+    static
+    void
+    fill (DatabaseCon& con, std::uint32_t first, std::uint32_t last,
+        AccountID const& busy)
+    {
+        beast::xor_shift_engine rng (first + 1);
+        AccountIDCache idCache (128);
+        auto& session = con.getSession();
+
+        std::string transID;
+        std::int64_t ledgerSeq = 0;
+        std::int64_t txnSeq = 0;
+        std::string account;
+        std::string const status (1, TXN_SQL_VALIDATED);
+        Blob raw (200);
+        Blob meta (400);
+        soci::blob rawTxn (session);
+        soci::blob rawMeta (session);
+
+        soci::statement tx = (session.prepare <<
+            R"(INSERT INTO Transactions
+               (TransID, LedgerSeq, Status, RawTxn, TxnMeta)
+               VALUES (:id, :ledgerSeq, :status, :rawTxn, :rawMeta);)",
+            soci::use (transID), soci::use (ledgerSeq), soci::use (status),
+            soci::use (rawTxn), soci::use (rawMeta));
+
+        soci::statement acctTx = (session.prepare <<
+            R"(INSERT INTO AccountTransactions
+               (TransID, Account, LedgerSeq, TxnSeq)
+               VALUES (:id, :account, :ledgerSeq, :txnSeq);)",
+            soci::use (transID), soci::use (account),
+            soci::use (ledgerSeq), soci::use (txnSeq));
+
+        std::uint64_t n = first * txPerLedger;
+        for (std::uint32_t seq = first + 1; seq <= last; ++seq)
+        {
+            soci::transaction tr (session);
+            ledgerSeq = seq;
+            for (std::size_t i = 0; i < txPerLedger; ++i)
+            {
+                transID = to_string (uint256 (++n));
+                txnSeq = i;
+                raw[0] = static_cast<std::uint8_t>(n);
+                meta[0] = static_cast<std::uint8_t>(n);
+                convert (raw, rawTxn);
+                convert (meta, rawMeta);
+                tx.execute (true);
+
+                // Every fourth transaction involves the busy account
+                for (int j = 0; j < 2; ++j)
+                {
+                    auto const id = (j == 0 && i % 4 == 0) ? busy :
+                        makeAccount (rand_int (rng, accounts - 1));
+                    account = idCache.toBase58 (id);
+                    acctTx.execute (true);
+                }
+            }
+            tr.commit ();
+        }
+    }
+
+    // Read all of an account's history from the joined tables or the index
+    std::vector<Row>
+    readAll (DatabaseCon& con, AccountID const& account,
+        std::uint32_t ledgers, bool forward, bool index,
+            std::size_t* pages = nullptr)
+    {
+        std::vector<Row> rows;
+        auto const onTransaction = [&rows](std::uint32_t ledger,
+            std::string const& status, Blob const& rawTxn,
+                Blob const& rawMeta)
+        {
+            rows.emplace_back (ledger, status, rawTxn, rawMeta);
+        };
+        auto const unsaved = [this](std::uint32_t seq)
+        {
+            fail ("ledger " + std::to_string (seq) + " has no metadata");
+        };
+
+        AccountIDCache idCache (128);
+        Json::Value token;
+        do
+        {
+            if (index)
+                accountTxIndexPage (con, unsaved, onTransaction,
+                    account, 0, ledgers, forward, token, 200, true, 200);
+            else
+                accountTxPage (con, idCache, unsaved, onTransaction,
+                    account, 0, ledgers, forward, token, 200, true, 200);
+            if (pages)
+                ++*pages;
+        }
+        while (! token.isNull());
+        return rows;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+class AccountTxIndexImport_test : public AccountTxIndexSuite
+{
+    // Import until done, returning the number of batches
+    std::size_t
+    import (DatabaseCon& con)
+    {
+        AccountTxIndexImport importer (con, beast::Journal{}, 100);
+        std::size_t steps = 0;
+        if (importer.start())
+        {
+            while (importer.step())
+                ++steps;
+            ++steps;
+        }
+        BEAST_EXPECT(importer.complete());
+        return steps;
+    }
+
+    std::vector<std::pair<std::int64_t, std::int64_t>>
+    ranges (DatabaseCon& con)
+    {
+        std::vector<std::pair<std::int64_t, std::int64_t>> result;
+        auto db = con.checkoutDb();
+        std::int64_t low = 0;
+        std::int64_t high = 0;
+        soci::statement st = (db->prepare <<
+            "SELECT Low, High FROM AccountTxIndexRanges ORDER BY Low;",
+            soci::into (low), soci::into (high));
+        st.execute();
+        while (st.fetch())
+            result.emplace_back (low, high);
+        return result;
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase ("import");
+
+        beast::temp_dir td;
+        auto const con = makeDatabase (td);
+        auto const busy = makeAccount (accounts);
+
+        // Nothing to import
+        BEAST_EXPECT(import (*con) == 0);
+
+        // History from before the index was enabled
+        fill (*con, 0, 150, busy);
+        BEAST_EXPECT(import (*con) == 2);
+        BEAST_EXPECT((ranges (*con) ==
+            decltype(ranges (*con)){{1, 150}}));
+
+        // Newer history joins the range below it
+        fill (*con, 150, 170, busy);
+        BEAST_EXPECT(import (*con) == 1);
+        BEAST_EXPECT((ranges (*con) ==
+            decltype(ranges (*con)){{1, 170}}));
+
+        // Ledgers missing from the middle of the index, as when
+        // it was disabled for a while, are imported again
+        {
+            auto db = con->checkoutDb();
+            *db << "DELETE FROM AccountTxIndex "
+                "WHERE LedgerSeq BETWEEN 151 AND 160;";
+            *db << "DELETE FROM AccountTxIndexRanges;";
+            addAccountTxIndexRange (*db, 161, 170);
+            addAccountTxIndexRange (*db, 1, 150);
+        }
+        BEAST_EXPECT((ranges (*con) ==
+            decltype(ranges (*con)){{1, 150}, {161, 170}}));
+        BEAST_EXPECT(import (*con) == 1);
+        BEAST_EXPECT((ranges (*con) ==
+            decltype(ranges (*con)){{1, 170}}));
+
+        for (auto const forward : { true, false })
+        {
+            auto const joined = readAll (*con, busy, 170, forward, false);
+            BEAST_EXPECT(joined.size() == 170 * txPerLedger / 4);
+            BEAST_EXPECT(joined ==
+                readAll (*con, busy, 170, forward, true));
+        }
+
+        BEAST_EXPECT(import (*con) == 0);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/*  Compares paging through an account's history using the joined
+    AccountTransactions and Transactions tables against the
+    AccountTxIndex table.
+
+    A transaction database is filled with synthetic ledgers in which
+    one account takes part in a share of all transactions, the index
+    is built from it, then the busy account's history is read a page
+    at a time, both ways.
+
+    The argument is the number of ledgers, default 20000.
+*/
+class AccountTxIndex_test : public AccountTxIndexSuite
+{
+    static
+    std::string
+    ms (clock_type::duration d)
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) <<
+            std::chrono::duration<double, std::milli>(d).count() << "ms";
+        return ss.str();
+    }
+
+    std::vector<Row>
+    timeAll (DatabaseCon& con, AccountID const& account,
+        std::uint32_t ledgers, bool forward, bool index)
+    {
+        std::size_t pages = 0;
+        auto const start = clock_type::now();
+        auto rows = readAll (con, account, ledgers, forward, index, &pages);
+        auto const elapsed = clock_type::now() - start;
+
+        log << std::left << std::setw(8) <<
+            (index ? "index" : "joined") << std::right <<
+            (forward ? " forward  " : " backward ") <<
+            std::setw(6) << pages << " pages " <<
+            std::setw(10) << ms (elapsed) << std::endl;
+        return rows;
+    }
+
+public:
+    void
+    run() override
+    {
+        std::uint32_t ledgers = 20000;
+        if (! arg().empty())
+            ledgers = std::stoul (arg());
+
+        testcase ("paging");
+
+        beast::temp_dir td;
+        auto const con = makeDatabase (td);
+
+        auto const busy = makeAccount (accounts);
+        auto start = clock_type::now();
+        fill (*con, 0, ledgers, busy);
+        log << ledgers << " ledgers written in " <<
+            ms (clock_type::now() - start) << std::endl;
+
+        start = clock_type::now();
+        AccountTxIndexImport importer (*con, beast::Journal{});
+        if (importer.start())
+            while (importer.step())
+                ;
+        BEAST_EXPECT(importer.complete());
+        log << "Index built in " <<
+            ms (clock_type::now() - start) << std::endl;
+
+        for (auto const forward : { true, false })
+        {
+            auto const joined = timeAll (*con, busy, ledgers, forward, false);
+            auto const indexed = timeAll (*con, busy, ledgers, forward, true);
+            BEAST_EXPECT(joined.size() == ledgers * txPerLedger / 4);
+            BEAST_EXPECT(joined == indexed);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AccountTxIndexImport,app,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(AccountTxIndex,app,ripple);
+
+}
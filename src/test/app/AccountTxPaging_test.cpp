@@ -56,12 +56,17 @@ class AccountTxPaging_test : public beast::unit_test::suite
     }
 
     void
-    testAccountTxPaging ()
+    testAccountTxPaging (bool index)
     {
-        testcase("Paging for Single Account");
+        testcase(std::string("Paging for Single Account") +
+            (index ? " with index" : ""));
         using namespace test::jtx;
 
-        Env env(*this);
+        Env env {*this, envconfig([index](std::unique_ptr<Config> cfg)
+            {
+                cfg->ACCOUNT_TX_INDEX = index;
+                return cfg;
+            })};
         Account A1 {"A1"};
         Account A2 {"A2"};
         Account A3 {"A3"};
@@ -262,7 +267,8 @@ public:
     void
     run() override
     {
-        testAccountTxPaging();
+        testAccountTxPaging(false);
+        testAccountTxPaging(true);
     }
 };
 
@@ -25,8 +25,13 @@
 #include <ripple/ledger/PaymentSandbox.h>
 #include <ripple/ledger/Sandbox.h>
 #include <test/jtx/PathSet.h>
+#include <test/parse_args.h>
 #include <ripple/protocol/Feature.h>
 #include <ripple/protocol/JsonFields.h>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <sstream>
 
 namespace ripple {
 namespace test {
@@ -1237,6 +1242,73 @@ struct Flow_test : public beast::unit_test::suite
 
 
 
+    void
+    testParallelStrands (std::initializer_list<uint256> fs)
+    {
+        testcase ("Parallel strands");
+
+        using namespace jtx;
+
+        auto const gw = Account ("gateway");
+        auto const USD = gw["USD"];
+        auto const BTC = gw["BTC"];
+        auto const EUR = gw["EUR"];
+        auto const JPY = gw["JPY"];
+        Account const alice ("alice");
+        Account const bob ("bob");
+        Account const carol ("carol");
+
+        // Pay through books of different qualities, so that the best
+        // strand changes from one pass to the next
+        auto const payments = [&](std::size_t threads)
+        {
+            Env env (*this, envconfig ([threads](std::unique_ptr<Config> cfg)
+                {
+                    cfg->PARALLEL_STRANDS = threads;
+                    return cfg;
+                }), features (fs));
+
+            env.fund (XRP (100000), alice, bob, carol, gw);
+            env.trust (USD (10000), bob, carol);
+            env.trust (BTC (10000), alice, bob);
+            env.trust (EUR (10000), bob);
+            env.trust (JPY (10000), bob);
+            env (pay (gw, alice, BTC (1000)));
+            env (pay (gw, bob, USD (1000)));
+            env (pay (gw, bob, EUR (1000)));
+            env (pay (gw, bob, JPY (1000)));
+            env.close ();
+
+            for (int i = 0; i < 4; ++i)
+            {
+                env (offer (bob, BTC (10 + i), USD (10)));
+                env (offer (bob, BTC (10 + i), XRP (10)));
+                env (offer (bob, XRP (10), USD (10 - i)));
+                env (offer (bob, BTC (10), EUR (10 - i)));
+                env (offer (bob, EUR (10), USD (10 - i)));
+                env (offer (bob, BTC (10 + 2 * i), JPY (10)));
+                env (offer (bob, JPY (10), USD (10)));
+            }
+            env.close ();
+
+            env (pay (alice, carol, USD (100)), path (~USD),
+                path (~XRP, ~USD), path (~EUR, ~USD), path (~JPY, ~USD),
+                sendmax (BTC (200)), txflags (tfPartialPayment));
+            env.close ();
+
+            return std::vector<STAmount>{
+                env.balance (alice, BTC), env.balance (carol, USD),
+                env.balance (bob, BTC), env.balance (bob, USD),
+                env.balance (bob, EUR), env.balance (bob, JPY),
+                env.balance (bob)};
+        };
+
+        auto const serial = payments (0);
+        BEAST_EXPECT(serial[1] > USD (0));
+        for (std::size_t threads : {2, 4})
+            BEAST_EXPECT(payments (threads) == serial);
+    }
+
     void run() override
     {
         testLimitQuality();
@@ -1264,6 +1336,7 @@ struct Flow_test : public beast::unit_test::suite
             testUnfundedOffer(false,  {fs...});
             testReexecuteDirectStep({fix1368, fs...});
             testSelfPayLowQualityOffer({fs...});
+            testParallelStrands({fs...});
         };
         testWithFeats();
         testWithFeats(featureFlow);
@@ -1274,5 +1347,140 @@ struct Flow_test : public beast::unit_test::suite
 
 BEAST_DEFINE_TESTSUITE(Flow,app,ripple);
 
+/*  Times cross-currency payments through several books at once.
+
+    Each payment may take liquidity from a direct book and from a path
+    through each of a number of other currencies. The offers in each
+    book have different qualities, so the payment engine makes many
+    passes over the strands. The payments are made with the strands
+    evaluated serially and then on a number of threads.
+*/
+class Flow_manual_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct Result
+    {
+        double millis = 0;
+        STAmount delivered;
+    };
+
+    Result
+    payments (std::size_t threads, std::size_t books, int count)
+    {
+        using namespace jtx;
+
+        Env env (*this, envconfig ([threads](std::unique_ptr<Config> cfg)
+            {
+                cfg->PARALLEL_STRANDS = threads;
+                return cfg;
+            }), features (featureFlow, fix1373));
+
+        auto const gw = Account ("gateway");
+        auto const USD = gw["USD"];
+        auto const BTC = gw["BTC"];
+        Account const alice ("alice");
+        Account const bob ("bob");
+        Account const carol ("carol");
+
+        env.fund (XRP (10000000), alice, bob, carol, gw);
+        env.trust (USD (10000000), bob, carol);
+        env.trust (BTC (10000000), alice, bob);
+        env (pay (gw, alice, BTC (1000000)));
+        env (pay (gw, bob, USD (1000000)));
+
+        std::vector<IOU> middle;
+        for (auto const name : {"EUR", "JPY", "GBP", "CAD", "AUD", "CHF"})
+        {
+            if (middle.size () == books)
+                break;
+            middle.push_back (gw[name]);
+            env.trust (middle.back () (10000000), bob);
+            env (pay (gw, bob, middle.back () (1000000)));
+        }
+        env.close ();
+
+        // Each payment takes about one offer from each path
+        for (int i = 0; i < count; ++i)
+        {
+            env (offer (bob, BTC (1000 + 2 * i), USD (100)));
+            for (std::size_t k = 0; k < middle.size (); ++k)
+            {
+                env (offer (bob, BTC (1000 + 2 * i + k + 1), middle[k] (100)));
+                env (offer (bob, middle[k] (100), USD (100)));
+            }
+            if (i % 32 == 31)
+                env.close ();
+        }
+        env.close ();
+
+        auto const start = clock_type::now ();
+        for (int i = 0; i < count; ++i)
+        {
+            auto jt = env.jt (pay (alice, carol, USD (100 * (books + 1))),
+                path (~USD), sendmax (BTC (1000000)),
+                txflags (tfPartialPayment));
+            for (auto const& m : middle)
+                path (~m, ~USD) (env, jt);
+            env (jt);
+        }
+        env.close ();
+
+        Result result;
+        result.millis = std::chrono::duration<double, std::milli>(
+            clock_type::now () - start).count ();
+        result.delivered = env.balance (carol, USD);
+        return result;
+    }
+
+public:
+    void
+    run () override
+    {
+        if (arg () == "help")
+        {
+            log <<
+                "Usage:\n" <<
+                "--unittest-arg=[threads=<threads>][,books=<books>]"
+                    "[,payments=<payments>]\n" <<
+                "threads:  Threads evaluating strands, default 4\n" <<
+                "books:    Currencies between BTC and USD, at most 5, "
+                    "default 5\n" <<
+                "payments: Number of payments, default 100" << std::endl;
+            pass ();
+            return;
+        }
+
+        auto const args = parse_args (arg ());
+        auto const arg_or = [&args](std::string const& name,
+            std::string const& def)
+        {
+            auto const iter = args.find (name);
+            return iter == args.end () ? def : iter->second;
+        };
+
+        auto const threads = std::stoul (arg_or ("threads", "4"));
+        auto const books = std::min<std::size_t> (5,
+            std::stoul (arg_or ("books", "5")));
+        auto const count = std::stoi (arg_or ("payments", "100"));
+
+        testcase (std::to_string (books + 1) + " paths");
+
+        auto const serial = payments (0, books, count);
+        auto const parallel = payments (threads, books, count);
+        BEAST_EXPECT(parallel.delivered == serial.delivered);
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision (3) <<
+            count << " payments delivering " << serial.delivered.getText () <<
+            "\nSerial:     " << serial.millis / count << "ms per payment" <<
+            "\n" << threads << " threads: " << parallel.millis / count <<
+            "ms per payment";
+        log << ss.str () << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(Flow_manual,app,ripple);
+
 } // test
 } // ripple
@@ -21,6 +21,14 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/rngfill.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace test {
@@ -229,6 +237,44 @@ class HashRouter_test : public beast::unit_test::suite
         BEAST_EXPECT(peers && peers->size() == 0);
     }
 
+    void
+    testShards()
+    {
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 2s);
+
+        // The leading byte selects the shard
+        uint256 key1(1);
+        uint256 key2(2);
+        uint256 key3(1);
+        *key3.begin() = 1;
+        uint256 key4(2);
+        *key4.begin() = 1;
+
+        // t=0
+        router.setFlags(key1, 111);
+        router.setFlags(key3, 333);
+
+        ++stopwatch;
+        ++stopwatch;
+
+        // t=2
+        // An insertion only expires entries in its own shard
+        router.setFlags(key2, 222);
+        BEAST_EXPECT(router.getFlags(key3) == 333);
+        BEAST_EXPECT(router.getFlags(key1) == 0);
+
+        ++stopwatch;
+        ++stopwatch;
+
+        // t=4
+        router.setFlags(key4, 444);
+        BEAST_EXPECT(router.getFlags(key3) == 0);
+        BEAST_EXPECT(router.getFlags(key4) == 444);
+        BEAST_EXPECT(router.getFlags(key2) == 222);
+    }
+
 public:
 
     void
@@ -239,10 +285,153 @@ public:
         testSuppression();
         testSetFlags();
         testRelay();
+        testShards();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(HashRouter, app, ripple);
 
+//------------------------------------------------------------------------------
+
+/*  Measures the router under concurrent load resembling a hub with many
+    peers, where each message arrives from several peers at once.
+
+    Each thread plays a group of peers: for every message it suppresses
+    the hash for each of its peers and asks whether to relay it, and a
+    share of the messages also have their flags read and set the way
+    checkValidity does. The same workload is run against the router
+    wrapped in a single lock, as it was before it was sharded.
+
+    The argument is the number of threads, default 8.
+*/
+class HashRouterStress_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Serializes every call, like the unsharded router
+    class Serialized
+    {
+    public:
+        explicit Serialized (HashRouter& router)
+            : router_ (router)
+        {
+        }
+
+        bool addSuppressionPeer (uint256 const& key,
+            HashRouter::PeerShortID peer)
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            return router_.addSuppressionPeer (key, peer);
+        }
+
+        bool setFlags (uint256 const& key, int flags)
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            return router_.setFlags (key, flags);
+        }
+
+        int getFlags (uint256 const& key)
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            return router_.getFlags (key);
+        }
+
+        boost::optional<std::set<HashRouter::PeerShortID>>
+        shouldRelay (uint256 const& key)
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            return router_.shouldRelay (key);
+        }
+
+    private:
+        std::mutex mutex_;
+        HashRouter& router_;
+    };
+
+    template <class Router>
+    void
+    measure (std::string const& name, Router& router,
+        std::vector<uint256> const& keys, std::size_t threads)
+    {
+        std::size_t const peersPerThread = 16;
+        std::atomic<std::size_t> relayed (0);
+
+        auto const start = clock_type::now();
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back (
+                [&, t]
+                {
+                    std::size_t n = 0;
+                    for (std::size_t i = 0; i < keys.size(); ++i)
+                    {
+                        // Threads see messages in different orders
+                        auto const& key =
+                            keys[(i + t * keys.size() / threads) % keys.size()];
+                        for (std::size_t p = 0; p < peersPerThread; ++p)
+                            router.addSuppressionPeer (key,
+                                static_cast<HashRouter::PeerShortID>(
+                                    t * peersPerThread + p + 1));
+                        if (i % 4 == 0 &&
+                                (router.getFlags (key) & SF_PRIVATE1) == 0)
+                            router.setFlags (key, SF_PRIVATE1);
+                        if (router.shouldRelay (key))
+                            ++n;
+                    }
+                    relayed += n;
+                });
+        }
+        for (auto& w : workers)
+            w.join();
+        auto const elapsed = clock_type::now() - start;
+
+        auto const calls = threads * keys.size() *
+            (peersPerThread + 1) + threads * keys.size() / 2;
+        BEAST_EXPECT(relayed == keys.size());
+        log << std::left << std::setw(10) << name << std::right <<
+            std::setw(4) << threads << " threads " <<
+            std::setw(10) << std::fixed << std::setprecision(1) <<
+            std::chrono::duration<double, std::milli>(elapsed).count() <<
+            "ms " << std::setw(12) << std::setprecision(0) <<
+            calls / std::chrono::duration<double>(elapsed).count() <<
+            " calls/s" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t threads = 8;
+        if (! arg().empty())
+            threads = std::stoul (arg());
+
+        testcase ("concurrent");
+
+        std::size_t const messages = 200000;
+        beast::xor_shift_engine rng;
+        std::vector<uint256> keys (messages);
+        for (auto& key : keys)
+            beast::rngfill (key.begin(), key.size(), rng);
+
+        for (std::size_t n = 1; n <= threads; n *= 2)
+        {
+            {
+                HashRouter router (stopwatch(),
+                    HashRouter::getDefaultHoldTime());
+                Serialized serialized (router);
+                measure ("serialized", serialized, keys, n);
+            }
+            {
+                HashRouter router (stopwatch(),
+                    HashRouter::getDefaultHoldTime());
+                measure ("sharded", router, keys, n);
+            }
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(HashRouterStress, app, ripple);
+
 }
 }
@@ -0,0 +1,366 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/TxFormats.h>
+#include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
+#include <test/parse_args.h>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace ripple {
+
+/*  Replays consecutive ledgers from a local node store through the
+    transaction engine and reports where the time goes.
+
+    Starting from a saved ledger, each of the following ledgers is
+    rebuilt from its parent by applying its transactions in their
+    original order, exactly as a ledger replay would. The result code
+    of every transaction and the state hash of every rebuilt ledger
+    are compared with the originals.
+
+    For each transaction type the report shows the number applied,
+    the time spent in apply and the number of ledger entries read
+    from the parent ledger, which is where a transaction's SHAMap and
+    node store work happens.
+
+    The start ledger may be a sequence number or hash in the ledger
+    database, or a file written by the ledger RPC command as used by
+    --ledgerfile. The following ledgers are always read from the
+    databases, so those should be copies of a server's databases.
+*/
+class LedgerReplay_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Forwards to a ledger, counting the state reads made through it
+    class CountingView : public ReadView
+    {
+    public:
+        explicit CountingView (ReadView const& base)
+            : base_ (base)
+        {
+        }
+
+        std::size_t
+        reads () const
+        {
+            return reads_;
+        }
+
+        LedgerInfo const&
+        info() const override
+        {
+            return base_.info();
+        }
+
+        bool
+        open() const override
+        {
+            return base_.open();
+        }
+
+        Fees const&
+        fees() const override
+        {
+            return base_.fees();
+        }
+
+        Rules const&
+        rules() const override
+        {
+            return base_.rules();
+        }
+
+        bool
+        exists (Keylet const& k) const override
+        {
+            ++reads_;
+            return base_.exists(k);
+        }
+
+        boost::optional<key_type>
+        succ (key_type const& key, boost::optional<
+            key_type> const& last = boost::none) const override
+        {
+            ++reads_;
+            return base_.succ(key, last);
+        }
+
+        std::shared_ptr<SLE const>
+        read (Keylet const& k) const override
+        {
+            ++reads_;
+            return base_.read(k);
+        }
+
+        std::unique_ptr<sles_type::iter_base>
+        slesBegin() const override
+        {
+            return base_.slesBegin();
+        }
+
+        std::unique_ptr<sles_type::iter_base>
+        slesEnd() const override
+        {
+            return base_.slesEnd();
+        }
+
+        std::unique_ptr<sles_type::iter_base>
+        slesUpperBound(key_type const& key) const override
+        {
+            return base_.slesUpperBound(key);
+        }
+
+        std::unique_ptr<txs_type::iter_base>
+        txsBegin() const override
+        {
+            return base_.txsBegin();
+        }
+
+        std::unique_ptr<txs_type::iter_base>
+        txsEnd() const override
+        {
+            return base_.txsEnd();
+        }
+
+        bool
+        txExists (key_type const& key) const override
+        {
+            return base_.txExists(key);
+        }
+
+        tx_type
+        txRead (key_type const& key) const override
+        {
+            return base_.txRead(key);
+        }
+
+    private:
+        ReadView const& base_;
+        std::size_t mutable reads_ = 0;
+    };
+
+    struct Stats
+    {
+        std::size_t count = 0;
+        clock_type::duration elapsed {};
+        std::size_t reads = 0;
+    };
+
+    static
+    double
+    ms (clock_type::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    // Rebuild `next` from `parent`, returns false if it differs
+    bool
+    replay (Application& app, std::shared_ptr<Ledger const> const& parent,
+        std::shared_ptr<Ledger const> const& next,
+            std::map<TxType, Stats>& stats)
+    {
+        auto const j = app.journal ("LedgerReplay");
+
+        std::map<std::uint32_t, std::shared_ptr<STTx const>> txns;
+        std::map<std::uint32_t, TER> results;
+        for (auto const& item : next->txMap())
+        {
+            auto const txPair = next->txRead (item.key());
+            auto const index = (*txPair.second)[sfTransactionIndex];
+            txns.emplace (index, txPair.first);
+            results.emplace (index, static_cast<TER>(
+                (*txPair.second)[sfTransactionResult]));
+        }
+
+        auto built = std::make_shared<Ledger> (
+            *parent, next->info().closeTime);
+        if (getSHAMapV2 (next->info()) && ! built->stateMap().is_v2())
+            built->make_v2();
+
+        {
+            CountingView counter (*built);
+            OpenView accum (&counter);
+            for (auto const& tx : txns)
+            {
+                auto& s = stats[tx.second->getTxnType()];
+                auto const reads = counter.reads();
+                auto const start = clock_type::now();
+                auto const result = apply (app, accum, *tx.second,
+                    tapNO_CHECK_SIGN, j);
+                s.elapsed += clock_type::now() - start;
+                s.reads += counter.reads() - reads;
+                ++s.count;
+
+                if (result.first != results[tx.first])
+                {
+                    log << "Ledger " << next->info().seq << " transaction " <<
+                        tx.second->getTransactionID() << ": " <<
+                        transToken (result.first) << " instead of " <<
+                        transToken (results[tx.first]) << std::endl;
+                }
+            }
+            accum.apply (*built);
+        }
+
+        built->updateSkipList ();
+        built->setAccepted (next->info().closeTime,
+            next->info().closeTimeResolution,
+                getCloseAgree (next->info()), app.config());
+
+        if (built->info().accountHash != next->info().accountHash ||
+            built->info().txHash != next->info().txHash)
+        {
+            log << "Ledger " << next->info().seq << " state " <<
+                built->info().accountHash << " expected " <<
+                next->info().accountHash << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void
+    report (std::map<TxType, Stats> const& stats,
+        clock_type::duration total, std::size_t ledgers)
+    {
+        std::stringstream ss;
+        ss << std::left << std::setw(24) << "Type" << std::right <<
+            std::setw(10) << "Count" <<
+            std::setw(12) << "Total ms" <<
+            std::setw(10) << "us/tx" <<
+            std::setw(12) << "Reads/tx" << "\n";
+
+        std::size_t count = 0;
+        clock_type::duration applying {};
+        for (auto const& s : stats)
+        {
+            auto const item = TxFormats::getInstance().findByType (s.first);
+            ss << std::left << std::setw(24) <<
+                (item ? item->getName() : std::to_string (s.first)) <<
+                std::right << std::fixed << std::setprecision(1) <<
+                std::setw(10) << s.second.count <<
+                std::setw(12) << ms (s.second.elapsed) <<
+                std::setw(10) << 1000 * ms (s.second.elapsed) /
+                    s.second.count <<
+                std::setw(12) << double (s.second.reads) /
+                    s.second.count << "\n";
+            count += s.second.count;
+            applying += s.second.elapsed;
+        }
+
+        ss << std::fixed << std::setprecision(1) <<
+            ledgers << " ledgers, " << count << " transactions in " <<
+            ms (total) << "ms, " << ms (applying) << "ms applying, " <<
+            count / std::chrono::duration<double>(total).count() <<
+            " tx/s";
+        log << ss.str() << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase(beast::unit_test::abort_on_fail) << arg();
+
+        auto const args = test::parse_args (arg());
+        if (args.find ("nodestore") == args.end () ||
+            args.find ("db") == args.end () ||
+            args.find ("ledger") == args.end ())
+        {
+            log <<
+                "Usage:\n" <<
+                "--unittest-arg=nodestore=<path>,db=<path>,ledger=<ledger>"
+                    "[,type=<type>][,count=<count>]\n" <<
+                "nodestore: Path of the node store\n" <<
+                "db:        Directory holding ledger.db\n" <<
+                "ledger:    Start ledger sequence, hash or ledger file\n" <<
+                "type:      Backend type of the node store, default nudb\n" <<
+                "count:     Number of ledgers to replay, default 100" <<
+                std::endl;
+            pass();
+            return;
+        }
+
+        auto const arg_or = [&args](std::string const& name,
+            std::string const& def)
+        {
+            auto const iter = args.find (name);
+            return iter == args.end () ? def : iter->second;
+        };
+
+        auto const count = std::stoul (arg_or ("count", "100"));
+        auto const ledger = args.at ("ledger");
+        auto const isFile = boost::filesystem::is_regular_file (ledger);
+
+        using namespace test::jtx;
+        Env env {*this, envconfig([&](std::unique_ptr<Config> cfg)
+            {
+                cfg->overwrite (ConfigSection::nodeDatabase (), "type",
+                    arg_or ("type", "nudb"));
+                cfg->overwrite (ConfigSection::nodeDatabase (), "path",
+                    args.at ("nodestore"));
+                cfg->legacy ("database_path", args.at ("db"));
+                cfg->START_LEDGER = ledger;
+                cfg->START_UP = isFile ? Config::LOAD_FILE : Config::LOAD;
+                return cfg;
+            })};
+        auto& app = env.app();
+
+        std::shared_ptr<Ledger const> parent =
+            app.getLedgerMaster().getClosedLedger();
+        log << "Replaying from ledger " << parent->info().seq << std::endl;
+
+        std::map<TxType, Stats> stats;
+        std::size_t replayed = 0;
+        clock_type::duration total {};
+        for (; replayed < count; ++replayed)
+        {
+            auto const next = loadByIndex (parent->info().seq + 1, app);
+            if (! next)
+            {
+                log << "Ledger " << parent->info().seq + 1 <<
+                    " is not in the database" << std::endl;
+                break;
+            }
+            if (! BEAST_EXPECT(next->info().parentHash == parent->info().hash))
+                break;
+
+            auto const start = clock_type::now();
+            BEAST_EXPECT(replay (app, parent, next, stats));
+            total += clock_type::now() - start;
+            parent = next;
+        }
+
+        report (stats, total, replayed);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(LedgerReplay,app,ripple);
+
+}
@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/jtx.h>
+#include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/ledger/OpenView.h>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class OpenLedger_test : public beast::unit_test::suite
+{
+    struct Result
+    {
+        std::map<uint256, Blob> state;
+        std::map<uint256, std::pair<Blob, Blob>> txs;
+        std::set<uint256> retries;
+    };
+
+    // Apply the transactions to a new open ledger the way the
+    // open ledger is rebuilt after a close or, when not open, to
+    // a closed view the way a ledger is built, with metadata.
+    Result
+    rebuild (jtx::Env& env, std::size_t threads, bool open,
+        std::vector<std::shared_ptr<STTx const>> const& txs)
+    {
+        env.app().config().PARALLEL_APPLY = threads;
+
+        auto const closed = env.closed();
+        auto view = open
+            ? OpenView (open_ledger, closed->rules(), closed)
+            : OpenView (&*closed, closed);
+        BEAST_EXPECT(view.open() == open);
+        OrderedTxs retries (uint256{});
+        OpenLedger::apply (env.app(), view, *closed, txs,
+            retries, tapNONE, env.journal);
+
+        Result result;
+        for (auto const& sle : view.sles)
+        {
+            Serializer s;
+            sle->add (s);
+            result.state.emplace (sle->key(), s.peekData());
+        }
+        for (auto const& tx : view.txs)
+        {
+            Serializer s;
+            tx.first->add (s);
+            Blob meta;
+            if (tx.second)
+            {
+                Serializer m;
+                tx.second->add (m);
+                meta = m.peekData();
+            }
+            result.txs.emplace (tx.first->getTransactionID(),
+                std::make_pair (s.peekData(), std::move (meta)));
+        }
+        for (auto const& tx : retries)
+            result.retries.insert (tx.second->getTransactionID());
+        return result;
+    }
+
+    void
+    testParallelApply()
+    {
+        testcase ("Parallel apply");
+        using namespace jtx;
+
+        Env env (*this);
+        auto const gw = Account ("gateway");
+        auto const USD = gw["USD"];
+        std::vector<Account> accounts;
+        for (int i = 0; i < 20; ++i)
+            accounts.emplace_back ("a" + std::to_string (i));
+
+        env.fund (XRP(100000), gw);
+        for (auto const& a : accounts)
+            env.fund (XRP(10000), a);
+        env.close();
+        for (auto const& a : accounts)
+            env.trust (USD(100000), a);
+        env.close();
+        for (auto const& a : accounts)
+            env (pay (gw, a, USD(1000)));
+        env.close();
+
+        std::vector<std::shared_ptr<STTx const>> txs;
+        std::map<Account, std::uint32_t> seqs;
+        auto const add = [&](Account const& from, auto&& tx)
+        {
+            auto const iter = seqs.emplace (from, env.seq (from)).first;
+            txs.push_back (env.jt (tx, seq (iter->second++)).stx);
+        };
+
+        // Independent payments and payments sharing a destination
+        for (std::size_t i = 0; i < accounts.size(); ++i)
+            add (accounts[i], pay (accounts[i],
+                accounts[(i + 1) % accounts.size()], XRP(10)));
+        for (std::size_t i = 0; i < accounts.size(); i += 2)
+            add (accounts[i], pay (accounts[i], accounts[1], USD(5)));
+
+        // Crossing offers
+        for (std::size_t i = 0; i < accounts.size(); ++i)
+        {
+            if (i % 2)
+                add (accounts[i], offer (accounts[i], XRP(100), USD(10)));
+            else
+                add (accounts[i], offer (accounts[i], USD(10), XRP(100)));
+        }
+
+        // Two payments creating the same account
+        auto const fresh = Account ("fresh");
+        add (accounts[3], pay (accounts[3], fresh, XRP(1000)));
+        add (accounts[4], pay (accounts[4], fresh, XRP(1000)));
+
+        // A sequence gap, to be retried
+        txs.push_back (env.jt (pay (accounts[5], accounts[6], XRP(1)),
+            seq (seqs[accounts[5]] + 1)).stx);
+
+        // Spending more than is left after the earlier transactions
+        add (accounts[7], pay (accounts[7], accounts[8], XRP(9950)));
+
+        for (bool open : {true, false})
+        {
+            auto const serial = rebuild (env, 0, open, txs);
+            BEAST_EXPECT(! serial.txs.empty());
+            BEAST_EXPECT(! serial.retries.empty());
+            for (auto const& tx : serial.txs)
+                BEAST_EXPECT(tx.second.second.empty() == open);
+
+            for (std::size_t threads : {2, 4, 16})
+            {
+                auto const parallel = rebuild (env, threads, open, txs);
+                BEAST_EXPECT(parallel.state == serial.state);
+                BEAST_EXPECT(parallel.txs == serial.txs);
+                BEAST_EXPECT(parallel.retries == serial.retries);
+            }
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testParallelApply();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OpenLedger,app,ripple);
+
+}
+}
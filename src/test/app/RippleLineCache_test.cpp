@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/jtx.h>
+#include <ripple/app/paths/RippleLineCache.h>
+
+namespace ripple {
+namespace test {
+
+class RippleLineCache_test : public beast::unit_test::suite
+{
+    // The lines read from the cache are the lines in its ledger
+    void
+    expectLines (RippleLineCache& cache, AccountID const& account)
+    {
+        auto const& cached = cache.getRippleLines (account);
+        auto const actual = getRippleStateItems (
+            account, *cache.getLedger());
+        if (! BEAST_EXPECT(cached.size() == actual.size()))
+            return;
+        for (std::size_t i = 0; i < cached.size(); ++i)
+        {
+            BEAST_EXPECT(cached[i]->key() == actual[i]->key());
+            BEAST_EXPECT(cached[i]->getBalance() ==
+                actual[i]->getBalance());
+            BEAST_EXPECT(cached[i]->getLimit() == actual[i]->getLimit());
+            BEAST_EXPECT(cached[i]->getLimitPeer() ==
+                actual[i]->getLimitPeer());
+        }
+    }
+
+    void
+    testNextLedger ()
+    {
+        testcase ("next ledger");
+        using namespace jtx;
+
+        Env env (*this);
+        auto const gw = Account ("gateway");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+        Account const alice ("alice");
+        Account const bob ("bob");
+        Account const carol ("carol");
+
+        env.fund (XRP (10000), alice, bob, carol, gw);
+        env.trust (USD (1000), alice, bob, carol);
+        env.trust (EUR (1000), alice);
+        env.close ();
+
+        auto first = std::make_shared<RippleLineCache> (env.closed ());
+        for (auto const& a : {alice, bob, carol})
+            expectLines (*first, a);
+        BEAST_EXPECT(first->size () == 3);
+
+        // Only bob's trust lines change
+        env (pay (gw, bob, USD (50)));
+        env.close ();
+
+        RippleLineCache second (env.closed (), *first);
+        BEAST_EXPECT(second.size () == 2);
+        BEAST_EXPECT(second.getRippleLines (alice)[0] ==
+            first->getRippleLines (alice)[0]);
+        for (auto const& a : {alice, bob, carol})
+            expectLines (second, a);
+        BEAST_EXPECT(second.size () == 3);
+
+        // A new trust line, and one removed
+        env.trust (EUR (1000), carol);
+        env.trust (EUR (0), alice);
+        env.close ();
+
+        RippleLineCache third (env.closed (), second);
+        BEAST_EXPECT(third.size () == 1);
+        for (auto const& a : {alice, bob, carol})
+            expectLines (third, a);
+        BEAST_EXPECT(third.getRippleLines (carol).size () == 2);
+
+        // The same ledger keeps every account
+        RippleLineCache same (env.closed (), third);
+        BEAST_EXPECT(same.size () == 3);
+
+        // Views which are not ledgers keep nothing
+        RippleLineCache open (env.current (), third);
+        BEAST_EXPECT(open.size () == 0);
+        expectLines (open, alice);
+    }
+
+public:
+    void
+    run () override
+    {
+        testNextLedger ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RippleLineCache,app,ripple);
+
+} // test
+} // ripple
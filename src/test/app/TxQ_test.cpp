@@ -23,6 +23,7 @@
 #include <ripple/app/tx/apply.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/mulDiv.h>
+#include <ripple/basics/random.h>
 #include <test/jtx/TestSuite.h>
 #include <test/jtx/envconfig.h>
 #include <ripple/protocol/ErrorCodes.h>
@@ -33,6 +34,10 @@
 #include <test/jtx/ticket.h>
 #include <boost/optional.hpp>
 #include <test/jtx/WSClient.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 namespace ripple {
 namespace test {
@@ -2799,5 +2804,137 @@ public:
 
 BEAST_DEFINE_TESTSUITE(TxQ,app,ripple);
 
+/*  Measures how fast transactions can be queued and drained, and
+    how many fee metric queries are answered meanwhile by another
+    thread, as the RPC "fee" command would.
+
+    The argument is the number of accounts, default 1000. Each one
+    queues `maximum_txn_per_account` transactions with random fees.
+*/
+class TxQBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t const perAccount = 10;
+
+    // Run f while another thread reads the fee metrics,
+    // returns the number of reads made.
+    template <class F>
+    std::size_t
+    withReader(jtx::Env& env, F&& f)
+    {
+        std::atomic<bool> done {false};
+        std::size_t reads = 0;
+        std::thread reader([&]
+            {
+                auto& app = env.app();
+                while (! done)
+                {
+                    app.getTxQ().getMetrics(*app.openLedger().current());
+                    ++reads;
+                }
+            });
+        f();
+        done = true;
+        reader.join();
+        return reads;
+    }
+
+    static
+    double
+    seconds(clock_type::duration d)
+    {
+        return std::chrono::duration<double>(d).count();
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+
+        std::size_t accounts = 1000;
+        if (! arg().empty())
+            accounts = std::stoul(arg());
+
+        testcase("throughput");
+
+        auto cfg = envconfig();
+        auto& section = cfg->section("transaction_queue");
+        section.set("minimum_txn_in_ledger_standalone", "5");
+        section.set("ledgers_in_queue", "1000000");
+        section.set("maximum_txn_per_account", std::to_string(perAccount));
+        Env env(*this, std::move(cfg), features(featureFeeEscalation));
+        auto& app = env.app();
+        auto& txq = app.getTxQ();
+
+        std::vector<Account> senders;
+        senders.reserve(accounts);
+        for (std::size_t i = 0; i < accounts; ++i)
+        {
+            senders.emplace_back("a" + std::to_string(i));
+            env.fund(XRP(1000), senders.back());
+            if (i % 100 == 99)
+                env.close();
+        }
+        env.close();
+
+        beast::xor_shift_engine rng;
+        std::vector<std::shared_ptr<STTx const>> txs;
+        txs.reserve(accounts * perAccount);
+        for (std::size_t n = 0; n < perAccount; ++n)
+        {
+            for (auto const& a : senders)
+            {
+                txs.push_back(env.jt(noop(a), seq(env.seq(a) + n),
+                    fee(10 + rand_int(rng, 100000))).stx);
+            }
+        }
+
+        std::size_t queued = 0;
+        clock_type::duration elapsed {};
+        auto reads = withReader(env, [&]
+            {
+                auto const start = clock_type::now();
+                for (auto const& tx : txs)
+                {
+                    app.openLedger().modify(
+                        [&](OpenView& view, beast::Journal j)
+                        {
+                            auto const result = txq.apply(
+                                app, view, tx, tapNONE, j);
+                            if (result.first == terQUEUED)
+                                ++queued;
+                            return result.second;
+                        });
+                }
+                elapsed = clock_type::now() - start;
+            });
+        BEAST_EXPECT(queued > 0);
+        log << txs.size() << " submitted, " << queued << " queued at " <<
+            txs.size() / seconds(elapsed) << " tx/s, " <<
+            reads / seconds(elapsed) << " metric reads/s" << std::endl;
+
+        auto const before = txq.getMetrics(*env.current())->txCount;
+        reads = withReader(env, [&]
+            {
+                auto const start = clock_type::now();
+                app.openLedger().modify(
+                    [&](OpenView& view, beast::Journal)
+                    {
+                        return txq.accept(app, view);
+                    });
+                elapsed = clock_type::now() - start;
+            });
+        auto const after = txq.getMetrics(*env.current())->txCount;
+        BEAST_EXPECT(after <= before);
+        log << before - after << " of " << before << " drained in " <<
+            1000 * seconds(elapsed) << "ms, " <<
+            reads / seconds(elapsed) << " metric reads/s" << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(TxQBench,app,ripple);
+
 }
 }
@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/main/DBInit.h>
+#include <ripple/app/misc/Validations.h>
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/SociDB.h>
+#include <ripple/protocol/SecretKey.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+namespace ripple {
+
+class ValidationsWriteSuite : public beast::unit_test::suite
+{
+protected:
+    // The validators of each ledger
+    static std::size_t constexpr validators = 10;
+
+    // The ledger sequence the validations are written at
+    static std::uint32_t constexpr currentSeq = 500;
+
+    // Validations for consecutive ledgers, every other one trusted
+    static
+    std::vector<STValidation::pointer>
+    makeValidations (std::size_t count)
+    {
+        std::vector<std::pair<PublicKey, SecretKey>> keys;
+        for (std::size_t i = 0; i < validators; ++i)
+            keys.push_back (randomKeyPair (KeyType::secp256k1));
+
+        std::vector<STValidation::pointer> result;
+        result.reserve (count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto const& key = keys[i % validators];
+            auto v = std::make_shared<STValidation> (
+                uint256 (i / validators + 1),
+                NetClock::time_point{NetClock::duration{1000 + i}},
+                key.first, true);
+            v->setFieldU32 (sfLedgerSequence, i / validators + 1);
+            v->sign (key.second);
+            if (i % 2 == 0)
+                v->setTrusted ();
+            result.push_back (std::move (v));
+        }
+        return result;
+    }
+
+    // A ledger database holding only the first ledger
+    static
+    std::unique_ptr<DatabaseCon>
+    makeDatabase (beast::temp_dir const& td)
+    {
+        DatabaseCon::Setup setup;
+        setup.dataDir = td.path();
+        auto con = std::make_unique<DatabaseCon> (
+            setup, "ledger.db", LedgerDBInit, LedgerDBCount);
+
+        auto const ledgerHash = to_string (uint256 (1));
+        auto db = con->checkoutDb ();
+        *db << "INSERT INTO Ledgers (LedgerHash, LedgerSeq) VALUES "
+            "(:ledgerHash, 1);", soci::use (ledgerHash);
+        return con;
+    }
+};
+
+class ValidationsWrite_test : public ValidationsWriteSuite
+{
+    void
+    testWrite (std::size_t count)
+    {
+        testcase ("write");
+
+        beast::temp_dir td;
+        auto const con = makeDatabase (td);
+        auto const validations = makeValidations (count);
+
+        // All validations, then only the trusted ones
+        auto const trusted = (count + 1) / 2;
+        BEAST_EXPECT(saveValidations (
+            *con, validations, currentSeq, true) == count);
+        BEAST_EXPECT(saveValidations (
+            *con, validations, currentSeq, false) == trusted);
+
+        auto db = con->checkoutDb ();
+        std::size_t total = 0;
+        *db << "SELECT COUNT(*) FROM Validations;", soci::into (total);
+        BEAST_EXPECT(total == count + trusted);
+
+        // The initial sequence of validations for ledgers which are not
+        // in the database is the current one
+        std::size_t const first = count < validators ? count : validators;
+        std::size_t known = 0;
+        *db << "SELECT COUNT(*) FROM Validations WHERE "
+            "LedgerSeq = 1 AND InitialSeq = 1;", soci::into (known);
+        BEAST_EXPECT(known == first + (first + 1) / 2);
+        std::size_t unknown = 0;
+        std::uint32_t const seq = currentSeq;
+        *db << "SELECT COUNT(*) FROM Validations WHERE "
+            "LedgerSeq IS NULL AND InitialSeq = :seq;",
+            soci::use (seq), soci::into (unknown);
+        BEAST_EXPECT(known + unknown == total);
+
+        // The stored validations are the original ones
+        std::size_t const limit = std::min<std::size_t> (count, 10);
+        std::string ledgerHash;
+        std::string nodePubKey;
+        soci::blob rawData (*db);
+        soci::statement st = (db->prepare <<
+            "SELECT LedgerHash, NodePubKey, RawData FROM Validations "
+            "ORDER BY rowid LIMIT :limit;", soci::use (limit),
+            soci::into (ledgerHash), soci::into (nodePubKey),
+            soci::into (rawData));
+        st.execute ();
+        std::size_t i = 0;
+        while (st.fetch ())
+        {
+            Blob data;
+            convert (rawData, data);
+            SerialIter sit (makeSlice (data));
+            STValidation const v (sit);
+            BEAST_EXPECT(v.getLedgerHash() ==
+                validations[i]->getLedgerHash());
+            BEAST_EXPECT(v.getSignerPublic() ==
+                validations[i]->getSignerPublic());
+            BEAST_EXPECT(ledgerHash ==
+                to_string (validations[i]->getLedgerHash()));
+            BEAST_EXPECT(nodePubKey == toBase58 (TokenType::TOKEN_NODE_PUBLIC,
+                validations[i]->getSignerPublic()));
+            ++i;
+        }
+        BEAST_EXPECT(i == limit);
+    }
+
+public:
+    void
+    run() override
+    {
+        testWrite (7);
+        testWrite (100);
+    }
+};
+
+/*  Writes stale validations to a ledger database.
+
+    The argument is the number of validations to write, default 1000,
+    and the time taken is reported.
+*/
+class ValidationsWriteBench_test : public ValidationsWriteSuite
+{
+    using clock_type = std::chrono::steady_clock;
+
+public:
+    void
+    run() override
+    {
+        std::size_t count = 1000;
+        if (! arg().empty())
+            count = std::stoul (arg());
+
+        testcase ("write");
+
+        beast::temp_dir td;
+        auto const con = makeDatabase (td);
+        auto const validations = makeValidations (count);
+
+        auto const start = clock_type::now();
+        auto const rows = saveValidations (
+            *con, validations, currentSeq, true);
+        auto const elapsed = std::chrono::duration<double>(
+            clock_type::now() - start).count();
+        BEAST_EXPECT(rows == count);
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) <<
+            rows << " validations written in " << elapsed * 1000 <<
+            "ms, " << rows / elapsed << " rows/s";
+        log << ss.str() << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ValidationsWrite,app,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(ValidationsWriteBench,app,ripple);
+
+}
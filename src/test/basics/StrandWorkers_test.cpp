@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github0.com/ripple/rippled
+    Copyright (c) 2012-2016 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/basics/StrandWorkers.h>
+#include <ripple/beast/unit_test.h>
+#include <atomic>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class StrandWorkers_test : public beast::unit_test::suite
+{
+    void
+    testRun ()
+    {
+        testcase ("run");
+
+        StrandWorkers workers (4);
+        std::vector<std::atomic<int>> calls (1000);
+        for (auto& c : calls)
+            c = 0;
+        workers.run (calls.size (), [&](std::size_t i) { ++calls[i]; });
+
+        bool once = true;
+        for (auto const& c : calls)
+            if (c != 1)
+                once = false;
+        BEAST_EXPECT(once);
+
+        // Asking again from a call runs on that call's thread
+        std::atomic<int> inner {0};
+        workers.run (4, [&](std::size_t)
+        {
+            workers.run (4, [&](std::size_t) { ++inner; });
+        });
+        BEAST_EXPECT(inner == 16);
+    }
+
+    void
+    testThrow ()
+    {
+        testcase ("throw");
+
+        StrandWorkers workers (4);
+
+        // Whatever a call throws reaches the caller
+        bool caught = false;
+        try
+        {
+            workers.run (1000, [](std::size_t i)
+            {
+                if (i == 500)
+                    throw 42;
+            });
+        }
+        catch (int e)
+        {
+            caught = e == 42;
+        }
+        BEAST_EXPECT(caught);
+
+        // The workers are still usable
+        std::atomic<int> count {0};
+        workers.run (100, [&](std::size_t) { ++count; });
+        BEAST_EXPECT(count == 100);
+    }
+
+public:
+    void
+    run () override
+    {
+        testRun ();
+        testThrow ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(StrandWorkers,basics,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,281 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+#include <BeastConfig.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/consensus/Consensus.h>
+#include <ripple/consensus/ConsensusProposal.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+#include <test/csf.h>
+#include <test/parse_args.h>
+#include <utility>
+
+namespace ripple {
+namespace test {
+
+/*  Runs the consensus simulation with many validators and reports how
+    the consensus code scales.
+
+    Peers are connected with links whose one-way delay is drawn from a
+    latency distribution, and transactions are submitted to random
+    peers at a fixed rate of simulated time. After each round the
+    simulation checks that all peers closed the same ledger.
+
+    The report shows the rounds closed per second of simulated time,
+    the wall clock time spent simulating each round, the messages of
+    each kind sent per round and the time the peers took to converge,
+    which is the establish phase as seen by Consensus::prevRoundTime.
+*/
+class ConsensusScale_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // One-way link delays drawn from a distribution
+    class Latency
+    {
+        std::string type_;
+        double delay_;
+        double jitter_;
+        std::mt19937_64& rng_;
+
+    public:
+        Latency (std::string type, double delay, double jitter,
+                std::mt19937_64& rng)
+            : type_ (std::move (type))
+            , delay_ (delay)
+            , jitter_ (jitter)
+            , rng_ (rng)
+        {
+        }
+
+        bool
+        valid () const
+        {
+            return type_ == "fixed" || type_ == "uniform" ||
+                type_ == "normal" || type_ == "exponential";
+        }
+
+        std::chrono::nanoseconds
+        operator()(csf::PeerID, csf::PeerID) const
+        {
+            double ms = delay_;
+            if (type_ == "uniform")
+                ms = std::uniform_real_distribution<>{
+                    delay_ - jitter_, delay_ + jitter_}(rng_);
+            else if (type_ == "normal")
+                ms = std::normal_distribution<>{delay_, jitter_}(rng_);
+            else if (type_ == "exponential")
+                ms = std::exponential_distribution<>{1 / delay_}(rng_);
+
+            using namespace std::chrono;
+            return duration_cast<nanoseconds>(
+                duration<double, std::milli>(std::max (ms, 1.0)));
+        }
+    };
+
+    static
+    std::size_t
+    total (csf::Peer::MessageCounts const& c)
+    {
+        return c.proposals + c.txSets + c.txs + c.validations;
+    }
+
+    static
+    csf::Peer::MessageCounts
+    sent (csf::Sim const& sim)
+    {
+        csf::Peer::MessageCounts result;
+        for (auto const& p : sim.peers)
+        {
+            result.proposals += p.sent.proposals;
+            result.txSets += p.sent.txSets;
+            result.txs += p.sent.txs;
+            result.validations += p.sent.validations;
+        }
+        return result;
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace csf;
+        using namespace std::chrono;
+
+        if (arg() == "help")
+        {
+            log <<
+                "Usage:\n" <<
+                "--unittest-arg=[peers=<peers>][,unl=<size>][,rounds=<rounds>]"
+                    "[,latency=<type>][,delay=<ms>][,jitter=<ms>]"
+                    "[,txrate=<rate>][,relay=<0|1>][,seed=<seed>]\n" <<
+                "peers:   Number of validators, default 100\n" <<
+                "unl:     Validators in each UNL, default all of them\n" <<
+                "rounds:  Number of consensus rounds, default 10\n" <<
+                "latency: fixed, uniform, normal or exponential link "
+                    "delays, default fixed\n" <<
+                "delay:   Mean link delay in milliseconds, default 200\n" <<
+                "jitter:  Spread of uniform or standard deviation of normal "
+                    "delays, default 50\n" <<
+                "txrate:  Transactions submitted per second, default 10\n" <<
+                "relay:   Whether submitted transactions are relayed, if not "
+                    "they are disputed, default 1\n" <<
+                "seed:    Random seed, default 0" << std::endl;
+            pass();
+            return;
+        }
+
+        auto const args = parse_args (arg());
+        auto const arg_or = [&args](std::string const& name,
+            std::string const& def)
+        {
+            auto const iter = args.find (name);
+            return iter == args.end () ? def : iter->second;
+        };
+
+        auto const numPeers = std::stoi (arg_or ("peers", "100"));
+        auto const unlSize = std::stoi (arg_or ("unl",
+            std::to_string (numPeers)));
+        auto const rounds = std::stoi (arg_or ("rounds", "10"));
+        auto const txRate = std::stod (arg_or ("txrate", "10"));
+        auto const relay = arg_or ("relay", "1") != "0";
+
+        testcase (std::to_string (numPeers) + " peers");
+
+        std::mt19937_64 rng (std::stoull (arg_or ("seed", "0")));
+        Latency const latency (arg_or ("latency", "fixed"),
+            std::stod (arg_or ("delay", "200")),
+                std::stod (arg_or ("jitter", "50")), rng);
+        if (! latency.valid ())
+        {
+            fail ("unknown latency distribution");
+            return;
+        }
+
+        // Peers outside each other's UNL are not connected, so
+        // transactions only reach them through common neighbours
+        auto const tg = unlSize >= numPeers
+            ? TrustGraph::makeComplete (numPeers)
+            : TrustGraph::makeRandomRanked (numPeers, numPeers / 10 + 1,
+                PowerLawDistribution{1, 3},
+                std::uniform_int_distribution<>{unlSize, unlSize}, rng);
+
+        auto start = clock_type::now();
+        Sim sim (tg, topology (tg, latency));
+        log << "Connected " << numPeers << " peers in " <<
+            duration_cast<milliseconds>(clock_type::now() - start).count() <<
+            "ms" << std::endl;
+
+        // Submit transactions to random peers until all peers finish
+        // the round
+        std::uint32_t nextTx = 0;
+        auto const interval = duration_cast<nanoseconds>(
+            duration<double>(1 / std::max (txRate, 1e-3)));
+        std::uniform_int_distribution<std::size_t> pick (
+            0, sim.peers.size() - 1);
+        std::function<void()> submit = [&]()
+        {
+            if (std::all_of (sim.peers.begin(), sim.peers.end(),
+                    [](Peer const& p)
+                    {
+                        return p.completedLedgers >= p.targetLedgers;
+                    }))
+                return;
+            auto& p = sim.peers[pick (rng)];
+            if (relay)
+                p.submit (Tx{nextTx++});
+            else
+                p.openTxs.insert (Tx{nextTx++});
+            sim.net.timer (interval, submit);
+        };
+
+        // Initial round to set prior state
+        sim.run (1);
+
+        auto const simStart = sim.net.now();
+        auto const sentStart = sent (sim);
+        milliseconds converge {};
+        milliseconds slowest {};
+        std::size_t forks = 0;
+
+        start = clock_type::now();
+        for (int round = 0; round < rounds; ++round)
+        {
+            if (txRate > 0)
+                sim.net.timer (interval, submit);
+            sim.run (1);
+
+            bc::flat_set<Ledger::ID> ledgers;
+            for (auto const& p : sim.peers)
+            {
+                ledgers.insert (p.prevLedgerID());
+                converge += p.prevRoundTime();
+                slowest = std::max (slowest, p.prevRoundTime());
+            }
+            if (ledgers.size() != 1)
+                ++forks;
+        }
+        auto const elapsed = clock_type::now() - start;
+        auto const simulated = sim.net.now() - simStart;
+
+        auto const end = sent (sim);
+        auto const perRound = [&](std::size_t after, std::size_t before)
+        {
+            return double (after - before) / rounds;
+        };
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) <<
+            rounds << " rounds, " << nextTx << " transactions, " <<
+            duration<double>(simulated).count() << "s simulated in " <<
+            duration<double, std::milli>(elapsed).count() << "ms\n" <<
+            "Rounds per simulated second: " << std::setprecision(3) <<
+            rounds / duration<double>(simulated).count() << "\n" <<
+            std::setprecision(1) <<
+            "Wall clock per round:        " <<
+            duration<double, std::milli>(elapsed).count() / rounds << "ms\n" <<
+            "Mean convergence time:       " <<
+            double (converge.count()) / (rounds * sim.peers.size()) <<
+            "ms (slowest " << slowest.count() << "ms)\n" <<
+            "Messages per round:          " <<
+            perRound (total (end), total (sentStart)) << "\n" <<
+            "    proposals                " <<
+            perRound (end.proposals, sentStart.proposals) << "\n" <<
+            "    transaction sets         " <<
+            perRound (end.txSets, sentStart.txSets) << "\n" <<
+            "    transactions             " <<
+            perRound (end.txs, sentStart.txs) << "\n" <<
+            "    validations              " <<
+            perRound (end.validations, sentStart.validations) << "\n" <<
+            "Rounds without agreement:    " << forks;
+        log << ss.str() << std::endl;
+
+        BEAST_EXPECT(forks == 0 || unlSize < numPeers);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(ConsensusScale, consensus, ripple);
+
+}  // test
+}  // ripple
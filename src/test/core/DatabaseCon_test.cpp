@@ -0,0 +1,254 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <test/jtx.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class DatabaseCon_test : public beast::unit_test::suite
+{
+    static
+    std::unique_ptr<DatabaseCon>
+    makeDatabase (boost::filesystem::path const& dir)
+    {
+        static char const* init[] = {
+            "PRAGMA journal_mode=WAL;",
+            "PRAGMA synchronous=OFF;",
+            "PRAGMA cache_size=-1234;",
+            "CREATE TABLE IF NOT EXISTS Items (Value INTEGER);",
+            "INSERT INTO Items VALUES (1);",
+            "INSERT INTO Items VALUES (2);",
+            "INSERT INTO Items VALUES (3);",
+        };
+
+        DatabaseCon::Setup setup;
+        setup.dataDir = dir;
+        return std::make_unique<DatabaseCon> (
+            setup, "items.db", init, std::extent<decltype(init)>::value);
+    }
+
+    // Run f in a coroutine and wait for it to return
+    template <class F>
+    bool
+    inCoro (jtx::Env& env, F&& f)
+    {
+        std::mutex m;
+        std::condition_variable cv;
+        bool done = false;
+        env.app().getJobQueue().postCoro (jtCLIENT, "DatabaseCon-Test",
+            [&](std::shared_ptr<JobQueue::Coro> const& coro)
+            {
+                f (coro);
+                std::lock_guard<std::mutex> lock (m);
+                done = true;
+                cv.notify_all ();
+            });
+        std::unique_lock<std::mutex> lock (m);
+        return cv.wait_for (lock, std::chrono::seconds (5),
+            [&]{ return done; });
+    }
+
+    void
+    testRead ()
+    {
+        testcase ("read");
+        using namespace jtx;
+
+        Env env (*this);
+        beast::temp_dir td;
+        auto db = makeDatabase (td.path());
+        db->setupReaders (2, env.app().logs());
+
+        int count = 0;
+        bool reader = false;
+        bool checkedOut = false;
+        bool rethrown = false;
+        BEAST_EXPECT(inCoro (env,
+            [&](std::shared_ptr<JobQueue::Coro> const& coro)
+            {
+                db->read ("count", coro, [&](soci::session& session)
+                {
+                    session << "SELECT COUNT(*) FROM Items;",
+                        soci::into (count);
+                    reader = &session != &db->getSession();
+                    checkedOut = db->checkoutDb().get() == &session &&
+                        db->checkoutRead().get() == &session;
+                });
+
+                // Readers do not write
+                try
+                {
+                    db->read ("insert", coro, [&](soci::session& session)
+                    {
+                        session << "INSERT INTO Items VALUES (4);";
+                    });
+                }
+                catch (soci::soci_error const&)
+                {
+                    rethrown = true;
+                }
+            }));
+        BEAST_EXPECT(count == 3);
+        BEAST_EXPECT(reader);
+        BEAST_EXPECT(checkedOut);
+        BEAST_EXPECT(rethrown);
+
+        // Without a coroutine the query runs here, still reading
+        BEAST_EXPECT(db->checkoutDb().get() == &db->getSession());
+        db->read ("count", nullptr, [&](soci::session& session)
+        {
+            BEAST_EXPECT(&session != &db->getSession());
+            session << "SELECT COUNT(*) FROM Items;", soci::into (count);
+        });
+        BEAST_EXPECT(count == 3);
+
+        auto const jv = db->getReadJson();
+        BEAST_EXPECT(jv.size() == 2);
+        BEAST_EXPECT(jv["count"].size() == 12);
+        BEAST_EXPECT(jv["insert"].size() == 12);
+        std::uint64_t total = 0;
+        for (auto const& bucket : jv["count"])
+            total += bucket.asUInt();
+        BEAST_EXPECT(total == 2);
+    }
+
+    void
+    testCheckout ()
+    {
+        testcase ("checkout");
+        using namespace jtx;
+
+        Env env (*this);
+        beast::temp_dir td;
+        auto db = makeDatabase (td.path());
+        db->setupReaders (2, env.app().logs());
+
+        // Reads use free sessions of the pool
+        {
+            auto first = db->checkoutRead();
+            auto second = db->checkoutRead();
+            BEAST_EXPECT(first.get() != &db->getSession());
+            BEAST_EXPECT(second.get() != &db->getSession());
+            BEAST_EXPECT(first.get() != second.get());
+
+            int count = 0;
+            *second << "SELECT COUNT(*) FROM Items;", soci::into (count);
+            BEAST_EXPECT(count == 3);
+
+            // Writes are seen by later reads
+            *db->checkoutDb() << "INSERT INTO Items VALUES (4);";
+            *first << "SELECT COUNT(*) FROM Items;", soci::into (count);
+            BEAST_EXPECT(count == 4);
+        }
+
+        // A checkout of the busy writing session waits
+        {
+            std::thread t;
+            {
+                auto held = db->checkoutDb();
+                t = std::thread ([&]
+                {
+                    auto db2 = db->checkoutDb();
+                });
+                while (db->getCheckoutJson()["write"]["checkouts"] != 3)
+                    std::this_thread::yield();
+                std::this_thread::sleep_for (std::chrono::milliseconds (10));
+            }
+            t.join();
+        }
+
+        auto const jv = db->getCheckoutJson();
+        BEAST_EXPECT(jv["write"]["checkouts"].asUInt() == 3);
+        BEAST_EXPECT(jv["write"]["waits"].asUInt() == 1);
+        BEAST_EXPECT(jv["write"]["wait_us"].asUInt() > 0);
+        BEAST_EXPECT(jv["read"]["checkouts"].asUInt() == 2);
+        BEAST_EXPECT(jv["read"]["waits"].asUInt() == 0);
+    }
+
+    void
+    testPragmas ()
+    {
+        testcase ("pragmas");
+        using namespace jtx;
+
+        Env env (*this);
+        beast::temp_dir td;
+        auto db = makeDatabase (td.path());
+        db->setupReaders (1, env.app().logs());
+
+        // Readers take the connection settings, but not those for writing
+        auto session = db->checkoutRead();
+        BEAST_EXPECT(session.get() != &db->getSession());
+        int cacheSize = 0;
+        int synchronous = 0;
+        *session << "PRAGMA cache_size;", soci::into (cacheSize);
+        *session << "PRAGMA synchronous;", soci::into (synchronous);
+        BEAST_EXPECT(cacheSize == -1234);
+        BEAST_EXPECT(synchronous != 0);
+    }
+
+    void
+    testNoReaders ()
+    {
+        testcase ("no readers");
+        using namespace jtx;
+
+        Env env (*this);
+        beast::temp_dir td;
+        auto db = makeDatabase (td.path());
+        db->setupReaders (0, env.app().logs());
+
+        int count = 0;
+        BEAST_EXPECT(inCoro (env,
+            [&](std::shared_ptr<JobQueue::Coro> const& coro)
+            {
+                db->read ("count", coro, [&](soci::session& session)
+                {
+                    BEAST_EXPECT(&session == &db->getSession());
+                    session << "SELECT COUNT(*) FROM Items;",
+                        soci::into (count);
+                });
+            }));
+        BEAST_EXPECT(count == 3);
+    }
+
+public:
+    void
+    run() override
+    {
+        testRead ();
+        testCheckout ();
+        testPragmas ();
+        testNoReaders ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(DatabaseCon,core,ripple);
+
+}  // test
+}  // ripple
@@ -172,6 +172,16 @@ struct Peer : public Consensus<Peer, Traits>
     bool validating_ = true;
     bool proposing_ = true;
 
+    //! Number of messages of each kind this peer has sent
+    struct MessageCounts
+    {
+        std::size_t proposals = 0;
+        std::size_t txSets = 0;
+        std::size_t txs = 0;
+        std::size_t validations = 0;
+    };
+    MessageCounts sent;
+
     //! All peers start from the default constructed ledger
     Peer(PeerID i, BasicNetwork<Peer*>& n, UNL const& u)
         : Consensus<Peer, Traits>(n.clock(), beast::Journal{})
@@ -372,13 +382,41 @@ struct Peer : public Consensus<Peer, Traits>
         }
     }
 
+    std::size_t&
+    counter(Proposal const&)
+    {
+        return sent.proposals;
+    }
+
+    std::size_t&
+    counter(TxSet const&)
+    {
+        return sent.txSets;
+    }
+
+    std::size_t&
+    counter(Tx const&)
+    {
+        return sent.txs;
+    }
+
+    std::size_t&
+    counter(Validation const&)
+    {
+        return sent.validations;
+    }
+
     template <class T>
     void
     relay(T const& t)
     {
+        auto& count = counter(t);
         for (auto const& link : net.links(this))
+        {
+            ++count;
             net.send(
                 this, link.to, [ msg = t, to = link.to ] { to->receive(msg); });
+        }
     }
 
     // Receive and relay locally submitted transaction
@@ -0,0 +1,178 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/beast/unit_test.h>
+#include <boost/asio/buffer.hpp>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/*  Measures Json::Reader throughput over request payloads.
+
+    With no argument a built in set of typical JSON-RPC and websocket
+    requests is used. Otherwise the argument names a file of captured
+    requests, one per line.
+*/
+class json_reader_timing_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static
+    std::vector<std::string>
+    builtin ()
+    {
+        std::string const account = "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+        std::string const issuer = "rvYAfWj5gh67oV6fW32ZzP3Aw4Eubs59B";
+        std::string blob;
+        for (int i = 0; i < 6; ++i)
+            blob += "1200002280000000240000000161D4838D7EA4C6800000000000"
+                "00000000000000000055534400000000004B4E9C06F24296074F7B";
+
+        std::vector<std::string> result;
+        result.push_back (
+            "{\"method\":\"submit\",\"params\":[{\"tx_blob\":\"" +
+            blob + "\"}]}");
+        result.push_back (
+            "{\"id\":2,\"command\":\"account_tx\",\"account\":\"" + account +
+            "\",\"ledger_index_min\":-1,\"ledger_index_max\":-1,"
+            "\"binary\":false,\"limit\":200,\"forward\":false,"
+            "\"marker\":{\"ledger\":32570123,\"seq\":17}}");
+        result.push_back (
+            "{\"method\":\"book_offers\",\"params\":[{\"taker\":\"" +
+            account + "\",\"taker_gets\":{\"currency\":\"XRP\"},"
+            "\"taker_pays\":{\"currency\":\"USD\",\"issuer\":\"" +
+            issuer + "\"},\"limit\":10,\"ledger_index\":\"validated\"}]}");
+        result.push_back (
+            "{\n  \"id\": 4,\n  \"command\": \"subscribe\",\n"
+            "  \"streams\": [ \"ledger\", \"transactions\", "
+            "\"validations\" ],\n  \"accounts\": [ \"" + account +
+            "\", \"" + issuer + "\" ],\n  \"books\": [ {\n"
+            "    \"taker_pays\": { \"currency\": \"XRP\" },\n"
+            "    \"taker_gets\": { \"currency\": \"USD\", \"issuer\": \"" +
+            issuer + "\" },\n    \"snapshot\": true\n  } ]\n}");
+        result.push_back (
+            "{\"method\":\"ripple_path_find\",\"params\":[{"
+            "\"source_account\":\"" + account + "\","
+            "\"destination_account\":\"" + issuer + "\","
+            "\"destination_amount\":{\"currency\":\"USD\",\"issuer\":\"" +
+            issuer + "\",\"value\":\"0.001\"},"
+            "\"source_currencies\":[{\"currency\":\"XRP\"},"
+            "{\"currency\":\"USD\"}],\"memo\":\"caf\\u00e9 \\\"quoted\\\"\"}]}");
+        result.push_back (
+            "{\"method\":\"ledger\",\"params\":[{\"ledger_index\":32570123,"
+            "\"transactions\":true,\"expand\":true,\"owner_funds\":true,"
+            "\"fee_mult_max\":1000.5}]}");
+        return result;
+    }
+
+    static
+    std::vector<std::string>
+    load (std::string const& path)
+    {
+        std::vector<std::string> result;
+        std::ifstream in (path);
+        std::string line;
+        while (std::getline (in, line))
+            if (! line.empty ())
+                result.push_back (std::move (line));
+        return result;
+    }
+
+    template <class Parse>
+    void
+    measure (std::string const& name,
+        std::vector<std::string> const& requests, Parse&& parse)
+    {
+        std::size_t bytes = 0;
+        for (auto const& request : requests)
+            bytes += request.size ();
+
+        // Aim for a few hundred megabytes
+        auto const rounds = std::max<std::size_t> (
+            1, (256 << 20) / std::max<std::size_t> (bytes, 1));
+
+        std::size_t failed = 0;
+        auto const start = clock_type::now ();
+        for (std::size_t i = 0; i < rounds; ++i)
+            for (auto const& request : requests)
+                if (! parse (request))
+                    ++failed;
+        auto const elapsed = std::chrono::duration<double> (
+            clock_type::now () - start).count ();
+        BEAST_EXPECT(failed == 0);
+
+        std::stringstream ss;
+        ss << std::left << std::setw(10) << name << std::right <<
+            std::fixed << std::setprecision(1) <<
+            std::setw(8) << (bytes * rounds / elapsed / (1 << 20)) <<
+            " MB/s " << std::setw(10) <<
+            (requests.size () * rounds / elapsed) << " requests/s";
+        log << ss.str () << std::endl;
+    }
+
+public:
+    void
+    run () override
+    {
+        auto const requests = arg ().empty () ? builtin () : load (arg ());
+        testcase ("parse");
+        if (requests.empty ())
+        {
+            fail ("no requests");
+            return;
+        }
+
+        std::size_t bytes = 0;
+        for (auto const& request : requests)
+            bytes += request.size ();
+        log << requests.size () << " requests, " <<
+            bytes << " bytes" << std::endl;
+
+        measure ("string", requests,
+            [](std::string const& request)
+            {
+                Json::Value v;
+                return Json::Reader{}.parse (request, v);
+            });
+
+        // Websocket messages arrive as buffer sequences
+        measure ("buffers", requests,
+            [](std::string const& request)
+            {
+                auto const half = request.size () / 2;
+                std::vector<boost::asio::const_buffer> buffers {
+                    boost::asio::const_buffer (request.data (), half),
+                    boost::asio::const_buffer (request.data () + half,
+                        request.size () - half) };
+                Json::Value v;
+                return Json::Reader{}.parse (v, buffers);
+            });
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(json_reader_timing,json,ripple);
+
+}
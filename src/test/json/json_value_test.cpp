@@ -222,6 +222,158 @@ struct json_value_test : beast::unit_test::suite
         testGreaterThan ("big");
     }
 
+    void test_reader ()
+    {
+        auto parse = [](std::string const& s, Json::Value& v)
+        {
+            Json::Reader r;
+            return r.parse (s, v);
+        };
+
+        // Escapes on either side of the 16 byte blocks scanned at once
+        for (std::size_t n = 0; n < 40; ++n)
+        {
+            std::string const pad (n, 'x');
+            Json::Value v;
+            BEAST_EXPECT(parse ("{\"" + pad + "\":\"" + pad +
+                "\\\"\\\\\\/\\b\\f\\n\\r\\t" + pad + "\"}", v));
+            BEAST_EXPECT(v[pad].asString () ==
+                pad + "\"\\/\b\f\n\r\t" + pad);
+        }
+
+        {
+            Json::Value v;
+            BEAST_EXPECT(parse (
+                "{\"a\":\"caf\\u00e9\",\"b\":\"\\ud83d\\ude00\","
+                "\"c\":-1.5e2,\"d\":[],\"e\":{},\"f\":[1,\"\",null]}", v));
+            BEAST_EXPECT(v["a"].asString () == "caf\xc3\xa9");
+            BEAST_EXPECT(v["b"].asString () == "\xf0\x9f\x98\x80");
+            BEAST_EXPECT(v["c"].asDouble () == -150);
+            BEAST_EXPECT(v["d"].isArray () && v["d"].size () == 0);
+            BEAST_EXPECT(v["e"].isObject () && v["e"].size () == 0);
+            BEAST_EXPECT(v["f"].size () == 3 && v["f"][1u].asString ().empty ());
+        }
+
+        auto error = [](std::string const& s)
+        {
+            Json::Value v;
+            Json::Reader r;
+            if (r.parse (s, v))
+                return std::string ();
+            return r.getFormatedErrorMessages ();
+        };
+
+        BEAST_EXPECT(error ("{\"a\":1,\n\"a\":2}") ==
+            "* Line 2, Column 1\n  Key 'a' appears twice.\n");
+        BEAST_EXPECT(error ("{\"a\":\"\\q\"}") ==
+            "* Line 1, Column 6\n  Bad escape sequence in string\n"
+            "See Line 1, Column 9 for detail.\n");
+        BEAST_EXPECT(error ("{\"a\":\"abc") ==
+            "* Line 1, Column 6\n"
+            "  Syntax error: value, object or array expected.\n");
+        BEAST_EXPECT(error ("{\"a\":1.e}") == "");
+        BEAST_EXPECT(error ("{\"a\":-}") ==
+            "* Line 1, Column 6\n  '-' is not a valid number.\n");
+        BEAST_EXPECT(error ("[1 2]") ==
+            "* Line 1, Column 4\n  Missing ',' or ']' in array declaration\n");
+
+        // Buffer sequences are parsed as if they were contiguous
+        {
+            std::string const s = "{\"method\":\"ping\",\"params\":[{}]}";
+            std::vector<boost::asio::const_buffer> buffers;
+            for (std::size_t i = 0; i < s.size (); i += 5)
+                buffers.emplace_back (s.data () + i,
+                    std::min<std::size_t> (5, s.size () - i));
+            Json::Value v;
+            BEAST_EXPECT(Json::Reader{}.parse (v, buffers));
+            BEAST_EXPECT(v["method"] == "ping");
+            BEAST_EXPECT(v["params"][0u].isObject ());
+        }
+    }
+
+    void test_arena ()
+    {
+        auto build = [](int n)
+        {
+            Json::Value result (Json::objectValue);
+            auto& txs = result["transactions"] = Json::arrayValue;
+            for (int i = 0; i < n; ++i)
+            {
+                Json::Value tx (Json::objectValue);
+                tx["index"] = i;
+                tx["hash"] = std::to_string (i);
+                tx["meta"]["affected"] = Json::arrayValue;
+                txs.append (tx);
+            }
+            return result;
+        };
+
+        auto const expected = build (100);
+
+        Json::Value inside;
+        Json::Value copy;
+        {
+            Json::ScopedArena arena;
+            inside = build (100);
+            {
+                // A nested scope has an arena of its own
+                Json::ScopedArena nested;
+                copy = inside;
+            }
+            BEAST_EXPECT(copy == expected);
+            inside["transactions"].resize (50);
+            inside["transactions"][49u].removeMember ("meta");
+        }
+
+        // The tree outlives the scope and can still be changed
+        BEAST_EXPECT(inside["transactions"].size () == 50);
+        BEAST_EXPECT(! inside["transactions"][49u].isMember ("meta"));
+        inside["transactions"].resize (100);
+        inside["transactions"][49u]["meta"]["affected"] = Json::arrayValue;
+        for (Json::UInt i = 50; i < 100; ++i)
+            inside["transactions"][i] = expected["transactions"][i];
+        BEAST_EXPECT(inside == expected);
+
+        // Copies made outside any scope use the heap
+        Json::Value outside = inside;
+        inside.clear ();
+        copy.clear ();
+        BEAST_EXPECT(outside == expected);
+    }
+
+    void test_interning ()
+    {
+        static Json::StaticString const name ("json_value_test_interned");
+        Json::Value object;
+        object[name] = 1;
+
+        Json::Value parsed;
+        Json::Reader r;
+        BEAST_EXPECT(r.parse (
+            "{\"json_value_test_interned\":2,\"json_value_test_other\":3}",
+            parsed));
+
+        // The parsed name shares the static name's storage
+        auto const keys = [&](Json::Value const& v)
+        {
+            std::vector<char const*> result;
+            for (auto it = v.begin (); it != v.end (); ++it)
+                result.push_back (it.memberName ());
+            return result;
+        };
+
+        auto const names = keys (parsed);
+        BEAST_EXPECT(names.size () == 2);
+        BEAST_EXPECT(names[0] == name.c_str ());
+        BEAST_EXPECT(std::string (names[1]) == "json_value_test_other");
+
+        Json::Value const copy = parsed;
+        BEAST_EXPECT(keys (copy)[0] == name.c_str ());
+        BEAST_EXPECT(keys (copy)[1] != names[1]);
+        BEAST_EXPECT(copy["json_value_test_interned"] == 2);
+        BEAST_EXPECT(copy["json_value_test_other"] == 3);
+    }
+
     void run ()
     {
         test_bool ();
@@ -230,6 +382,9 @@ struct json_value_test : beast::unit_test::suite
         test_copy ();
         test_move ();
         test_comparisons ();
+        test_reader ();
+        test_arena ();
+        test_interning ();
     }
 };
 
@@ -0,0 +1,272 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/json_value.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/beast/unit_test.h>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace ripple {
+
+/*  Measures building, serializing and destroying trees shaped like the
+    responses of account_tx, ledger and book_offers, with and without a
+    Json::ScopedArena, and parsing them back.
+
+    The argument is the number of times each response is built, by
+    default 200.
+*/
+class json_value_timing_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static
+    std::string
+    ms (clock_type::duration d)
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) <<
+            std::chrono::duration<double, std::milli>(d).count() << "ms";
+        return ss.str();
+    }
+
+    static
+    std::string
+    hex (int i, std::size_t size)
+    {
+        std::string s (size, '0');
+        auto n = static_cast<unsigned> (i);
+        for (auto p = s.rbegin(); n != 0 && p != s.rend(); ++p, n >>= 4)
+            *p = "0123456789ABCDEF"[n & 15];
+        return s;
+    }
+
+    // A payment with metadata, as in account_tx and expanded ledgers
+    static
+    Json::Value
+    transaction (int i)
+    {
+        Json::Value tx (Json::objectValue);
+        tx[jss::Account] = "r" + hex (i, 33);
+        tx[jss::Amount] = std::to_string (1000000 + i);
+        tx[jss::Destination] = "r" + hex (i + 1, 33);
+        tx[jss::Fee] = "10";
+        tx[jss::Flags] = 2147483648u;
+        tx[jss::Sequence] = i;
+        tx[jss::SigningPubKey] = hex (i, 66);
+        tx[jss::TransactionType] = "Payment";
+        tx[jss::TxnSignature] = hex (i, 140);
+        tx[jss::date] = 550000000 + i;
+        tx[jss::hash] = hex (i, 64);
+        tx[jss::inLedger] = 30000000 + i / 10;
+        tx[jss::ledger_index] = 30000000 + i / 10;
+
+        Json::Value meta (Json::objectValue);
+        auto& nodes = meta["AffectedNodes"] = Json::arrayValue;
+        for (int n = 0; n < 2; ++n)
+        {
+            Json::Value node (Json::objectValue);
+            auto& modified = node["ModifiedNode"];
+            auto& fields = modified["FinalFields"];
+            fields[jss::Account] = "r" + hex (i + n, 33);
+            fields["Balance"] = std::to_string (99000000 - i);
+            fields[jss::Flags] = 0;
+            fields["OwnerCount"] = n;
+            fields[jss::Sequence] = i + 1;
+            modified["LedgerEntryType"] = "AccountRoot";
+            modified["LedgerIndex"] = hex (i + n, 64);
+            modified["PreviousFields"]["Balance"] =
+                std::to_string (99000010 - i);
+            modified["PreviousTxnID"] = hex (i - 1, 64);
+            modified["PreviousTxnLgrSeq"] = 29999999 + i / 10;
+            nodes.append (std::move (node));
+        }
+        meta["TransactionIndex"] = i % 10;
+        meta["TransactionResult"] = "tesSUCCESS";
+        meta["delivered_amount"] = std::to_string (1000000 + i);
+
+        Json::Value entry (Json::objectValue);
+        entry[jss::meta] = std::move (meta);
+        entry[jss::tx] = std::move (tx);
+        entry[jss::validated] = true;
+        return entry;
+    }
+
+    static
+    Json::Value
+    accountTx ()
+    {
+        Json::Value result (Json::objectValue);
+        result[jss::account] = "r" + hex (0, 33);
+        result[jss::ledger_index_min] = 32570;
+        result[jss::ledger_index_max] = 30000100;
+        result[jss::limit] = 200;
+        result[jss::marker][jss::ledger] = 30000020;
+        result[jss::marker][jss::seq] = 0;
+        auto& txs = result[jss::transactions] = Json::arrayValue;
+        for (int i = 0; i < 200; ++i)
+            txs.append (transaction (i));
+        result[jss::validated] = true;
+        return result;
+    }
+
+    static
+    Json::Value
+    ledger ()
+    {
+        Json::Value result (Json::objectValue);
+        auto& l = result[jss::ledger];
+        l[jss::accepted] = true;
+        l[jss::account_hash] = hex (1, 64);
+        l[jss::close_time] = 550000000;
+        l[jss::ledger_hash] = hex (2, 64);
+        l[jss::ledger_index] = "30000000";
+        l[jss::parent_hash] = hex (3, 64);
+        l[jss::total_coins] = "99999999999999999";
+        auto& txs = l[jss::transactions] = Json::arrayValue;
+        for (int i = 0; i < 100; ++i)
+        {
+            auto entry = transaction (i);
+            Json::Value tx = std::move (entry[jss::tx]);
+            tx[jss::metaData] = std::move (entry[jss::meta]);
+            txs.append (std::move (tx));
+        }
+        result[jss::validated] = true;
+        return result;
+    }
+
+    static
+    Json::Value
+    bookOffers ()
+    {
+        Json::Value result (Json::objectValue);
+        result[jss::ledger_current_index] = 30000001;
+        auto& offers = result[jss::offers] = Json::arrayValue;
+        for (int i = 0; i < 300; ++i)
+        {
+            Json::Value offer (Json::objectValue);
+            offer[jss::Account] = "r" + hex (i, 33);
+            offer["BookDirectory"] = hex (i, 64);
+            offer["BookNode"] = "0000000000000000";
+            offer[jss::Flags] = 0;
+            offer["LedgerEntryType"] = "Offer";
+            offer["OwnerNode"] = "0000000000000000";
+            offer[jss::Sequence] = i;
+            auto& gets = offer[jss::TakerGets];
+            gets[jss::currency] = "USD";
+            gets[jss::issuer] = "r" + hex (1, 33);
+            gets[jss::value] = std::to_string (100 + i);
+            offer[jss::TakerPays] = std::to_string (50000000 + i);
+            offer[jss::index] = hex (i, 64);
+            offer[jss::owner_funds] = std::to_string (1000 + i);
+            offer[jss::quality] = std::to_string (500000 + i);
+            offers.append (std::move (offer));
+        }
+        return result;
+    }
+
+    struct Times
+    {
+        clock_type::duration build {};
+        clock_type::duration write {};
+        clock_type::duration destroy {};
+        clock_type::duration parse {};
+    };
+
+    template <class Build>
+    Times
+    measure (int iterations, bool arena, std::string const& text,
+        Build&& build)
+    {
+        Times times;
+        std::size_t bytes = 0;
+        for (int i = 0; i < iterations; ++i)
+        {
+            std::unique_ptr<Json::ScopedArena> scope;
+            if (arena)
+                scope = std::make_unique<Json::ScopedArena>();
+
+            auto const start = clock_type::now();
+            auto v = std::make_unique<Json::Value> (build ());
+            auto const built = clock_type::now();
+            bytes += to_string (*v).size ();
+            auto const written = clock_type::now();
+            v.reset ();
+            auto const destroyed = clock_type::now();
+
+            Json::Reader r;
+            Json::Value parsed;
+            if (! r.parse (text, parsed))
+                fail ("parse");
+            auto const parsedDone = clock_type::now();
+
+            times.build += built - start;
+            times.write += written - built;
+            times.destroy += destroyed - written;
+            times.parse += parsedDone - destroyed;
+        }
+        BEAST_EXPECT(bytes == iterations * text.size ());
+        return times;
+    }
+
+    template <class Build>
+    void
+    measure (std::string const& name, int iterations, Build&& build)
+    {
+        auto const text = to_string (build ());
+        auto const heap = measure (iterations, false, text, build);
+        auto const arena = measure (iterations, true, text, build);
+
+        auto report = [&](std::string const& mode, Times const& t)
+        {
+            log << std::left << std::setw(12) << name <<
+                std::setw(6) << mode << std::right <<
+                " build " << std::setw(9) << ms (t.build) <<
+                " write " << std::setw(9) << ms (t.write) <<
+                " destroy " << std::setw(9) << ms (t.destroy) <<
+                " parse " << std::setw(9) << ms (t.parse) << std::endl;
+        };
+        report ("heap", heap);
+        report ("arena", arena);
+    }
+
+public:
+    void
+    run() override
+    {
+        int iterations = 200;
+        if (! arg().empty())
+            iterations = std::stoi (arg());
+
+        testcase ("responses");
+        log << iterations << " iterations" << std::endl;
+        measure ("account_tx", iterations, &accountTx);
+        measure ("ledger", iterations, &ledger);
+        measure ("book_offers", iterations, &bookOffers);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(json_value_timing,json,ripple);
+
+}
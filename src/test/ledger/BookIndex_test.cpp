@@ -0,0 +1,329 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/BookIndex.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/protocol/Book.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/JsonFields.h>
+#include <test/jtx.h>
+#include <test/shamap/common.h>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace ripple {
+namespace test {
+
+class BookIndex_test : public beast::unit_test::suite
+{
+    // The answer of the state map itself
+    static
+    boost::optional<uint256>
+    walk (SHAMap const& map, uint256 const& key, uint256 const& last)
+    {
+        auto const item = map.upper_bound (key);
+        if (item == map.end() || item->key() >= last)
+            return boost::none;
+        return item->key();
+    }
+
+    static
+    uint256
+    randomKey (std::mt19937_64& rng)
+    {
+        uint256 key;
+        for (auto& b : key)
+            b = static_cast<std::uint8_t>(rng());
+        return key;
+    }
+
+    // Walk each book from its base, as BookTip does
+    void
+    check (SHAMap const& map, BookIndex const& index,
+        std::vector<uint256> const& bases)
+    {
+        for (auto const& base : bases)
+        {
+            auto const next = getQualityNext (base);
+            auto key = base;
+            for (;;)
+            {
+                boost::optional<uint256> result;
+                if (! BEAST_EXPECT(index.succ (map, key, next, result)))
+                    break;
+                BEAST_EXPECT(result == walk (map, key, next));
+                if (! result)
+                    break;
+                key = *result;
+            }
+        }
+    }
+
+    void
+    testIndex ()
+    {
+        testcase ("index");
+
+        beast::Journal const j;
+        tests::TestFamily f (j);
+        SHAMap map (SHAMapType::STATE, f, SHAMap::version{1});
+        map.setUnbacked ();
+        std::mt19937_64 rng;
+
+        auto const gw = calcAccountID (randomKeyPair (KeyType::secp256k1).first);
+        std::vector<uint256> bases;
+        for (auto const currency : {"USD", "EUR", "BTC", "JPY"})
+            bases.push_back (getBookBase (Book (
+                xrpIssue(), Issue (to_currency (currency), gw))));
+
+        auto const add = [](SHAMap& m, uint256 const& key)
+        {
+            return m.addItem (SHAMapItem{key, Blob (12, 1)}, false, false);
+        };
+
+        // Quality directories of the first three books, including one at
+        // the book base, and unrelated entries
+        std::vector<uint256> dirs;
+        add (map, bases[0]);
+        for (int i = 0; i < 300; ++i)
+        {
+            auto const key = getQualityIndex (bases[i % 3], rng());
+            if (add (map, key))
+                dirs.push_back (key);
+            add (map, randomKey (rng));
+        }
+
+        BookIndex index;
+        check (map, index, {bases[0], bases[1], bases[2]});
+        BEAST_EXPECT(index.size() == 3);
+
+        // Queries spanning more than one book use the state map
+        {
+            boost::optional<uint256> result;
+            BEAST_EXPECT(! index.succ (map, uint256{}, bases[0], result));
+            BEAST_EXPECT(! index.succ (map, bases[0],
+                getQualityNext (bases[1]), result));
+            auto const before = --uint256 (bases[0]);
+            BEAST_EXPECT(! index.succ (map, before,
+                getQualityNext (bases[0]), result));
+            BEAST_EXPECT(! index.succ (map, bases[0],
+                ++getQualityNext (bases[0]), result));
+            BEAST_EXPECT(index.size() == 3);
+        }
+
+        // The next ledger changes some books and adds another, leaving
+        // the parent as it was
+        auto child = map.snapShot (true);
+        BookIndex childIndex (index);
+        for (int i = 0; i < 100; ++i)
+        {
+            auto const pos = rng() % dirs.size();
+            if (child->delItem (dirs[pos]))
+                childIndex.erase (dirs[pos]);
+            auto const key = getQualityIndex (bases[i % 4], rng());
+            if (add (*child, key))
+                childIndex.insert (key);
+        }
+        child->delItem (bases[0]);
+        childIndex.erase (bases[0]);
+
+        check (*child, childIndex, bases);
+        BEAST_EXPECT(childIndex.size() == 4);
+        check (map, index, {bases[0], bases[1], bases[2]});
+        BEAST_EXPECT(index.size() == 3);
+
+        // A copy of a copy is as current as its parent
+        BookIndex grandchildIndex (childIndex);
+        check (*child, grandchildIndex, bases);
+    }
+
+    void
+    testLedger ()
+    {
+        testcase ("ledger");
+        using namespace jtx;
+
+        Env env (*this);
+        auto const gw = Account ("gw");
+        auto const USD = gw["USD"];
+        env.fund (XRP(100000), "alice", "bob", gw);
+        env.trust (USD(10000), "alice", "bob");
+        env.close();
+        env (pay (gw, "alice", USD(1000)));
+        env.close();
+
+        auto const base = getBookBase (Book (xrpIssue(), USD.issue()));
+        auto const next = getQualityNext (base);
+        auto const dirs = [&](std::shared_ptr<ReadView const> const& view)
+        {
+            auto const& ledger = static_cast<Ledger const&>(*view);
+            std::size_t count = 0;
+            auto key = base;
+            for (;;)
+            {
+                auto const result = ledger.succ (key, next);
+                BEAST_EXPECT(result == walk (ledger.stateMap(), key, next));
+                if (! result)
+                    break;
+                key = *result;
+                ++count;
+            }
+            return count;
+        };
+
+        BEAST_EXPECT(dirs (env.closed()) == 0);
+
+        // Each ledger starts from the index of its parent
+        for (int i = 1; i <= 5; ++i)
+        {
+            env (offer ("alice", XRP(100 + i), USD(10)));
+            env (offer ("alice", XRP(200 + i), USD(10)));
+            env.close();
+            BEAST_EXPECT(dirs (env.closed()) == 2 * i);
+        }
+
+        // Consuming an offer removes its directory
+        env (pay ("bob", "bob", USD(10)), path (~USD),
+            sendmax (XRP(101)), txflags (tfPartialPayment));
+        env.close();
+        BEAST_EXPECT(dirs (env.closed()) == 9);
+    }
+
+public:
+    void
+    run() override
+    {
+        testIndex ();
+        testLedger ();
+    }
+};
+
+/*  Times order book workloads like those of Offer_test and Flow_test.
+
+    A book is filled with offers at distinct qualities, then payments
+    cross it and book_offers reads it. Walking the book through the
+    ledger, which uses the index, is compared with walking the state
+    map. The argument is the number of offers, default 2000.
+*/
+class BookIndex_manual_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static
+    double
+    millis (clock_type::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(
+            clock_type::now() - start).count();
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+
+        std::size_t count = 2000;
+        if (! arg().empty())
+            count = std::stoul (arg());
+
+        testcase (std::to_string (count) + " offers");
+
+        Env env (*this);
+        auto const gw = Account ("gw");
+        auto const USD = gw["USD"];
+        env.fund (XRP(10000000), "alice", "bob", gw);
+        env.trust (USD(10000000), "alice", "bob");
+        env.close();
+        env (pay (gw, "alice", USD(1000000)));
+        env.close();
+
+        auto start = clock_type::now();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            env (offer ("alice", XRP(100 + i), USD(10)));
+            if (i % 256 == 255)
+                env.close();
+        }
+        env.close();
+        auto const create = millis (start);
+
+        // Walk the book as BookTip does
+        auto const base = getBookBase (Book (xrpIssue(), USD.issue()));
+        auto const next = getQualityNext (base);
+        auto const& ledger = static_cast<Ledger const&>(*env.closed());
+        std::size_t indexed = 0;
+        start = clock_type::now();
+        for (auto key = ledger.succ (base, next); key;
+                key = ledger.succ (*key, next))
+            ++indexed;
+        auto const indexWalk = millis (start);
+
+        std::size_t walked = 0;
+        auto const& map = ledger.stateMap();
+        start = clock_type::now();
+        for (auto item = map.upper_bound (base);
+                item != map.end() && item->key() < next;
+                item = map.upper_bound (item->key()))
+            ++walked;
+        auto const mapWalk = millis (start);
+        BEAST_EXPECT(indexed == walked);
+
+        Json::Value params;
+        params[jss::taker_pays][jss::currency] = "XRP";
+        params[jss::taker_gets][jss::currency] = "USD";
+        params[jss::taker_gets][jss::issuer] = gw.human();
+        params[jss::limit] = 200;
+        start = clock_type::now();
+        for (int i = 0; i < 100; ++i)
+        {
+            auto const jrr = env.rpc ("json", "book_offers",
+                to_string (params))[jss::result];
+            BEAST_EXPECT(jrr[jss::offers].isArray());
+        }
+        auto const bookOffers = millis (start) / 100;
+
+        // Each payment consumes the best offers
+        start = clock_type::now();
+        for (int i = 0; i < 100; ++i)
+            env (pay ("bob", "bob", USD(25)), path (~USD),
+                sendmax (XRP(1000)), txflags (tfPartialPayment));
+        env.close();
+        auto const payments = millis (start) / 100;
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(3) <<
+            count << " offers created in " << create << "ms\n" <<
+            "Book walk, index:      " << indexWalk << "ms (" <<
+                indexed << " directories)\n" <<
+            "Book walk, state map:  " << mapWalk << "ms\n" <<
+            "book_offers:           " << bookOffers << "ms per request\n" <<
+            "Crossing payment:      " << payments << "ms per payment";
+        log << ss.str() << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(BookIndex,ledger,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(BookIndex_manual,ledger,ripple);
+
+}  // test
+}  // ripple
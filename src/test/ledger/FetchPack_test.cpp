@@ -0,0 +1,363 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/basics/UptimeTimer.h>
+#include <ripple/overlay/Message.h>
+#include <ripple/overlay/Peer.h>
+#include <ripple/protocol/SecretKey.h>
+#include <test/jtx.h>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class FetchPack_test : public beast::unit_test::suite
+{
+    // Keeps the fetch pack messages sent to it
+    class TestPeer : public Peer
+    {
+        PublicKey const key_ = derivePublicKey (
+            KeyType::secp256k1, randomSecretKey ());
+        uint256 const closed_;
+
+    public:
+        std::vector<protocol::TMGetObjectByHash> messages;
+
+        void
+        send (Message::pointer const& m) override
+        {
+            auto const& buffer = m->getBuffer ();
+            messages.emplace_back ();
+            messages.back ().ParseFromArray (
+                buffer.data () + Message::kHeaderBytes,
+                buffer.size () - Message::kHeaderBytes);
+        }
+
+        beast::IP::Endpoint
+        getRemoteAddress () const override
+        {
+            return {};
+        }
+
+        void
+        charge (Resource::Charge const&) override
+        {
+        }
+
+        id_t
+        id () const override
+        {
+            return 1;
+        }
+
+        bool
+        cluster () const override
+        {
+            return false;
+        }
+
+        bool
+        isHighLatency () const override
+        {
+            return false;
+        }
+
+        int
+        getScore (bool) const override
+        {
+            return 0;
+        }
+
+        PublicKey const&
+        getNodePublic () const override
+        {
+            return key_;
+        }
+
+        Json::Value
+        json () override
+        {
+            return {};
+        }
+
+        uint256 const&
+        getClosedLedgerHash () const override
+        {
+            return closed_;
+        }
+
+        bool
+        hasLedger (uint256 const&, std::uint32_t) const override
+        {
+            return false;
+        }
+
+        void
+        ledgerRange (std::uint32_t&, std::uint32_t&) const override
+        {
+        }
+
+        bool
+        hasTxSet (uint256 const&) const override
+        {
+            return false;
+        }
+
+        void
+        cycleStatus () override
+        {
+        }
+
+        bool
+        supportsVersion (int) override
+        {
+            return true;
+        }
+
+        bool
+        hasRange (std::uint32_t, std::uint32_t) override
+        {
+            return false;
+        }
+    };
+
+    // Closes ledgers in which each account submits the given number of
+    // transactions
+    static
+    void
+    fill (jtx::Env& env, std::vector<jtx::Account> const& accounts,
+        int txs, int ledgers)
+    {
+        for (int i = 0; i < ledgers; ++i)
+        {
+            for (auto const& account : accounts)
+                for (int j = 0; j < txs; ++j)
+                    env (jtx::noop (account));
+            env.close ();
+        }
+    }
+
+    static
+    std::vector<jtx::Account>
+    makeAccounts (jtx::Env& env, int count)
+    {
+        std::vector<jtx::Account> accounts;
+        for (int i = 0; i < count; ++i)
+            accounts.emplace_back ("a" + std::to_string (i));
+        for (auto const& account : accounts)
+            env.fund (jtx::XRP (10000), account);
+        env.close ();
+        return accounts;
+    }
+
+    // Requests a pack from the parent of have, resuming after the node
+    // last, of the ledger seq, if seq is not zero
+    static
+    std::shared_ptr<TestPeer>
+    request (jtx::Env& env, uint256 const& have,
+        std::uint32_t seq = 0, std::string const& last = {})
+    {
+        auto peer = std::make_shared<TestPeer> ();
+        auto request = std::make_shared<protocol::TMGetObjectByHash> ();
+        request->set_query (true);
+        request->set_type (protocol::TMGetObjectByHash::otFETCH_PACK);
+        request->set_ledgerhash (have.data (), have.size ());
+        if (seq != 0)
+        {
+            auto& cursor = *request->add_objects ();
+            cursor.set_hash (last);
+            cursor.set_ledgerseq (seq);
+        }
+        env.app ().getLedgerMaster ().makeFetchPack (peer, request, have,
+            UptimeTimer::getInstance ().getElapsedSeconds ());
+        return peer;
+    }
+
+    // The hash of a ledger as a fetch pack object carries it
+    static
+    std::string
+    headerHash (jtx::Env& env, std::uint32_t seq)
+    {
+        auto const ledger = env.app ().getLedgerMaster ().getLedgerBySeq (seq);
+        if (! ledger)
+            return {};
+        return std::string (
+            ledger->info ().hash.cbegin (), ledger->info ().hash.cend ());
+    }
+
+    // The number of objects sent for each ledger, and whether its header
+    // was among them
+    struct Sent
+    {
+        std::size_t objects = 0;
+        bool header = false;
+    };
+
+    static
+    std::map<std::uint32_t, Sent>
+    sent (jtx::Env& env, TestPeer const& peer)
+    {
+        std::map<std::uint32_t, Sent> result;
+        for (auto const& message : peer.messages)
+        {
+            for (auto const& object : message.objects ())
+            {
+                auto& s = result[object.ledgerseq ()];
+                ++s.objects;
+                if (object.hash () == headerHash (env, object.ledgerseq ()))
+                    s.header = true;
+            }
+        }
+        return result;
+    }
+
+    void
+    testMessages ()
+    {
+        testcase ("messages");
+        using namespace jtx;
+
+        Env env (*this);
+        auto const accounts = makeAccounts (env, 50);
+        fill (env, accounts, 2, 25);
+
+        auto const peer = request (env, env.closed ()->info ().hash);
+
+        // The pack fills as many messages as allowed, 512 nodes each
+        if (! BEAST_EXPECT(peer->messages.size () == 8))
+            return;
+        for (auto const& message : peer->messages)
+            BEAST_EXPECT(message.objects_size () == 512);
+
+        // Each ledger but the oldest was sent whole, with its header.
+        // The oldest was cut off, unless the last message ended with its
+        // header, so the requester asks for it again.
+        auto const ledgers = sent (env, *peer);
+        if (! BEAST_EXPECT(ledgers.size () > 1))
+            return;
+        BEAST_EXPECT(ledgers.rbegin ()->first ==
+            env.closed ()->info ().seq - 1);
+        auto const oldest = ledgers.begin ()->first;
+        for (auto const& ledger : ledgers)
+        {
+            if (ledger.first != oldest)
+                BEAST_EXPECT(ledger.second.header);
+        }
+        auto const& last = peer->messages.back ().objects (511);
+        BEAST_EXPECT(ledgers.begin ()->second.header ==
+            (last.hash () == headerHash (env, oldest)));
+    }
+
+    void
+    testResume ()
+    {
+        testcase ("resume");
+        using namespace jtx;
+
+        // Ledgers large enough that the pack ends inside one of them
+        Env env (*this);
+        auto const accounts = makeAccounts (env, 50);
+        fill (env, accounts, 12, 6);
+
+        auto const first = request (env, env.closed ()->info ().hash);
+        auto const ledgers = sent (env, *first);
+        if (! BEAST_EXPECT(first->messages.size () == 8) ||
+                ! BEAST_EXPECT(! ledgers.empty ()))
+            return;
+        auto const seq = ledgers.begin ()->first;
+        BEAST_EXPECT(! ledgers.begin ()->second.header);
+
+        // Ask again from the cut off ledger, after its last node received
+        auto const& last = first->messages.back ().objects (511);
+        BEAST_EXPECT(last.ledgerseq () == seq);
+        auto const child = env.app ().getLedgerMaster ().getLedgerBySeq (
+            seq + 1);
+        if (! BEAST_EXPECT(child))
+            return;
+        auto const second = request (env, child->info ().hash,
+            seq, last.hash ());
+
+        // The rest of the ledger follows, ending with its header, and no
+        // node is sent twice
+        std::set<std::string> hashes;
+        for (auto const& message : first->messages)
+            for (auto const& object : message.objects ())
+                if (object.ledgerseq () == seq)
+                    hashes.insert (object.hash ());
+        bool repeated = false;
+        for (auto const& message : second->messages)
+            for (auto const& object : message.objects ())
+                if (object.ledgerseq () == seq &&
+                        ! hashes.insert (object.hash ()).second)
+                    repeated = true;
+        BEAST_EXPECT(! repeated);
+
+        auto const rest = sent (env, *second);
+        if (! BEAST_EXPECT(! rest.empty ()))
+            return;
+        BEAST_EXPECT(rest.rbegin ()->first == seq);
+        BEAST_EXPECT(rest.rbegin ()->second.header);
+    }
+
+    void
+    testDeltaCache ()
+    {
+        testcase ("delta cache");
+        using namespace jtx;
+
+        Env env (*this);
+        auto const accounts = makeAccounts (env, 20);
+        fill (env, accounts, 1, 5);
+
+        auto& lm = env.app ().getLedgerMaster ();
+        auto const have = env.closed ()->info ().hash;
+
+        auto const first = request (env, have);
+        BEAST_EXPECT(lm.getFetchPackDeltaHitRate () == 0);
+
+        // The same request is served from the cached deltas
+        auto const second = request (env, have);
+        BEAST_EXPECT(lm.getFetchPackDeltaHitRate () == 50);
+
+        if (! BEAST_EXPECT(first->messages.size () ==
+                second->messages.size ()))
+            return;
+        for (std::size_t i = 0; i < first->messages.size (); ++i)
+            BEAST_EXPECT(first->messages[i].SerializeAsString () ==
+                second->messages[i].SerializeAsString ());
+    }
+
+public:
+    void
+    run () override
+    {
+        testMessages ();
+        testResume ();
+        testDeltaCache ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FetchPack,ledger,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerSnapshot.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/protocol/JsonFields.h>
+#include <test/jtx.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace ripple {
+namespace test {
+
+class LedgerSnapshot_test : public beast::unit_test::suite
+{
+    void
+    testRoundTrip ()
+    {
+        testcase ("round trip");
+        using namespace jtx;
+
+        Env env (*this);
+        auto const gw = Account ("gateway");
+        auto const USD = gw["USD"];
+        env.fund (XRP(10000), "alice", "bob", gw);
+        env.trust (USD(1000), "alice", "bob");
+        env.close();
+        env (pay (gw, "alice", USD(100)));
+        env (offer ("alice", XRP(100), USD(10)));
+        env.close();
+
+        beast::temp_dir td;
+        auto const file = td.file ("ledger.snap");
+        auto const closed = env.app().getLedgerMaster().getLedgerByHash (
+            env.closed()->info().hash);
+        if (! BEAST_EXPECT(closed))
+            return;
+
+        auto const nodes = writeLedgerSnapshot (*closed, file);
+        BEAST_EXPECT(nodes > 0);
+        BEAST_EXPECT(! boost::filesystem::exists (file + ".tmp"));
+
+        auto const loaded = loadLedgerSnapshot (file, env.app(), env.journal);
+        if (! BEAST_EXPECT(loaded))
+            return;
+        BEAST_EXPECT(loaded->info().hash == closed->info().hash);
+        BEAST_EXPECT(loaded->info().seq == closed->info().seq);
+        BEAST_EXPECT(loaded->stateMap().getHash() ==
+            closed->stateMap().getHash());
+        BEAST_EXPECT(loaded->exists (keylet::account (
+            Account ("alice").id())));
+
+        // A damaged byte is caught by the node hashes or the checksum
+        auto const size = boost::filesystem::file_size (file);
+        auto const damaged = td.file ("damaged.snap");
+        boost::filesystem::copy_file (file, damaged);
+        {
+            std::fstream f (damaged,
+                std::ios::in | std::ios::out | std::ios::binary);
+            f.seekp (size / 2);
+            char c = 0;
+            f.read (&c, 1);
+            f.seekp (size / 2);
+            c ^= 0x5a;
+            f.write (&c, 1);
+        }
+        BEAST_EXPECT(! loadLedgerSnapshot (damaged, env.app(), env.journal));
+
+        // A truncated file is incomplete
+        auto const truncated = td.file ("truncated.snap");
+        boost::filesystem::copy_file (file, truncated);
+        boost::filesystem::resize_file (truncated, size - 40);
+        BEAST_EXPECT(! loadLedgerSnapshot (truncated, env.app(), env.journal));
+
+        // So is a missing one
+        BEAST_EXPECT(! loadLedgerSnapshot (
+            td.file ("missing.snap"), env.app(), env.journal));
+    }
+
+    void
+    testRPC ()
+    {
+        testcase ("ledger_snapshot");
+        using namespace jtx;
+
+        // Without a snapshot_path the call is disabled
+        {
+            Env env (*this);
+            env.close();
+            auto const jrr = env.rpc ("ledger_snapshot")[jss::result];
+            BEAST_EXPECT(jrr[jss::error] == "notEnabled");
+        }
+
+        beast::temp_dir td;
+        auto const file = td.file ("rpc.snap");
+        Env env (*this, envconfig ([&](std::unique_ptr<Config> cfg)
+            {
+                cfg->section (ConfigSection::nodeDatabase ()).set (
+                    "snapshot_path", file);
+                return cfg;
+            }));
+        env.fund (XRP(10000), "alice");
+        env.close();
+
+        // No snapshot written yet
+        auto jrr = env.rpc ("ledger_snapshot")[jss::result];
+        BEAST_EXPECT(jrr[jss::snapshot].isObject() &&
+            jrr[jss::snapshot].size() == 0);
+
+        jrr = env.rpc ("ledger_snapshot", "current")[jss::result];
+        BEAST_EXPECT(jrr[jss::error] == "notSupported");
+
+        // The snapshot is written by a job
+        jrr = env.rpc ("ledger_snapshot", "closed")[jss::result];
+        BEAST_EXPECT(jrr[jss::message] == "Snapshot queued");
+        BEAST_EXPECT(jrr[jss::ledger_hash] ==
+            to_string (env.closed()->info().hash));
+        env.app().getJobQueue().rendezvous();
+
+        jrr = env.rpc ("ledger_snapshot")[jss::result];
+        auto const& snapshot = jrr[jss::snapshot];
+        BEAST_EXPECT(snapshot[jss::state] == "written");
+        BEAST_EXPECT(snapshot[jss::nodes].asUInt() > 0);
+        BEAST_EXPECT(snapshot[jss::ledger_hash] ==
+            to_string (env.closed()->info().hash));
+
+        auto const loaded = loadLedgerSnapshot (file, env.app(), env.journal);
+        BEAST_EXPECT(loaded &&
+            loaded->info().hash == env.closed()->info().hash);
+    }
+
+public:
+    void
+    run () override
+    {
+        testRoundTrip ();
+        testRPC ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerSnapshot,ledger,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,217 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/RecentLedgers.h>
+#include <test/jtx.h>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class RecentLedgers_test : public beast::unit_test::suite
+{
+    void
+    testLedgerMaster ()
+    {
+        testcase ("ledger master");
+        using namespace jtx;
+
+        Env env (*this);
+        auto& lm = env.app().getLedgerMaster();
+        std::vector<std::shared_ptr<Ledger const>> ledgers;
+        for (int i = 0; i < 10; ++i)
+        {
+            env.fund (XRP(1000), Account ("alice" + std::to_string (i)));
+            env.close();
+            ledgers.push_back (lm.getClosedLedger());
+        }
+
+        auto const validated = lm.getValidatedLedger();
+        if (! BEAST_EXPECT(validated))
+            return;
+        BEAST_EXPECT(validated->info().hash == ledgers.back()->info().hash);
+
+        for (auto const& ledger : ledgers)
+        {
+            auto const bySeq = lm.getLedgerBySeq (ledger->info().seq);
+            BEAST_EXPECT(bySeq && bySeq->info().hash == ledger->info().hash);
+            auto const byHash = lm.getLedgerByHash (ledger->info().hash);
+            BEAST_EXPECT(byHash && byHash->info().seq == ledger->info().seq);
+        }
+
+        // Ledgers not yet closed are not found
+        BEAST_EXPECT(! lm.getLedgerBySeq (validated->info().seq + 1));
+    }
+
+    void
+    testChain ()
+    {
+        testcase ("chain");
+        using namespace jtx;
+
+        Env env (*this);
+        auto& lm = env.app().getLedgerMaster();
+        std::vector<std::shared_ptr<Ledger const>> ledgers;
+        for (int i = 0; i < 5; ++i)
+        {
+            env.close();
+            ledgers.push_back (lm.getClosedLedger());
+        }
+
+        RecentLedgers recent (env.journal);
+        BEAST_EXPECT(! recent.validated());
+        BEAST_EXPECT(! recent.get (ledgers[0]->info().seq));
+
+        // Only ancestors of the validated ledger are kept
+        recent.insert (ledgers[2]);
+        BEAST_EXPECT(! recent.get (ledgers[2]->info().seq));
+        recent.setValidated (ledgers[3]);
+        for (auto i : {0, 1, 2})
+            recent.insert (ledgers[i]);
+        recent.insert (ledgers[4]);
+        for (auto i : {0, 1, 2, 3})
+        {
+            BEAST_EXPECT(recent.get (ledgers[i]->info().seq) == ledgers[i]);
+            BEAST_EXPECT(recent.get (ledgers[i]->info().hash) == ledgers[i]);
+        }
+        BEAST_EXPECT(! recent.get (ledgers[4]->info().seq));
+        BEAST_EXPECT(! recent.get (ledgers[4]->info().hash));
+        BEAST_EXPECT(recent.validated() == ledgers[3]);
+
+        // A ledger of another chain replaces those of this one
+        Env other (*this);
+        other (noop (other.master));
+        for (int i = 0; i < 6; ++i)
+            other.close();
+        auto const fork = other.app().getLedgerMaster().getClosedLedger();
+        BEAST_EXPECT(fork->info().seq == ledgers[4]->info().seq + 1);
+        recent.insert (fork);
+        BEAST_EXPECT(! recent.get (fork->info().seq));
+        recent.setValidated (fork);
+        BEAST_EXPECT(recent.validated() == fork);
+        BEAST_EXPECT(recent.get (fork->info().seq) == fork);
+        for (auto const& ledger : ledgers)
+        {
+            BEAST_EXPECT(! recent.get (ledger->info().seq));
+            BEAST_EXPECT(! recent.get (ledger->info().hash));
+        }
+
+
+        auto const parent = other.app().getLedgerMaster().getLedgerBySeq (
+            fork->info().seq - 1);
+        if (! BEAST_EXPECT(parent))
+            return;
+        recent.insert (parent);
+        BEAST_EXPECT(recent.get (parent->info().seq) == parent);
+        BEAST_EXPECT(recent.get (parent->info().hash) == parent);
+    }
+
+public:
+    void
+    run() override
+    {
+        testLedgerMaster ();
+        testChain ();
+    }
+};
+
+/*  Times concurrent ledger lookups, as made by RPC handlers.
+
+    Each thread looks up the validated ledger and recent ledgers by
+    sequence and by hash. The argument is the number of lookups made
+    by each thread, default 1000000.
+*/
+class RecentLedgers_manual_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+
+        std::size_t count = 1000000;
+        if (! arg().empty())
+            count = std::stoul (arg());
+
+        testcase (std::to_string (count) + " lookups per thread");
+
+        Env env (*this);
+        auto& lm = env.app().getLedgerMaster();
+        std::vector<std::pair<LedgerIndex, uint256>> ids;
+        for (int i = 0; i < 64; ++i)
+        {
+            env.close();
+            auto const closed = lm.getClosedLedger();
+            ids.emplace_back (closed->info().seq, closed->info().hash);
+        }
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(0);
+        for (std::size_t threads : {1, 2, 4, 8})
+        {
+            std::atomic<std::size_t> missing {0};
+            auto const lookup = [&](std::size_t t)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    auto const& id = ids[(i + t) % ids.size()];
+                    std::shared_ptr<Ledger const> ledger;
+                    switch (i % 3)
+                    {
+                    case 0: ledger = lm.getValidatedLedger(); break;
+                    case 1: ledger = lm.getLedgerBySeq (id.first); break;
+                    default: ledger = lm.getLedgerByHash (id.second); break;
+                    }
+                    if (! ledger)
+                        ++missing;
+                }
+            };
+
+            auto const start = clock_type::now();
+            std::vector<std::thread> workers;
+            for (std::size_t t = 0; t < threads; ++t)
+                workers.emplace_back (lookup, t);
+            for (auto& w : workers)
+                w.join();
+            auto const elapsed = std::chrono::duration<double>(
+                clock_type::now() - start).count();
+
+            BEAST_EXPECT(missing == 0);
+            ss << threads << " threads: " <<
+                threads * count / elapsed << " lookups/s\n";
+        }
+        log << ss.str() << std::flush;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RecentLedgers,ledger,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(RecentLedgers_manual,ledger,ripple);
+
+}  // test
+}  // ripple
@@ -22,7 +22,10 @@
 #include <test/nodestore/TestBase.h>
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
+#include <ripple/nodestore/impl/EncodedBlob.h>
 #include <ripple/beast/utility/temp_dir.h>
+#include <boost/filesystem.hpp>
 #include <algorithm>
 
 namespace ripple {
@@ -97,6 +100,64 @@ public:
         }
     }
 
+    void testDictionary (std::uint64_t const seedValue)
+    {
+        DummyScheduler scheduler;
+
+        testcase ("Backend type=nudb with dictionary");
+
+        auto batch = createPredictableBatch (
+            numObjectsToTest, seedValue);
+
+        std::vector<Blob> samples;
+        EncodedBlob encoded;
+        for (auto const& object : batch)
+        {
+            encoded.prepare (object);
+            auto const p = static_cast<std::uint8_t const*>(
+                encoded.getData ());
+            samples.emplace_back (p, p + encoded.getSize ());
+        }
+
+        beast::temp_dir dictDir;
+        auto const dictFile = dictDir.file ("leaf.dict");
+        CompressionDictionary::train (
+            1, samples, 16 * 1024)->save (dictFile);
+
+        beast::temp_dir tempDir;
+        Section params;
+        params.set ("type", "nudb");
+        params.set ("path", tempDir.path());
+        params.set ("compression_dictionary", dictFile);
+
+        beast::Journal j;
+
+        {
+            std::unique_ptr <Backend> backend =
+                Manager::instance().make_Backend (params, scheduler, j);
+            storeBatch (*backend, batch);
+
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual (batch, copy));
+        }
+
+        // The database keeps its own copy of the dictionary
+        BEAST_EXPECT(boost::filesystem::exists (
+            tempDir.file ("nudb.dict")));
+        boost::filesystem::remove (dictFile);
+
+        {
+            params.set ("compression_dictionary", "");
+            std::unique_ptr <Backend> backend =
+                Manager::instance().make_Backend (params, scheduler, j);
+
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual (batch, copy));
+        }
+    }
+
     //--------------------------------------------------------------------------
 
     void run ()
@@ -105,6 +166,8 @@ public:
 
         testBackend ("nudb", seedValue);
 
+        testDictionary (seedValue);
+
     #if RIPPLE_ROCKSDB_AVAILABLE
         testBackend ("rocksdb", seedValue);
     #endif
@@ -23,6 +23,10 @@
 #include <ripple/nodestore/Manager.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/nodestore/impl/codec.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <nudb/detail/buffer.hpp>
 
 namespace ripple {
 namespace NodeStore {
@@ -77,6 +81,142 @@ public:
         }
     }
 
+    // Checks decoding compressed values in place
+    void testDecode (std::uint64_t const seedValue)
+    {
+        testcase ("decode");
+
+        auto batch = createPredictableBatch (
+            numObjectsToTest, seedValue);
+
+        EncodedBlob encoded;
+        for (int i = 0; i < batch.size (); ++i)
+        {
+            encoded.prepare (batch [i]);
+
+            nudb::detail::buffer bf;
+            auto const compressed = nodeobject_compress (
+                encoded.getData (), encoded.getSize (), bf);
+
+            auto const object = DecodedBlob::decode (encoded.getKey (),
+                [&compressed](auto&& bf)
+                {
+                    return nodeobject_decompress (
+                        compressed.first, compressed.second, bf);
+                });
+
+            BEAST_EXPECT(object && isSame(batch[i], object));
+        }
+
+        // Values which are not compressed are copied
+        {
+            encoded.prepare (batch [0]);
+            auto const object = DecodedBlob::decode (encoded.getKey (),
+                [&encoded](auto&&)
+                {
+                    return std::make_pair (
+                        encoded.getData (), encoded.getSize ());
+                });
+            BEAST_EXPECT(object && isSame(batch[0], object));
+        }
+
+        // Corrupt values are rejected
+        {
+            encoded.prepare (batch [0]);
+            auto const object = DecodedBlob::decode (encoded.getKey (),
+                [&encoded](auto&& bf)
+                {
+                    auto const p = bf (encoded.getSize ());
+                    std::memcpy (p, encoded.getData (), encoded.getSize ());
+                    static_cast<std::uint8_t*>(p)[8] = 0xff;
+                    return std::make_pair (
+                        static_cast<void const*>(p), encoded.getSize ());
+                });
+            BEAST_EXPECT(! object);
+        }
+    }
+
+    // Checks the dictionary codec
+    void testDictionary (std::uint64_t const seedValue)
+    {
+        testcase ("dictionary");
+
+        // Leaves which share most of their contents, like
+        // ledger entries of the same type do.
+        beast::xor_shift_engine rng (seedValue);
+        Blob common (200);
+        beast::rngfill (common.data (), common.size (), rng);
+
+        std::vector<Blob> values;
+        for (int i = 0; i < 200; ++i)
+        {
+            Blob value (9 + common.size ());
+            value[8] = hotACCOUNT_NODE;
+            std::copy (common.begin (), common.end (), value.begin () + 9);
+            for (int j = 0; j < 8; ++j)
+                value[9 + rand_int (rng, 199)] = rand_int<std::uint8_t> (rng);
+            values.push_back (std::move (value));
+        }
+
+        auto const dict = CompressionDictionary::train (
+            7, values, 4096);
+        BEAST_EXPECT(dict->id () == 7);
+        BEAST_EXPECT(dict->data ().size () <= 4096);
+
+        std::size_t plainBytes = 0;
+        std::size_t dictBytes = 0;
+        for (auto const& value : values)
+        {
+            nudb::detail::buffer bf1;
+            auto const plain = nodeobject_compress (
+                value.data (), value.size (), bf1);
+            plainBytes += plain.second;
+
+            nudb::detail::buffer bf2;
+            auto const compressed = nodeobject_compress (
+                value.data (), value.size (), bf2, dict.get ());
+            dictBytes += compressed.second;
+
+            nudb::detail::buffer bf3;
+            auto const decompressed = nodeobject_decompress (
+                compressed.first, compressed.second, bf3, dict.get ());
+            BEAST_EXPECT(makeSlice (value) ==
+                Slice (decompressed.first, decompressed.second));
+
+            try
+            {
+                nudb::detail::buffer bf4;
+                nodeobject_decompress (
+                    compressed.first, compressed.second, bf4);
+                fail ("missing dictionary not detected");
+            }
+            catch (std::runtime_error const&)
+            {
+                pass ();
+            }
+        }
+        BEAST_EXPECT(dictBytes < plainBytes);
+
+        // Inner nodes never use the dictionary
+        {
+            Blob inner (525);
+            std::uint32_t const prefix = HashPrefix::innerNode;
+            inner[9] = prefix >> 24;
+            inner[10] = (prefix >> 16) & 0xff;
+            inner[11] = (prefix >> 8) & 0xff;
+            inner[12] = prefix & 0xff;
+            inner[20] = 1;
+            nudb::detail::buffer bf;
+            auto const compressed = nodeobject_compress (
+                inner.data (), inner.size (), bf, dict.get ());
+            nudb::detail::buffer bf2;
+            auto const decompressed = nodeobject_decompress (
+                compressed.first, compressed.second, bf2);
+            BEAST_EXPECT(makeSlice (inner) ==
+                Slice (decompressed.first, decompressed.second));
+        }
+    }
+
     void run ()
     {
         std::uint64_t const seedValue = 50;
@@ -84,6 +224,10 @@ public:
         testBatches (seedValue);
 
         testBlobs (seedValue);
+
+        testDecode (seedValue);
+
+        testDictionary (seedValue);
     }
 };
 
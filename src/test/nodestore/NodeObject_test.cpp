@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/nodestore/TestBase.h>
+#include <ripple/nodestore/impl/DecodedBlob.h>
+#include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/nodestore/impl/codec.h>
+#include <ripple/basics/Buffer.h>
+#include <nudb/detail/buffer.hpp>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace ripple {
+namespace NodeStore {
+
+/*  Measures the cost of keeping many NodeObjects in
+    memory and of decoding them from a backend, comparing the current
+    single allocation layout against the previous layout in which the
+    object owned a separately allocated Blob.
+
+    The argument is the number of objects to create.
+*/
+class NodeObject_test : public TestBase
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // The previous layout, kept here for comparison
+    struct LegacyNodeObject
+    {
+        NodeObjectType type;
+        uint256 hash;
+        Blob data;
+    };
+
+    static
+    std::size_t
+    heapInUse()
+    {
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+        return mallinfo2().uordblks;
+#else
+        return static_cast<unsigned>(mallinfo().uordblks);
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    static
+    std::string
+    ms (clock_type::duration d)
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) <<
+            std::chrono::duration<double, std::milli>(d).count() << "ms";
+        return ss.str();
+    }
+
+    template <class Create>
+    void
+    measureMemory (std::string const& name,
+        Batch const& batch, Create&& create)
+    {
+        using result_type = decltype(create (*batch.front()));
+        std::vector<result_type> objects;
+        objects.reserve (batch.size());
+
+        auto const heap = heapInUse();
+        auto const start = clock_type::now();
+        for (auto const& object : batch)
+            objects.push_back (create (*object));
+        auto const created = clock_type::now();
+        auto const used = heapInUse() - heap;
+        objects.clear();
+        auto const destroyed = clock_type::now();
+
+        std::stringstream ss;
+        ss << std::left << std::setw(8) << name << std::right <<
+            " create " << std::setw(10) << ms (created - start) <<
+            " destroy " << std::setw(10) << ms (destroyed - created);
+        if (heap != 0)
+            ss << " heap " << std::setw(8) <<
+                used / batch.size() << " bytes/object";
+        log << ss.str() << std::endl;
+    }
+
+    template <class Decode>
+    void
+    measureDecode (std::string const& name,
+        std::vector<Buffer> const& values,
+        Batch const& batch, Decode&& decode)
+    {
+        std::size_t failed = 0;
+        auto const start = clock_type::now();
+        for (std::size_t i = 0; i < values.size(); ++i)
+            if (! decode (batch[i]->getHash().begin(), values[i]))
+                ++failed;
+        auto const elapsed = clock_type::now() - start;
+        BEAST_EXPECT(failed == 0);
+
+        log << std::left << std::setw(8) << name << std::right <<
+            " decode " << std::setw(10) << ms (elapsed) << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        int count = 1000000;
+        if (! arg().empty())
+            count = std::stoi (arg());
+
+        testcase ("memory");
+        auto const batch = createPredictableBatch (count, 7);
+        log << batch.size() << " objects" << std::endl;
+
+        measureMemory ("legacy", batch,
+            [](NodeObject const& object)
+            {
+                auto const data = object.getData();
+                return std::make_shared<LegacyNodeObject>(
+                    LegacyNodeObject{ object.getType(), object.getHash(),
+                        Blob (data.data(), data.data() + data.size()) });
+            });
+
+        measureMemory ("inline", batch,
+            [](NodeObject const& object)
+            {
+                return NodeObject::createObject (object.getType(),
+                    object.getData(), object.getHash());
+            });
+
+        testcase ("decode");
+        std::vector<Buffer> values;
+        values.reserve (batch.size());
+        {
+            EncodedBlob encoded;
+            for (auto const& object : batch)
+            {
+                encoded.prepare (object);
+                nudb::detail::buffer bf;
+                auto const result = nodeobject_compress (
+                    encoded.getData(), encoded.getSize(), bf);
+                values.emplace_back (result.first, result.second);
+            }
+        }
+
+        measureDecode ("copy", values, batch,
+            [](void const* key, Buffer const& value)
+            {
+                nudb::detail::buffer bf;
+                auto const result = nodeobject_decompress (
+                    value.data(), value.size(), bf);
+                DecodedBlob decoded (key, result.first, result.second);
+                if (! decoded.wasOk ())
+                    return std::shared_ptr<NodeObject>{};
+                return decoded.createObject ();
+            });
+
+        measureDecode ("inplace", values, batch,
+            [](void const* key, Buffer const& value)
+            {
+                return DecodedBlob::decode (key,
+                    [&value](auto&& bf)
+                    {
+                        return nodeobject_decompress (
+                            value.data(), value.size(), bf);
+                    });
+            });
+
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(NodeObject,NodeStore,ripple);
+
+}
+}
@@ -188,7 +188,8 @@ public:
         {
             std::shared_ptr<NodeObject> const object (batch [i]);
 
-            Blob data (object->getData ());
+            Blob data (object->getData ().data (),
+                object->getData ().data () + object->getData ().size ());
 
             db.store (object->getType (),
                       std::move (data),
@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/random.h>
+#include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
+#include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/nodestore/impl/codec.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <test/parse_args.h>
+#include <nudb/detail/buffer.hpp>
+#include <map>
+
+namespace ripple {
+namespace NodeStore {
+
+/*  Trains a compression dictionary for leaf nodes from a local node
+    store, and reports how well it compresses leaves which were not
+    used for training compared to plain lz4.
+
+    The resulting file may be named by the compression_dictionary key
+    of a NuDB [node_db] section.
+*/
+class dictionary_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        testcase(beast::unit_test::abort_on_fail) << arg();
+
+        auto const args = test::parse_args (arg());
+        if (args.find ("from") == args.end () ||
+            args.find ("to") == args.end ())
+        {
+            log <<
+                "Usage:\n" <<
+                "--unittest-arg=from=<from>,to=<to>[,type=<type>]"
+                    "[,id=<id>][,size=<size>][,samples=<samples>]\n" <<
+                "from:    Node store to sample\n" <<
+                "to:      Dictionary file to write\n" <<
+                "type:    Backend type of the node store, default nudb\n" <<
+                "id:      Dictionary identifier 1-255, default 1\n" <<
+                "size:    Dictionary size in bytes, default 16384\n" <<
+                "samples: Number of leaves to sample, default 100000" << std::endl;
+            pass();
+            return;
+        }
+
+        auto const arg_or = [&args](std::string const& name,
+            std::string const& def)
+        {
+            auto const iter = args.find (name);
+            return iter == args.end () ? def : iter->second;
+        };
+
+        auto const id = std::stoul (arg_or ("id", "1"));
+        auto const size = std::stoull (arg_or ("size", "16384"));
+        auto const count = std::stoull (arg_or ("samples", "100000"));
+        if (id < 1 || id > 255)
+        {
+            fail ("id must be between 1 and 255");
+            return;
+        }
+
+        DummyScheduler scheduler;
+        beast::Journal j;
+        Section params;
+        params.set ("type", arg_or ("type", "nudb"));
+        params.set ("path", args.at ("from"));
+        auto backend = Manager::instance().make_Backend (
+            params, scheduler, j);
+
+        // Reservoir sample of the encoded leaves
+        beast::xor_shift_engine rng;
+        std::vector<Blob> samples;
+        samples.reserve (count);
+        std::size_t seen = 0;
+        EncodedBlob encoded;
+        backend->for_each (
+            [&](std::shared_ptr<NodeObject> object)
+            {
+                if (object->getType () != hotACCOUNT_NODE &&
+                        object->getType () != hotTRANSACTION_NODE)
+                    return;
+                encoded.prepare (object);
+                auto const p = static_cast<std::uint8_t const*>(
+                    encoded.getData ());
+                Blob value (p, p + encoded.getSize ());
+                if (samples.size () < count)
+                    samples.push_back (std::move (value));
+                else
+                {
+                    auto const i = rand_int (rng, seen);
+                    if (i < count)
+                        samples[i] = std::move (value);
+                }
+                ++seen;
+            });
+        backend->close ();
+        log << seen << " leaves, " << samples.size () << " sampled" << std::endl;
+
+        // Hold back every tenth sample to measure the result
+        std::vector<Blob> training;
+        std::vector<Blob> checking;
+        for (std::size_t i = 0; i < samples.size (); ++i)
+            (i % 10 == 9 ? checking : training).push_back (
+                std::move (samples[i]));
+
+        auto const dict = CompressionDictionary::train (
+            static_cast<std::uint8_t>(id), training, size);
+        dict->save (args.at ("to"));
+        {
+            auto const check = CompressionDictionary::load (args.at ("to"));
+            BEAST_EXPECT(check && check->id () == dict->id () &&
+                check->data () == dict->data ());
+        }
+        log << "Wrote " << dict->data ().size () <<
+            " byte dictionary to " << args.at ("to") << std::endl;
+
+        std::size_t rawBytes = 0;
+        std::size_t plainBytes = 0;
+        std::size_t dictBytes = 0;
+        for (auto const& value : checking)
+        {
+            nudb::detail::buffer bf;
+            rawBytes += value.size ();
+            plainBytes += nodeobject_compress (
+                value.data (), value.size (), bf).second;
+            auto const compressed = nodeobject_compress (
+                value.data (), value.size (), bf, dict.get ());
+            dictBytes += compressed.second;
+
+            nudb::detail::buffer check;
+            auto const result = nodeobject_decompress (
+                compressed.first, compressed.second, check, dict.get ());
+            BEAST_EXPECT(makeSlice (value) ==
+                Slice (result.first, result.second));
+        }
+        log <<
+            "Checked " << checking.size () << " leaves: " <<
+            rawBytes << " raw, " <<
+            plainBytes << " lz4, " <<
+            dictBytes << " with dictionary" << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(dictionary,NodeStore,ripple);
+
+}
+}
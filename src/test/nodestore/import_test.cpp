@@ -21,14 +21,12 @@
 #include <ripple/basics/contract.h>
 #include <ripple/nodestore/impl/codec.h>
 #include <ripple/beast/clock/basic_seconds_clock.h>
-#include <ripple/beast/rfc2616.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/beast/unit_test.h>
+#include <test/parse_args.h>
 #include <nudb/create.hpp>
 #include <nudb/detail/format.hpp>
 #include <nudb/xxhasher.hpp>
-#include <beast/core/detail/ci_char_traits.hpp>
-#include <boost/regex.hpp>
 #include <algorithm>
 #include <chrono>
 #include <iomanip>
@@ -258,40 +256,6 @@ public:
     }
 };
 
-std::map <std::string, std::string, beast::detail::ci_less>
-parse_args(std::string const& s)
-{
-    // <key> '=' <value>
-    static boost::regex const re1 (
-        "^"                         // start of line
-        "(?:\\s*)"                  // whitespace (optonal)
-        "([a-zA-Z][_a-zA-Z0-9]*)"   // <key>
-        "(?:\\s*)"                  // whitespace (optional)
-        "(?:=)"                     // '='
-        "(?:\\s*)"                  // whitespace (optional)
-        "(.*\\S+)"                  // <value>
-        "(?:\\s*)"                  // whitespace (optional)
-        , boost::regex_constants::optimize
-    );
-    std::map <std::string,
-        std::string, beast::detail::ci_less> map;
-    auto const v = beast::rfc2616::split(
-        s.begin(), s.end(), ',');
-    for (auto const& kv : v)
-    {
-        boost::smatch m;
-        if (! boost::regex_match (kv, m, re1))
-            Throw<std::runtime_error> (
-                "invalid parameter " + kv);
-        auto const result =
-            map.emplace(m[1], m[2]);
-        if (! result.second)
-            Throw<std::runtime_error> (
-                "duplicate parameter " + m[1]);
-    }
-    return map;
-}
-
 //------------------------------------------------------------------------------
 
 #if RIPPLE_ROCKSDB_AVAILABLE
@@ -308,7 +272,7 @@ public:
         using namespace nudb::detail;
 
         pass();
-        auto const args = parse_args(arg());
+        auto const args = test::parse_args(arg());
         bool usage = args.empty();
 
         if (! usage &&
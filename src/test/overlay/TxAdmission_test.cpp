@@ -0,0 +1,207 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/overlay/impl/TxAdmission.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/beast/unit_test.h>
+
+namespace ripple {
+namespace test {
+
+class TxAdmission_test : public beast::unit_test::suite
+{
+    using Priority = TxAdmission::Priority;
+
+    static
+    Priority
+    priority (std::uint64_t feeLevel, int balance = 0, bool trusted = false)
+    {
+        Priority p;
+        p.trusted = trusted;
+        p.feeLevel = feeLevel;
+        p.balance = balance;
+        return p;
+    }
+
+    // Queue a transaction which records its name when checked
+    static
+    bool
+    insert (TxAdmission& admission, Priority const& p,
+        std::vector<int>& checked, int name)
+    {
+        return admission.insert (p, [&checked, name]{
+            checked.push_back (name); });
+    }
+
+    static
+    void
+    check (std::vector<TxAdmission::Check> const& batch)
+    {
+        for (auto const& c : batch)
+            c();
+    }
+
+    void
+    testOrder ()
+    {
+        testcase ("order");
+
+        TxAdmission admission;
+        std::vector<int> checked;
+
+        // The first transaction starts a job
+        BEAST_EXPECT(insert (admission, priority (10), checked, 1));
+        BEAST_EXPECT(! insert (admission, priority (10), checked, 2));
+        BEAST_EXPECT(! insert (admission, priority (20, 50), checked, 3));
+        BEAST_EXPECT(! insert (admission, priority (20), checked, 4));
+        BEAST_EXPECT(! insert (admission, priority (5, 0, true), checked, 5));
+        BEAST_EXPECT(admission.size() == 5);
+
+        check (admission.takeBatch());
+        BEAST_EXPECT(admission.size() == 0);
+        BEAST_EXPECT((checked == std::vector<int>{5, 4, 3, 1, 2}));
+
+        // Nothing waits, so the job stops
+        BEAST_EXPECT(! admission.finishBatch (
+            checked.size(), std::chrono::milliseconds (1)));
+    }
+
+    void
+    testJobs ()
+    {
+        testcase ("jobs");
+
+        TxAdmission admission;
+        std::vector<int> checked;
+        int const batchSize = TxAdmission::batchSize;
+
+        // Another job starts only when those running have a full batch
+        std::size_t jobs = 0;
+        for (int i = 0; i < 10 * batchSize; ++i)
+            if (insert (admission, priority (i), checked, i))
+                ++jobs;
+        BEAST_EXPECT(jobs == TxAdmission::maxJobs);
+
+        auto batch = admission.takeBatch();
+        BEAST_EXPECT(batch.size() == TxAdmission::batchSize);
+        check (batch);
+        BEAST_EXPECT(checked.front() == 10 * batchSize - 1);
+        BEAST_EXPECT(admission.finishBatch (
+            batch.size(), std::chrono::milliseconds (1)));
+
+        // The jobs drain the queue, stopping one by one
+        while (jobs != 0)
+        {
+            batch = admission.takeBatch();
+            check (batch);
+            if (! admission.finishBatch (
+                    batch.size(), std::chrono::milliseconds (1)))
+                --jobs;
+        }
+        BEAST_EXPECT(admission.size() == 0);
+        BEAST_EXPECT(checked.size() == 10 * TxAdmission::batchSize);
+        BEAST_EXPECT(std::is_sorted (checked.rbegin(), checked.rend()));
+    }
+
+    void
+    testCancel ()
+    {
+        testcase ("cancel");
+
+        TxAdmission admission;
+        std::vector<int> checked;
+        int const batchSize = TxAdmission::batchSize;
+
+        std::size_t jobs = 0;
+        for (int i = 0; i < 10 * batchSize; ++i)
+            if (insert (admission, priority (i), checked, i))
+                ++jobs;
+        BEAST_EXPECT(jobs == TxAdmission::maxJobs);
+        BEAST_EXPECT(! insert (admission, priority (0), checked, -1));
+
+        // Jobs which were never added give their places back
+        for (; jobs != 0; --jobs)
+            admission.cancelJob();
+        BEAST_EXPECT(insert (admission, priority (0), checked, -2));
+    }
+
+    void
+    testCapacity ()
+    {
+        testcase ("capacity");
+
+        TxAdmission admission;
+        std::vector<int> checked;
+        int const batchSize = TxAdmission::batchSize;
+        int const capacity = admission.capacity();
+
+        // When full, a better transaction replaces the worst
+        for (int i = 0; i < capacity; ++i)
+            insert (admission, priority (10), checked, i);
+        BEAST_EXPECT(! insert (admission, priority (10), checked, -1));
+        BEAST_EXPECT(! insert (admission, priority (5), checked, -2));
+        insert (admission, priority (11), checked, -3);
+        BEAST_EXPECT(admission.size() == admission.capacity());
+
+        auto batch = admission.takeBatch();
+        check (batch);
+        BEAST_EXPECT(checked[0] == -3);
+        BEAST_EXPECT(checked[1] == 0);
+
+        // Slow checks shrink the queue, dropping the worst
+        admission.finishBatch (batch.size(), std::chrono::seconds (10));
+        BEAST_EXPECT(admission.capacity() == TxAdmission::minCapacity);
+        BEAST_EXPECT(admission.size() == TxAdmission::minCapacity);
+        batch = admission.takeBatch();
+        check (batch);
+        BEAST_EXPECT(checked[batchSize] == batchSize - 1);
+
+        // Fast checks grow it
+        for (int i = 0; i < 20; ++i)
+            admission.finishBatch (
+                batch.size(), std::chrono::microseconds (100));
+        BEAST_EXPECT(admission.capacity() == TxAdmission::maxCapacity);
+
+        auto const jv = admission.getJson();
+        BEAST_EXPECT(jv[jss::received] == std::to_string (capacity + 3));
+        BEAST_EXPECT(jv[jss::dropped] == std::to_string (
+            capacity - batchSize - TxAdmission::minCapacity + 3));
+        BEAST_EXPECT(jv[jss::checked] == std::to_string (21 * batchSize));
+        BEAST_EXPECT(jv[jss::batches] == "21");
+        BEAST_EXPECT(jv[jss::pending].asUInt() ==
+            TxAdmission::minCapacity - batchSize);
+        BEAST_EXPECT(jv[jss::capacity].asUInt() == TxAdmission::maxCapacity);
+    }
+
+public:
+    void
+    run() override
+    {
+        testOrder ();
+        testJobs ();
+        testCancel ();
+        testCapacity ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TxAdmission,overlay,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_TEST_PARSE_ARGS_H_INCLUDED
+#define RIPPLE_TEST_PARSE_ARGS_H_INCLUDED
+
+#include <ripple/basics/contract.h>
+#include <ripple/beast/rfc2616.h>
+#include <beast/core/detail/ci_char_traits.hpp>
+#include <boost/regex.hpp>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace ripple {
+namespace test {
+
+/** Parse the argument of a manual suite.
+
+    The argument is a comma separated list of <key>=<value> pairs, as in
+    "from=/path/to/db,to=/path/to/other". Keys are case insensitive.
+
+    @throws std::runtime_error on a malformed or repeated pair
+*/
+inline
+std::map <std::string, std::string, beast::detail::ci_less>
+parse_args(std::string const& s)
+{
+    // <key> '=' <value>
+    static boost::regex const re1 (
+        "^"                         // start of line
+        "(?:\\s*)"                  // whitespace (optonal)
+        "([a-zA-Z][_a-zA-Z0-9]*)"   // <key>
+        "(?:\\s*)"                  // whitespace (optional)
+        "(?:=)"                     // '='
+        "(?:\\s*)"                  // whitespace (optional)
+        "(.*\\S+)"                  // <value>
+        "(?:\\s*)"                  // whitespace (optional)
+        , boost::regex_constants::optimize
+    );
+    std::map <std::string,
+        std::string, beast::detail::ci_less> map;
+    auto const v = beast::rfc2616::split(
+        s.begin(), s.end(), ',');
+    for (auto const& kv : v)
+    {
+        boost::smatch m;
+        if (! boost::regex_match (kv, m, re1))
+            Throw<std::runtime_error> (
+                "invalid parameter " + kv);
+        auto const result =
+            map.emplace(m[1], m[2]);
+        if (! result.second)
+            Throw<std::runtime_error> (
+                "duplicate parameter " + m[1]);
+    }
+    return map;
+}
+
+} // test
+} // ripple
+
+#endif
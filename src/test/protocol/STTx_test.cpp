@@ -18,12 +18,16 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <ripple/protocol/HashPrefix.h>
 #include <ripple/protocol/Sign.h>
+#include <ripple/protocol/STArray.h>
 #include <ripple/protocol/STTx.h>
 #include <ripple/protocol/STParsedJSON.h>
 #include <ripple/protocol/types.h>
 #include <ripple/json/to_string.h>
 #include <ripple/beast/unit_test.h>
+#include <chrono>
+#include <iomanip>
 
 namespace ripple {
 
@@ -56,6 +60,16 @@ public:
 
         Serializer rawTxn;
         j.add (rawTxn);
+        BEAST_EXPECT(j.serializedSize () == rawTxn.size ());
+        Serializer signingData;
+        j.addWithoutSigningFields (signingData);
+        BEAST_EXPECT(j.serializedSize (false) == signingData.size ());
+
+        // The streamed hashes match hashing the serialized transaction
+        BEAST_EXPECT(j.getTransactionID () == sha512Half (
+            HashPrefix::transactionID, rawTxn.slice ()));
+        BEAST_EXPECT(j.getSigningHash () == sha512Half (
+            HashPrefix::txSign, signingData.slice ()));
         SerialIter sit (rawTxn.slice());
         STTx copy (sit);
 
@@ -190,7 +204,97 @@ public:
     }
 };
 
+/*  Times serializing and hashing a signed payment with paths and a
+    memo, as done for every transaction ID, signature check and
+    SHAMap item. The argument is the number of iterations, default
+    100000.
+*/
+class STTxBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    void
+    measure (char const* name, std::size_t count, F&& f)
+    {
+        std::size_t sum = 0;
+        auto const start = clock_type::now();
+        for (std::size_t i = 0; i < count; ++i)
+            sum += f();
+        auto const elapsed = clock_type::now() - start;
+        log << std::left << std::setw(16) << name << std::right <<
+            std::setw(10) << std::fixed << std::setprecision(1) <<
+            std::chrono::duration<double, std::nano>(elapsed).count() /
+                count << " ns " << (sum & 1) << std::endl;
+    }
+
+public:
+    void run()
+    {
+        std::size_t count = 100000;
+        if (! arg().empty())
+            count = std::stoul (arg());
+
+        testcase ("serialize and hash");
+
+        auto const keypair = randomKeyPair (KeyType::secp256k1);
+        STTx tx (ttPAYMENT,
+            [&keypair](auto& obj)
+            {
+                obj.setAccountID (sfAccount, calcAccountID(keypair.first));
+                obj.setAccountID (sfDestination, AccountID (1));
+                obj.setFieldAmount (sfAmount,
+                    STAmount (Issue (Currency (2), AccountID (3)), 1000));
+                obj.setFieldAmount (sfSendMax, STAmount (2000));
+                obj.setFieldAmount (sfFee, STAmount (10));
+                obj.setFieldU32 (sfSequence, 7);
+                obj.setFieldU32 (sfLastLedgerSequence, 1000);
+                obj.setFieldVL (sfSigningPubKey, keypair.first.slice());
+
+                STPath path;
+                path.emplace_back (AccountID (4), Currency (2), AccountID (3));
+                path.emplace_back (boost::none, Currency (5), AccountID (6));
+                STPathSet paths;
+                paths.push_back (path);
+                paths.push_back (path);
+                auto field = std::make_unique<STPathSet> (paths);
+                field->setFName (sfPaths);
+                obj.set (std::move (field));
+
+                STObject memo (sfMemo);
+                memo.setFieldVL (sfMemoData, Blob (64, 1));
+                STArray memos (sfMemos);
+                memos.push_back (memo);
+                obj.setFieldArray (sfMemos, memos);
+            });
+        tx.sign (keypair.first, keypair.second);
+
+        log << tx.serializedSize () << " byte transaction" << std::endl;
+        measure ("serialize", count, [&]
+            {
+                return tx.getSerializer ().size ();
+            });
+        measure ("buffered ID", count, [&]
+            {
+                Serializer s (4 + tx.serializedSize ());
+                s.add32 (HashPrefix::transactionID);
+                tx.add (s);
+                return *s.getSHA512Half ().begin ();
+            });
+        measure ("transaction ID", count, [&]
+            {
+                return *tx.getHash (HashPrefix::transactionID).begin ();
+            });
+        measure ("signing hash", count, [&]
+            {
+                return *tx.getSigningHash ().begin ();
+            });
+        pass ();
+    }
+};
+
 BEAST_DEFINE_TESTSUITE(STTx,ripple_app,ripple);
 BEAST_DEFINE_TESTSUITE(InnerObjectFormatsSerializer,ripple_app,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(STTxBench,ripple_app,ripple);
 
 } // ripple
@@ -26,6 +26,7 @@
 #include <boost/optional.hpp>
 #include <boost/utility/in_place_factory.hpp>
 #include <chrono>
+#include <mutex>
 #include <stdexcept>
 #include <thread>
 
@@ -119,6 +120,12 @@ public:
             return Handoff{};
         }
 
+        std::size_t
+        pipelineLimit (Session& session)
+        {
+            return 1;
+        }
+
         void
         onRequest (Session& session)
         {
@@ -299,6 +306,108 @@ public:
         pass();
     }
 
+    // Holds requests until `limit` of them are in progress,
+    // then answers them with their URLs in reverse order.
+    struct PipelineHandler : TestHandler
+    {
+        std::size_t limit;
+        std::mutex mutex;
+        std::vector<std::shared_ptr<Session>> sessions;
+
+        explicit
+        PipelineHandler (std::size_t limit_)
+            : limit (limit_)
+        {
+        }
+
+        std::size_t
+        pipelineLimit (Session& session)
+        {
+            return limit;
+        }
+
+        void
+        onRequest (Session& session)
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            sessions.push_back (session.detach());
+            if (sessions.size() < limit)
+                return;
+            for (auto iter = sessions.rbegin();
+                iter != sessions.rend(); ++iter)
+            {
+                auto const& s = *iter;
+                s->write (s->request().url + "\n");
+                if (is_keep_alive(s->request()))
+                    s->complete();
+                else
+                    s->close (true);
+            }
+            sessions.clear();
+        }
+    };
+
+    void
+    test_pipelining()
+    {
+        boost::asio::io_service ios;
+        using socket = boost::asio::ip::tcp::socket;
+        socket s (ios);
+
+        if (! connect (s, "127.0.0.1", testPort))
+            return;
+
+        // All three are sent before any response is read
+        if (! write (s,
+            "GET /1 HTTP/1.1\r\n"
+            "Connection: Keep-Alive\r\n"
+            "\r\n"
+            "GET /2 HTTP/1.1\r\n"
+            "Connection: Keep-Alive\r\n"
+            "\r\n"
+            "GET /3 HTTP/1.1\r\n"
+            "Connection: close\r\n"
+            "\r\n"))
+            return;
+
+        std::string got;
+        boost::system::error_code ec;
+        for (;;)
+        {
+            char buf[64];
+            auto const n = s.read_some (boost::asio::buffer (buf), ec);
+            if (ec)
+                break;
+            got.append (buf, n);
+        }
+        BEAST_EXPECT(ec == boost::asio::error::eof);
+        BEAST_EXPECT(got == "/1\n/2\n/3\n");
+
+        s.shutdown(socket::shutdown_both, ec);
+    }
+
+    void pipelineTests()
+    {
+        TestSink sink {*this};
+        TestThread thread;
+        beast::Journal journal {sink};
+        PipelineHandler handler (3);
+        auto s = make_Server (handler,
+            thread.get_io_service(), journal);
+        std::vector<Port> list;
+        list.resize(1);
+        list.back().port = testPort;
+        list.back().ip = boost::asio::ip::address::from_string (
+            "127.0.0.1");
+        list.back().protocol.insert("http");
+        s->ports (list);
+
+        test_pipelining();
+        s = nullptr;
+
+        pass();
+    }
+
     void stressTest()
     {
         struct NullHandler
@@ -327,6 +436,12 @@ public:
                 return Handoff{};
             }
 
+            std::size_t
+            pipelineLimit (Session& session)
+            {
+                return 1;
+            }
+
             void
             onRequest (Session& session)
             {
@@ -370,6 +485,7 @@ public:
     run()
     {
         basicTests();
+        pipelineTests();
         stressTest();
     }
 };
@@ -24,6 +24,10 @@
 #include <ripple/basics/random.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/beast/unit_test.h>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <thread>
 
 namespace ripple {
 namespace tests {
@@ -82,16 +86,37 @@ public:
         return true;
     }
 
+    // Store the nodes of a map, as if it had been acquired before
+    static void storeNodes (SHAMap const& map, Family& f)
+    {
+        // The hashes of the nodes are computed on demand
+        map.getHash ();
+        map.visitNodes(
+            [&f](SHAMapAbstractNode& node)
+            {
+                Serializer s;
+                node.addRaw (s, snfPREFIX);
+                f.db().store (hotUNKNOWN, std::move (s.modData ()),
+                    node.getNodeHash ().as_uint256 ());
+                return false;
+            });
+    }
+
     void run()
     {
         log << "Run, version 1\n" << std::endl;
-        run(SHAMap::version{1});
+        run(SHAMap::version{1}, 1);
+        run(SHAMap::version{1}, 4);
 
         log << "Run, version 2\n" << std::endl;
-        run(SHAMap::version{2});
+        run(SHAMap::version{2}, 1);
+        run(SHAMap::version{2}, 4);
+
+        testLocal (SHAMap::version{1});
+        testLocal (SHAMap::version{2});
     }
 
-    void run(SHAMap::version v)
+    void run(SHAMap::version v, std::size_t threads)
     {
         beast::Journal const j; // debug journal
         TestFamily f(j), f2(j);
@@ -157,7 +182,8 @@ public:
             f.clock().advance(std::chrono::seconds(1));
 
             // get the list of nodes we know we need
-            auto nodesMissing = destination.getMissingNodes (2048, nullptr);
+            auto nodesMissing = destination.getMissingNodes (
+                2048, nullptr, threads);
 
             if (nodesMissing.empty ())
                 break;
@@ -181,11 +207,25 @@ public:
 
             for (std::size_t i = 0; i < gotNodeIDs_b.size(); ++i)
             {
-                BEAST_EXPECT(
-                    destination.addKnownNode (
-                        gotNodeIDs_b[i],
-                        makeSlice(gotNodes_b[i]),
-                        nullptr).isUseful ());
+                if (threads > 1)
+                {
+                    auto node = SHAMap::makeKnownNode (
+                        gotNodeIDs_b[i], makeSlice(gotNodes_b[i]), j);
+                    BEAST_EXPECT(node);
+                    BEAST_EXPECT(
+                        destination.addKnownNode (
+                            gotNodeIDs_b[i],
+                            std::move(node),
+                            nullptr).isUseful ());
+                }
+                else
+                {
+                    BEAST_EXPECT(
+                        destination.addKnownNode (
+                            gotNodeIDs_b[i],
+                            makeSlice(gotNodes_b[i]),
+                            nullptr).isUseful ());
+                }
             }
         }
         while (true);
@@ -196,10 +236,189 @@ public:
 
         log << "Checking destination invariants..." << std::endl;
         destination.invariants();
+
+        // A node which can not be parsed is not added
+        Blob bad (12, 0xff);
+        BEAST_EXPECT(! SHAMap::makeKnownNode (
+            SHAMapNodeID (1, uint256 ()), makeSlice (bad), j));
+    }
+
+    // Every node is already in the node store, and is found on
+    // several threads at once
+    void testLocal (SHAMap::version v)
+    {
+        beast::Journal const j;
+        TestFamily f(j), f2(j);
+        SHAMap source (SHAMapType::FREE, f, v);
+
+        for (int i = 0; i < 5000; ++i)
+            source.addItem (std::move(*makeRandomAS ()), false, false);
+        source.setImmutable ();
+        storeNodes (source, f2);
+
+        SHAMap destination (SHAMapType::FREE, f2, v);
+        destination.setSynching ();
+
+        Serializer root;
+        source.getHash ();
+        BEAST_EXPECT(source.getRootNode (root, snfWIRE));
+        BEAST_EXPECT(destination.addRootNode (source.getHash (),
+            root.slice (), snfWIRE, nullptr).isGood ());
+
+        auto const missing = destination.getMissingNodes (16, nullptr, 4);
+        BEAST_EXPECT(missing.empty ());
+        BEAST_EXPECT(! destination.isSynching ());
+        BEAST_EXPECT(source.deepCompare (destination));
+
+        // The map is now known to be complete
+        destination.setSynching ();
+        BEAST_EXPECT(destination.getMissingNodes (16, nullptr, 4).empty ());
+    }
+};
+
+/*  Times the acquisition of a state map, with missing nodes found on
+    one thread and on several.
+
+    From peers: nodes are asked for, then parsed and added, until the
+    map is complete. From the node store: every node was stored
+    before, as after a restart, and the map is walked once. The
+    argument is the number of items, default 100000.
+*/
+class sync_manual_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static
+    double
+    millis (clock_type::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    void
+    fromPeers (SHAMap const& source, std::size_t threads)
+    {
+        beast::Journal const j;
+        TestFamily f(j);
+        SHAMap destination (SHAMapType::STATE, f, source.get_version ());
+        destination.setSynching ();
+
+        Serializer root;
+        source.getRootNode (root, snfWIRE);
+        destination.addRootNode (source.getHash (),
+            root.slice (), snfWIRE, nullptr);
+
+        clock_type::duration find {}, check {}, add {};
+        std::size_t rounds = 0, nodes = 0;
+        for (;;)
+        {
+            auto start = clock_type::now();
+            auto const missing = destination.getMissingNodes (
+                256, nullptr, threads);
+            find += clock_type::now() - start;
+            if (missing.empty ())
+                break;
+            ++rounds;
+
+            std::vector<SHAMapNodeID> ids;
+            std::vector<Blob> raw;
+            for (auto const& m : missing)
+                source.getNodeFat (m.first, ids, raw, false, 1);
+
+            // Check the reply as if it came from several peers
+            start = clock_type::now();
+            std::vector<std::shared_ptr<SHAMapAbstractNode>> checked (
+                ids.size ());
+            auto const work = [&](std::size_t first)
+            {
+                for (auto i = first; i < ids.size (); i += threads)
+                    checked[i] = SHAMap::makeKnownNode (
+                        ids[i], makeSlice (raw[i]), j);
+            };
+            std::vector<std::thread> workers;
+            for (std::size_t i = 1; i < threads; ++i)
+                workers.emplace_back (work, i);
+            work (0);
+            for (auto& w : workers)
+                w.join ();
+            check += clock_type::now() - start;
+
+            start = clock_type::now();
+            for (std::size_t i = 0; i < ids.size (); ++i)
+                destination.addKnownNode (ids[i], checked[i], nullptr);
+            add += clock_type::now() - start;
+            nodes += ids.size ();
+        }
+        BEAST_EXPECT(source.deepCompare (destination));
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) <<
+            "From peers, " << threads << " thread(s): " <<
+            nodes << " nodes in " << rounds << " rounds, " <<
+            "find " << millis (find) << "ms, " <<
+            "check " << millis (check) << "ms, " <<
+            "add " << millis (add) << "ms";
+        log << ss.str() << std::endl;
+    }
+
+    void
+    fromStore (SHAMap const& source, std::size_t threads)
+    {
+        beast::Journal const j;
+        TestFamily f(j);
+        sync_test::storeNodes (source, f);
+
+        SHAMap destination (SHAMapType::STATE, f, source.get_version ());
+        destination.setSynching ();
+
+        Serializer root;
+        source.getRootNode (root, snfWIRE);
+        destination.addRootNode (source.getHash (),
+            root.slice (), snfWIRE, nullptr);
+
+        auto const start = clock_type::now();
+        BEAST_EXPECT(destination.getMissingNodes (
+            256, nullptr, threads).empty ());
+        auto const elapsed = clock_type::now() - start;
+        BEAST_EXPECT(source.deepCompare (destination));
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) <<
+            "From the node store, " << threads << " thread(s): " <<
+            millis (elapsed) << "ms";
+        log << ss.str() << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t count = 100000;
+        if (! arg().empty())
+            count = std::stoul (arg());
+
+        testcase (std::to_string (count) + " items");
+
+        beast::Journal const j;
+        TestFamily f(j);
+        SHAMap source (SHAMapType::STATE, f, SHAMap::version{1});
+        for (std::size_t i = 0; i < count; ++i)
+            source.addItem (std::move(*sync_test::makeRandomAS ()),
+                false, false);
+        source.getHash ();
+        source.setImmutable ();
+
+        // The node store of every TestFamily is shared, so the map
+        // is acquired from peers before it is stored
+        for (std::size_t threads : {1, 4})
+            fromPeers (source, threads);
+        for (std::size_t threads : {1, 4})
+            fromStore (source, threads);
     }
 };
 
 BEAST_DEFINE_TESTSUITE(sync,shamap,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(sync_manual,shamap,ripple);
 
 } // tests
 } // ripple
@@ -18,6 +18,7 @@
 */
 //==============================================================================
 
+#include <test/app/AccountTxIndex_test.cpp>
 #include <test/app/AccountTxPaging_test.cpp>
 #include <test/app/AmendmentTable_test.cpp>
 #include <test/app/CrossingLimits_test.cpp>
@@ -27,16 +28,19 @@
 #include <test/app/Freeze_test.cpp>
 #include <test/app/HashRouter_test.cpp>
 #include <test/app/LedgerLoad_test.cpp>
+#include <test/app/LedgerReplay_test.cpp>
 #include <test/app/LoadFeeTrack_test.cpp>
 #include <test/app/Manifest_test.cpp>
 #include <test/app/MultiSign_test.cpp>
 #include <test/app/OfferStream_test.cpp>
+#include <test/app/OpenLedger_test.cpp>
 #include <test/app/Offer_test.cpp>
 #include <test/app/OversizeMeta_test.cpp>
 #include <test/app/Path_test.cpp>
 #include <test/app/PayChan_test.cpp>
 #include <test/app/PayStrand_test.cpp>
 #include <test/app/Regression_test.cpp>
+#include <test/app/RippleLineCache_test.cpp>
 #include <test/app/SetAuth_test.cpp>
 #include <test/app/SetRegularKey_test.cpp>
 #include <test/app/SHAMapStore_test.cpp>
@@ -45,6 +49,7 @@
 #include <test/app/Transaction_ordering_test.cpp>
 #include <test/app/TrustAndBalance_test.cpp>
 #include <test/app/TxQ_test.cpp>
+#include <test/app/ValidationsWrite_test.cpp>
 #include <test/app/ValidatorList_test.cpp>
 #include <test/app/ValidatorSite_test.cpp>
 #include <test/app/SetTrust_test.cpp>
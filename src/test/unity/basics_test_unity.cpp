@@ -27,5 +27,6 @@
 #include <test/basics/mulDiv_test.cpp>
 #include <test/basics/RangeSet_test.cpp>
 #include <test/basics/Slice_test.cpp>
+#include <test/basics/StrandWorkers_test.cpp>
 #include <test/basics/StringUtilities_test.cpp>
 #include <test/basics/TaggedCache_test.cpp>
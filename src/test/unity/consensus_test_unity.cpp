@@ -18,4 +18,5 @@
 //==============================================================================
 
 #include <test/consensus/Consensus_test.cpp>
+#include <test/consensus/ConsensusScale_test.cpp>
 #include <test/consensus/LedgerTiming_test.cpp>
@@ -19,10 +19,14 @@
 //==============================================================================
 
 #include <test/ledger/BookDirs_test.cpp>
+#include <test/ledger/BookIndex_test.cpp>
 #include <test/ledger/CashDiff_test.cpp>
 #include <test/ledger/Directory_test.cpp>
+#include <test/ledger/FetchPack_test.cpp>
 #include <test/ledger/Invariants_test.cpp>
+#include <test/ledger/LedgerSnapshot_test.cpp>
 #include <test/ledger/PaymentSandbox_test.cpp>
+#include <test/ledger/RecentLedgers_test.cpp>
 #include <test/ledger/PendingSaves_test.cpp>
 #include <test/ledger/SHAMapV2_test.cpp>
 #include <test/ledger/SkipList_test.cpp>
@@ -20,4 +20,5 @@
 
 #include <test/overlay/cluster_test.cpp>
 #include <test/overlay/short_read_test.cpp>
-#include <test/overlay/TMHello_test.cpp>
\ No newline at end of file
+#include <test/overlay/TMHello_test.cpp>
+#include <test/overlay/TxAdmission_test.cpp>